@@ -1,4 +1,5 @@
 find_package(ZLIB REQUIRED)
+target_compile_definitions(lammps PRIVATE -DLAMMPS_ZLIB)
 target_link_libraries(lammps PRIVATE ZLIB::ZLIB)
 
 find_package(PkgConfig REQUIRED)
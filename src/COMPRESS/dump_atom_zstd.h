@@ -42,7 +42,7 @@ class DumpAtomZstd : public DumpAtom {
   virtual void openfile();
   virtual void write_header(bigint);
   virtual void write_data(int, double *);
-  virtual void write();
+  virtual void closefile();
 
   virtual int modify_param(int, char **);
 };
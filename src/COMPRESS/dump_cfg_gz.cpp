@@ -163,7 +163,7 @@ void DumpCFGGZ::write_data(int n, double *mybuf)
           if (written > 0) {
             writer.write(vbuffer, written);
           } else if (written < 0) {
-            error->one(FLERR, "Error while writing dump cfg/gz output");
+            write_error(FLERR, "Error while writing dump cfg/gz output");
           }
           m++;
         }
@@ -194,7 +194,7 @@ void DumpCFGGZ::write_data(int n, double *mybuf)
           if (written > 0) {
             writer.write(vbuffer, written);
           } else if (written < 0) {
-            error->one(FLERR, "Error while writing dump cfg/gz output");
+            write_error(FLERR, "Error while writing dump cfg/gz output");
           }
           m++;
         }
@@ -206,9 +206,8 @@ void DumpCFGGZ::write_data(int n, double *mybuf)
 
 /* ---------------------------------------------------------------------- */
 
-void DumpCFGGZ::write()
+void DumpCFGGZ::closefile()
 {
-  DumpCFG::write();
   if (filewriter) {
     if (multifile) {
       writer.close();
@@ -232,6 +231,11 @@ int DumpCFGGZ::modify_param(int narg, char **arg)
         int compression_level = utils::inumeric(FLERR, arg[1], false, lmp);
         writer.setCompressionLevel(compression_level);
         return 2;
+      } else if (strcmp(arg[0],"compression_threads") == 0) {
+        if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+        int nthreads = utils::inumeric(FLERR, arg[1], false, lmp);
+        writer.setThreads(nthreads);
+        return 2;
       }
     } catch (FileWriterException &e) {
       error->one(FLERR,"Illegal dump_modify command: {}", e.what());
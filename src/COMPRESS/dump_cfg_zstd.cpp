@@ -175,7 +175,7 @@ void DumpCFGZstd::write_data(int n, double *mybuf)
           if (written > 0) {
             writer.write(vbuffer, written);
           } else if (written < 0) {
-            error->one(FLERR, "Error while writing dump cfg/gz output");
+            write_error(FLERR, "Error while writing dump cfg/gz output");
           }
           m++;
         }
@@ -206,7 +206,7 @@ void DumpCFGZstd::write_data(int n, double *mybuf)
           if (written > 0) {
             writer.write(vbuffer, written);
           } else if (written < 0) {
-            error->one(FLERR, "Error while writing dump cfg/gz output");
+            write_error(FLERR, "Error while writing dump cfg/gz output");
           }
           m++;
         }
@@ -218,9 +218,8 @@ void DumpCFGZstd::write_data(int n, double *mybuf)
 
 /* ---------------------------------------------------------------------- */
 
-void DumpCFGZstd::write()
+void DumpCFGZstd::closefile()
 {
-  DumpCFG::write();
   if (filewriter) {
     if (multifile) {
       writer.close();
@@ -250,6 +249,11 @@ int DumpCFGZstd::modify_param(int narg, char **arg)
         int compression_level = utils::inumeric(FLERR, arg[1], false, lmp);
         writer.setCompressionLevel(compression_level);
         return 2;
+      } else if (strcmp(arg[0],"compression_threads") == 0) {
+        if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+        int nthreads = utils::inumeric(FLERR, arg[1], false, lmp);
+        writer.setThreads(nthreads);
+        return 2;
       }
     } catch (FileWriterException &e) {
       error->one(FLERR, e.what());
@@ -36,7 +36,7 @@ class DumpCustomGZ : public DumpCustom {
   virtual void openfile();
   virtual void write_header(bigint);
   virtual void write_data(int, double *);
-  virtual void write();
+  virtual void closefile();
 
   virtual int modify_param(int, char **);
 };
@@ -0,0 +1,399 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://lammps.sandia.gov/, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "dump_custom_quant.h"
+
+#include "domain.h"
+#include "error.h"
+#include "memory.h"
+#include "update.h"
+
+#include <cmath>
+#include <cstring>
+
+using namespace LAMMPS_NS;
+
+enum{ASCEND,DESCEND};
+
+// largest quantized value, so differences of two values fit in int64_t
+
+#define MAXQUANT 4.0e18
+
+constexpr const char *DumpCustomQuant::MAGIC;
+constexpr int DumpCustomQuant::REVISION;
+
+/* ----------------------------------------------------------------------
+   append raw bytes of value to string
+------------------------------------------------------------------------- */
+
+template <typename T> static void append(std::string &s, const T &value)
+{
+  s.append((const char *) &value, sizeof(T));
+}
+
+/* ---------------------------------------------------------------------- */
+
+DumpCustomQuant::DumpCustomQuant(LAMMPS *lmp, int narg, char **arg) :
+  DumpCustom(lmp, narg, arg), step(nullptr), fbuf(nullptr), qcur(nullptr),
+  qprev(nullptr), match(nullptr)
+{
+  if (!compressed || !utils::strmatch(filename,"\\.gz$"))
+    error->all(FLERR,"Dump custom/quant only writes compressed files");
+
+  // values are encoded from the packed buffer, never as strings
+  // rows are sorted by atom ID, so each atom can be matched to its
+  //   row in the previous frame
+
+  buffer_allow = 0;
+  buffer_flag = 0;
+  sort_flag = 1;
+  sortcol = 0;
+  sortorder = ASCEND;
+
+  idcol = -1;
+  for (int i = 0; i < nfield; i++)
+    if (pack_choice[i] == &DumpCustomQuant::pack_id) idcol = i;
+  if (idcol < 0) error->all(FLERR,"Dump custom/quant requires an id field");
+
+  step = new double[nfield];
+  for (int i = 0; i < nfield; i++) step[i] = 0.0;
+  keyframe_every = 0;
+  nframe = 0;
+
+  nexpect = nrows = maxrows = 0;
+  nprev = -1;
+}
+
+/* ---------------------------------------------------------------------- */
+
+DumpCustomQuant::~DumpCustomQuant()
+{
+  delete [] step;
+  memory->destroy(fbuf);
+  memory->destroy(qcur);
+  memory->destroy(qprev);
+  memory->destroy(match);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void DumpCustomQuant::init_style()
+{
+  DumpCustom::init_style();
+
+  if (!sort_flag || sortcol != 0 || sortorder != ASCEND)
+    error->all(FLERR,"Dump custom/quant requires sorting by atom ID");
+}
+
+/* ----------------------------------------------------------------------
+   open a new file, each file starts without a previous frame
+------------------------------------------------------------------------- */
+
+void DumpCustomQuant::openfile()
+{
+  // single file, already opened, so just return
+
+  if (singlefile_opened) return;
+  if (multifile == 0) singlefile_opened = 1;
+
+  // if one file per timestep, replace '*' with current timestep
+
+  char *filecurrent = filename;
+  if (multiproc) filecurrent = multiname;
+
+  if (multifile) {
+    char *filestar = filecurrent;
+    filecurrent = new char[strlen(filestar) + 16];
+    char *ptr = strchr(filestar,'*');
+    *ptr = '\0';
+    if (padflag == 0)
+      sprintf(filecurrent,"%s" BIGINT_FORMAT "%s",
+              filestar,update->ntimestep,ptr+1);
+    else {
+      char bif[8],pad[16];
+      strcpy(bif,BIGINT_FORMAT);
+      sprintf(pad,"%%s%%0%d%s%%s",padflag,&bif[1]);
+      sprintf(filecurrent,pad,filestar,update->ntimestep,ptr+1);
+    }
+    *ptr = '*';
+    if (maxfiles > 0) {
+      if (numfiles < maxfiles) {
+        nameslist[numfiles] = utils::strdup(filecurrent);
+        ++numfiles;
+      } else {
+        if (remove(nameslist[fileidx]) != 0) {
+          error->warning(FLERR, "Could not delete {}", nameslist[fileidx]);
+        }
+        delete[] nameslist[fileidx];
+        nameslist[fileidx] = utils::strdup(filecurrent);
+        fileidx = (fileidx + 1) % maxfiles;
+      }
+    }
+  }
+
+  // each proc with filewriter = 1 opens a file
+
+  if (filewriter) {
+    try {
+      writer.open(filecurrent, append_flag);
+    } catch (FileWriterException &e) {
+      error->one(FLERR, e.what());
+    }
+    nprev = -1;
+    nframe = 0;
+  }
+
+  // delete string with timestep replaced
+
+  if (multifile) delete [] filecurrent;
+}
+
+/* ----------------------------------------------------------------------
+   start a new frame of ndump rows
+   header is assembled here, since it uses the current timestep and box
+------------------------------------------------------------------------- */
+
+void DumpCustomQuant::write_header(bigint ndump)
+{
+  if (!multiproc && me != 0) return;
+
+  header.assign(MAGIC,strlen(MAGIC));
+  append(header,REVISION);
+  append(header,update->ntimestep);
+  append(header,ndump);
+  append(header,domain->triclinic);
+  double box[9] = {boxxlo,boxxhi,boxylo,boxyhi,boxzlo,boxzhi,
+                   boxxy,boxxz,boxyz};
+  header.append((const char *) box,sizeof(box));
+  int len = strlen(boundstr);
+  append(header,len);
+  header.append(boundstr,len);
+
+  auto words = utils::split_words(columns);
+  append(header,nfield);
+  for (int i = 0; i < nfield; i++) {
+    len = words[i].size();
+    append(header,len);
+    header.append(words[i]);
+    int isdouble = (vtype[i] == Dump::DOUBLE);
+    append(header,isdouble);
+    append(header,step[i]);
+  }
+  append(header,idcol);
+
+  nexpect = ndump;
+  nrows = 0;
+  grow_rows(nexpect);
+  if (nexpect == 0) write_frame();
+}
+
+/* ----------------------------------------------------------------------
+   collect rows from each proc, encode frame once all have arrived
+------------------------------------------------------------------------- */
+
+void DumpCustomQuant::write_data(int n, double *mybuf)
+{
+  if (n == 0) return;
+  memcpy(&fbuf[nrows*size_one],mybuf,sizeof(double)*n*size_one);
+  nrows += n;
+  if (nrows == nexpect) write_frame();
+}
+
+/* ----------------------------------------------------------------------
+   quantize and write the complete frame
+   a frame that is not a keyframe stores each value as the difference
+     to the same atom in the previous frame
+------------------------------------------------------------------------- */
+
+void DumpCustomQuant::write_frame()
+{
+  bigint i;
+  int j;
+
+  // quantized values, stored column by column
+  // exact floating point values keep their bit pattern
+
+  for (j = 0; j < nfield; j++) {
+    int64_t *q = &qcur[j*nrows];
+    if (vtype[j] == Dump::DOUBLE && step[j] == 0.0) {
+      for (i = 0; i < nrows; i++) memcpy(&q[i],&fbuf[i*size_one+j],sizeof(double));
+    } else if (vtype[j] == Dump::DOUBLE) {
+      double invstep = 1.0/step[j];
+      for (i = 0; i < nrows; i++) {
+        double value = fbuf[i*size_one+j]*invstep;
+        if (!(fabs(value) < MAXQUANT))
+          write_error(FLERR,"Dump custom/quant value is too large for quantization step");
+        q[i] = llround(value);
+      }
+    } else {
+      for (i = 0; i < nrows; i++) q[i] = static_cast<int64_t> (fbuf[i*size_one+j]);
+    }
+  }
+
+  // match each atom to its row in the previous frame
+  // both frames are sorted by atom ID
+
+  int keyframe = (nprev < 0 || (keyframe_every && nframe % keyframe_every == 0));
+
+  if (!keyframe) {
+    const int64_t *id = &qcur[idcol*nrows];
+    const int64_t *idprev = &qprev[idcol*nprev];
+    bigint k = 0;
+    for (i = 0; i < nrows; i++) {
+      while (k < nprev && idprev[k] < id[i]) k++;
+      match[i] = (k < nprev && idprev[k] == id[i]) ? k : -1;
+    }
+  }
+
+  std::string frame(header);
+  append(frame,keyframe);
+  std::string column;
+  for (j = 0; j < nfield; j++) {
+    encode_column(j,keyframe,column);
+    bigint nbytes = column.size();
+    append(frame,nbytes);
+    frame.append(column);
+  }
+
+  try {
+    writer.write(frame.data(),frame.size());
+  } catch (FileWriterException &e) {
+    write_error(FLERR,e.what());
+  }
+
+  int64_t *tmp = qprev;
+  qprev = qcur;
+  qcur = tmp;
+  nprev = nrows;
+  nframe++;
+}
+
+/* ----------------------------------------------------------------------
+   encode column j of the current frame into out
+   residual = value minus prediction, the previous row for the id column,
+     else the same atom in the previous frame, or 0 if there is none
+   residuals are zigzag mapped to unsigned and written as varints,
+     7 bits per byte, low bits first, high bit set if more bytes follow
+   exact floating point values use the XOR of the bit patterns instead
+------------------------------------------------------------------------- */
+
+void DumpCustomQuant::encode_column(int j, int keyframe, std::string &out)
+{
+  const int64_t *q = &qcur[j*nrows];
+  const int64_t *p = keyframe ? nullptr : &qprev[j*nprev];
+  const int exact = (vtype[j] == Dump::DOUBLE && step[j] == 0.0);
+
+  out.clear();
+  for (bigint i = 0; i < nrows; i++) {
+    int64_t pred = 0;
+    if (j == idcol) {
+      if (i) pred = q[i-1];
+    } else if (!keyframe && match[i] >= 0) pred = p[match[i]];
+
+    uint64_t u;
+    if (exact) u = (uint64_t) q[i] ^ (uint64_t) pred;
+    else {
+      int64_t r = (int64_t) ((uint64_t) q[i] - (uint64_t) pred);
+      u = ((uint64_t) r << 1) ^ (uint64_t) (r >> 63);
+    }
+    while (u >= 0x80) {
+      out += (char) ((u & 0x7f) | 0x80);
+      u >>= 7;
+    }
+    out += (char) u;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   insure per-row arrays can hold n rows, qprev keeps its content
+------------------------------------------------------------------------- */
+
+void DumpCustomQuant::grow_rows(bigint n)
+{
+  if (n <= maxrows) return;
+  maxrows = n;
+  memory->destroy(fbuf);
+  memory->create(fbuf,maxrows*size_one,"dump:fbuf");
+  memory->destroy(qcur);
+  memory->create(qcur,maxrows*nfield,"dump:qcur");
+  memory->grow(qprev,maxrows*nfield,"dump:qprev");
+  memory->destroy(match);
+  memory->create(match,maxrows,"dump:match");
+}
+
+/* ---------------------------------------------------------------------- */
+
+void DumpCustomQuant::closefile()
+{
+  if (filewriter) {
+    if (multifile) {
+      writer.close();
+    } else {
+      if (flush_flag && writer.isopen()) {
+        writer.flush();
+      }
+    }
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
+int DumpCustomQuant::modify_param(int narg, char **arg)
+{
+  int consumed = DumpCustom::modify_param(narg, arg);
+  if (consumed) return consumed;
+
+  if (strcmp(arg[0],"quantize") == 0) {
+    if (narg < 3) error->all(FLERR,"Illegal dump_modify command");
+    double value = utils::numeric(FLERR,arg[2],false,lmp);
+    if (value < 0.0) error->all(FLERR,"Illegal dump_modify command");
+    if (strcmp(arg[1],"*") == 0) {
+      for (int i = 0; i < nfield; i++)
+        if (vtype[i] == Dump::DOUBLE) step[i] = value;
+    } else {
+      int i;
+      for (i = 0; i < nfield; i++)
+        if (strcmp(arg[1],earg[i]) == 0) break;
+      if (i == nfield)
+        error->all(FLERR,"Dump_modify quantize field {} does not exist",arg[1]);
+      if (vtype[i] != Dump::DOUBLE)
+        error->all(FLERR,"Dump_modify quantize field {} is not a floating "
+                   "point field",arg[1]);
+      step[i] = value;
+    }
+    return 3;
+
+  } else if (strcmp(arg[0],"keyframe") == 0) {
+    if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+    keyframe_every = utils::inumeric(FLERR,arg[1],false,lmp);
+    if (keyframe_every < 0) error->all(FLERR,"Illegal dump_modify command");
+    return 2;
+  }
+
+  try {
+    if (strcmp(arg[0],"compression_level") == 0) {
+      if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+      int compression_level = utils::inumeric(FLERR, arg[1], false, lmp);
+      writer.setCompressionLevel(compression_level);
+      return 2;
+    } else if (strcmp(arg[0],"compression_threads") == 0) {
+      if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+      int nthreads = utils::inumeric(FLERR, arg[1], false, lmp);
+      writer.setThreads(nthreads);
+      return 2;
+    }
+  } catch (FileWriterException &e) {
+    error->one(FLERR,"Illegal dump_modify command: {}", e.what());
+  }
+  return 0;
+}
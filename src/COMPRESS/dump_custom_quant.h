@@ -0,0 +1,106 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://lammps.sandia.gov/, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef DUMP_CLASS
+
+DumpStyle(custom/quant,DumpCustomQuant)
+
+#else
+
+#ifndef LMP_DUMP_CUSTOM_QUANT_H
+#define LMP_DUMP_CUSTOM_QUANT_H
+
+#include "dump_custom.h"
+#include "gz_file_writer.h"
+
+#include <string>
+
+namespace LAMMPS_NS {
+
+class DumpCustomQuant : public DumpCustom {
+ public:
+  DumpCustomQuant(class LAMMPS *, int, char **);
+  virtual ~DumpCustomQuant();
+
+  static constexpr const char *MAGIC = "LMPQUANT";
+  static constexpr int REVISION = 1;
+
+ protected:
+  GzFileWriter writer;
+
+  int idcol;                 // index of the id field
+  double *step;              // quantization step of each field, 0 = exact
+  int keyframe_every;        // every Nth frame is not delta coded, 0 = never
+  int nframe;                // # of frames written to current file
+
+  bigint nexpect;            // # of rows in the current frame
+  bigint nrows;              // # of rows received so far
+  bigint maxrows;            // allocated rows of fbuf, qcur, qprev
+  double *fbuf;              // rows of the current frame
+  int64_t *qcur;             // quantized columns of the current frame
+  int64_t *qprev;            // same for the previous frame
+  bigint nprev;              // # of rows in qprev, -1 if none
+  bigint *match;             // row in qprev with the same atom ID, or -1
+
+  std::string header;        // header of the current frame
+
+  virtual void init_style();
+  virtual void openfile();
+  virtual void write_header(bigint);
+  virtual void write_data(int, double *);
+  virtual void closefile();
+  virtual int modify_param(int, char **);
+
+  void grow_rows(bigint);
+  void write_frame();
+  void encode_column(int, int, std::string &);
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Dump custom/quant only writes compressed files
+
+The dump custom/quant output file name must have a .gz suffix.
+
+E: Dump custom/quant requires an id field
+
+Atom IDs are needed to delta code each atom against the previous frame.
+
+E: Dump custom/quant requires sorting by atom ID
+
+The dump sorts its output by atom ID by default.  It must not be
+changed with the dump_modify sort keyword.
+
+E: Dump custom/quant value is too large for quantization step
+
+A value divided by its quantization step does not fit into a 64-bit
+integer.  Use a larger step for this field.
+
+E: Dump_modify quantize field %s is not a floating point field
+
+Integer fields are always stored exactly.
+
+E: Dump_modify quantize field %s does not exist
+
+The field name must match one of the fields of the dump command.
+
+E: Cannot open dump file
+
+Self-explanatory.
+
+*/
@@ -168,7 +168,7 @@ void DumpCustomZstd::write_data(int n, double *mybuf)
         if (written > 0) {
           writer.write(vbuffer, written);
         } else if (written < 0) {
-          error->one(FLERR, "Error while writing dump custom/gz output");
+          write_error(FLERR, "Error while writing dump custom/gz output");
         }
         m++;
       }
@@ -179,9 +179,8 @@ void DumpCustomZstd::write_data(int n, double *mybuf)
 
 /* ---------------------------------------------------------------------- */
 
-void DumpCustomZstd::write()
+void DumpCustomZstd::closefile()
 {
-  DumpCustom::write();
   if (filewriter) {
     if (multifile) {
       writer.close();
@@ -211,6 +210,11 @@ int DumpCustomZstd::modify_param(int narg, char **arg)
         int compression_level = utils::inumeric(FLERR, arg[1], false, lmp);
         writer.setCompressionLevel(compression_level);
         return 2;
+      } else if (strcmp(arg[0],"compression_threads") == 0) {
+        if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+        int nthreads = utils::inumeric(FLERR, arg[1], false, lmp);
+        writer.setThreads(nthreads);
+        return 2;
       }
     } catch (FileWriterException &e) {
       error->one(FLERR,"Illegal dump_modify command: {}", e.what());
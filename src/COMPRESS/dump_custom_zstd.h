@@ -43,7 +43,7 @@ class DumpCustomZstd : public DumpCustom {
   virtual void openfile();
   virtual void write_header(bigint);
   virtual void write_data(int, double *);
-  virtual void write();
+  virtual void closefile();
 
   virtual int modify_param(int, char **);
 };
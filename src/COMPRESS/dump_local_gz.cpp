@@ -155,7 +155,7 @@ void DumpLocalGZ::write_data(int n, double *mybuf)
         if (written > 0) {
           writer.write(vbuffer, written);
         } else if (written < 0) {
-          error->one(FLERR, "Error while writing dump local/gz output");
+          write_error(FLERR, "Error while writing dump local/gz output");
         }
         m++;
       }
@@ -166,9 +166,8 @@ void DumpLocalGZ::write_data(int n, double *mybuf)
 
 /* ---------------------------------------------------------------------- */
 
-void DumpLocalGZ::write()
+void DumpLocalGZ::closefile()
 {
-  DumpLocal::write();
   if (filewriter) {
     if (multifile) {
       writer.close();
@@ -192,6 +191,11 @@ int DumpLocalGZ::modify_param(int narg, char **arg)
         int compression_level = utils::inumeric(FLERR, arg[1], false, lmp);
         writer.setCompressionLevel(compression_level);
         return 2;
+      } else if (strcmp(arg[0],"compression_threads") == 0) {
+        if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+        int nthreads = utils::inumeric(FLERR, arg[1], false, lmp);
+        writer.setThreads(nthreads);
+        return 2;
       }
     } catch (FileWriterException &e) {
       error->one(FLERR,"Illegal dump_modify command: {}", e.what());
@@ -166,7 +166,7 @@ void DumpLocalZstd::write_data(int n, double *mybuf)
         if (written > 0) {
           writer.write(vbuffer, written);
         } else if (written < 0) {
-          error->one(FLERR, "Error while writing dump local/gz output");
+          write_error(FLERR, "Error while writing dump local/gz output");
         }
         m++;
       }
@@ -177,9 +177,8 @@ void DumpLocalZstd::write_data(int n, double *mybuf)
 
 /* ---------------------------------------------------------------------- */
 
-void DumpLocalZstd::write()
+void DumpLocalZstd::closefile()
 {
-  DumpLocal::write();
   if (filewriter) {
     if (multifile) {
       writer.close();
@@ -209,6 +208,11 @@ int DumpLocalZstd::modify_param(int narg, char **arg)
         int compression_level = utils::inumeric(FLERR, arg[1], false, lmp);
         writer.setCompressionLevel(compression_level);
         return 2;
+      } else if (strcmp(arg[0],"compression_threads") == 0) {
+        if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+        int nthreads = utils::inumeric(FLERR, arg[1], false, lmp);
+        writer.setThreads(nthreads);
+        return 2;
       }
     } catch (FileWriterException &e) {
       error->one(FLERR,"Illegal dump_modify command: {}", e.what());
@@ -122,7 +122,7 @@ void DumpXYZGZ::write_data(int n, double *mybuf)
       if (written > 0) {
         writer.write(vbuffer, written);
       } else if (written < 0) {
-        error->one(FLERR, "Error while writing dump xyz/gz output");
+        write_error(FLERR, "Error while writing dump xyz/gz output");
       }
       m += size_one;
     }
@@ -131,9 +131,8 @@ void DumpXYZGZ::write_data(int n, double *mybuf)
 
 /* ---------------------------------------------------------------------- */
 
-void DumpXYZGZ::write()
+void DumpXYZGZ::closefile()
 {
-  DumpXYZ::write();
   if (filewriter) {
     if (multifile) {
       writer.close();
@@ -157,6 +156,11 @@ int DumpXYZGZ::modify_param(int narg, char **arg)
         int compression_level = utils::inumeric(FLERR, arg[1], false, lmp);
         writer.setCompressionLevel(compression_level);
         return 2;
+      } else if (strcmp(arg[0],"compression_threads") == 0) {
+        if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+        int nthreads = utils::inumeric(FLERR, arg[1], false, lmp);
+        writer.setThreads(nthreads);
+        return 2;
       }
     } catch (FileWriterException &e) {
       error->one(FLERR,"Illegal dump_modify command: {}", e.what());
@@ -133,7 +133,7 @@ void DumpXYZZstd::write_data(int n, double *mybuf)
       if (written > 0) {
         writer.write(vbuffer, written);
       } else if (written < 0) {
-        error->one(FLERR, "Error while writing dump xyz/gz output");
+        write_error(FLERR, "Error while writing dump xyz/gz output");
       }
       m += size_one;
     }
@@ -142,9 +142,8 @@ void DumpXYZZstd::write_data(int n, double *mybuf)
 
 /* ---------------------------------------------------------------------- */
 
-void DumpXYZZstd::write()
+void DumpXYZZstd::closefile()
 {
-  DumpXYZ::write();
   if (filewriter) {
     if (multifile) {
       writer.close();
@@ -174,6 +173,11 @@ int DumpXYZZstd::modify_param(int narg, char **arg)
         int compression_level = utils::inumeric(FLERR, arg[1], false, lmp);
         writer.setCompressionLevel(compression_level);
         return 2;
+      } else if (strcmp(arg[0],"compression_threads") == 0) {
+        if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+        int nthreads = utils::inumeric(FLERR, arg[1], false, lmp);
+        writer.setThreads(nthreads);
+        return 2;
       }
     } catch (FileWriterException &e) {
       error->one(FLERR,"Illegal dump_modify command: {}", e.what());
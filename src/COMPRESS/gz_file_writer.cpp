@@ -17,13 +17,24 @@
 
 #include "gz_file_writer.h"
 #include <stdio.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
 #include "fmt/format.h"
 
 using namespace LAMMPS_NS;
 
+constexpr size_t GzFileWriter::BLOCK_SIZE;
+constexpr char GzFileWriter::SUBFIELD_ID1;
+constexpr char GzFileWriter::SUBFIELD_ID2;
+
+/* ---------------------------------------------------------------------- */
+
 GzFileWriter::GzFileWriter() : FileWriter(),
     compression_level(Z_BEST_COMPRESSION),
-    gzFp(nullptr)
+    nthreads(0),
+    gzFp(nullptr),
+    fp(nullptr)
 {
 }
 
@@ -40,6 +51,14 @@ void GzFileWriter::open(const std::string &path, bool append)
 {
     if (isopen()) return;
 
+    if (nthreads > 0) {
+      fp = fopen(path.c_str(), append ? "ab" : "wb");
+      if (fp == nullptr)
+        throw FileWriterException(fmt::format("Could not open file '{}'", path));
+      inbuf.reserve(nthreads*BLOCK_SIZE);
+      return;
+    }
+
     std::string mode;
     if (append) {
       mode = fmt::format("ab{}", mode, compression_level);
@@ -59,6 +78,12 @@ size_t GzFileWriter::write(const void * buffer, size_t length)
 {
   if (!isopen()) return 0;
 
+  if (fp) {
+    inbuf.append((const char *) buffer, length);
+    if (inbuf.size() >= nthreads*BLOCK_SIZE) write_blocks();
+    return length;
+  }
+
   return gzwrite(gzFp, buffer, length);
 }
 
@@ -68,6 +93,12 @@ void GzFileWriter::flush()
 {
   if (!isopen()) return;
 
+  if (fp) {
+    write_blocks();
+    fflush(fp);
+    return;
+  }
+
   gzflush(gzFp, Z_SYNC_FLUSH);
 }
 
@@ -77,6 +108,13 @@ void GzFileWriter::close()
 {
   if (!isopen()) return;
 
+  if (fp) {
+    write_blocks();
+    fclose(fp);
+    fp = nullptr;
+    return;
+  }
+
   gzclose(gzFp);
   gzFp = nullptr;
 }
@@ -85,7 +123,7 @@ void GzFileWriter::close()
 
 bool GzFileWriter::isopen() const
 {
-  return gzFp;
+  return gzFp || fp;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -103,3 +141,105 @@ void GzFileWriter::setCompressionLevel(int level)
 
   compression_level = level;
 }
+
+/* ---------------------------------------------------------------------- */
+
+void GzFileWriter::setThreads(int n)
+{
+  if (isopen())
+    throw FileWriterException("Compression threads can not be changed while file is open");
+
+  if (n < 0)
+    throw FileWriterException("Number of compression threads must not be negative");
+
+  nthreads = n;
+}
+
+/* ----------------------------------------------------------------------
+   compress the buffered data in blocks of up to BLOCK_SIZE bytes
+   blocks are compressed concurrently by nthreads threads
+   and written to file in order as independent gzip members
+------------------------------------------------------------------------- */
+
+void GzFileWriter::write_blocks()
+{
+  if (inbuf.empty()) return;
+
+  size_t nblocks = (inbuf.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  std::vector<std::string> outbuf(nblocks);
+
+  auto compress_range = [&](size_t first) {
+    for (size_t i = first; i < nblocks; i += nthreads) {
+      size_t offset = i*BLOCK_SIZE;
+      size_t length = std::min(BLOCK_SIZE, inbuf.size() - offset);
+      compress_block(inbuf.data() + offset, length, compression_level, outbuf[i]);
+    }
+  };
+
+  size_t nworkers = std::min((size_t) nthreads, nblocks);
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < nworkers; ++i) workers.emplace_back(compress_range, i);
+  compress_range(0);
+  for (auto &w : workers) w.join();
+
+  for (auto &out : outbuf) {
+    if (out.empty())
+      throw FileWriterException("Error while compressing gzip block");
+    if (fwrite(out.data(), 1, out.size(), fp) != out.size())
+      throw FileWriterException("Error while writing gzip block");
+  }
+  inbuf.clear();
+}
+
+/* ----------------------------------------------------------------------
+   compress one block into a complete gzip member
+   the header has an extra subfield with the total size of the member,
+     so readers can find the next member without decompressing
+   out is left empty on failure
+------------------------------------------------------------------------- */
+
+void GzFileWriter::compress_block(const char *in, size_t length, int level,
+                                  std::string &out)
+{
+  const unsigned char header[] = {
+    0x1f, 0x8b, Z_DEFLATED, 0x04,    // magic, method, FLG.FEXTRA
+    0, 0, 0, 0, 0, 0x03,             // MTIME, XFL, OS = unix
+    8, 0,                            // XLEN
+    SUBFIELD_ID1, SUBFIELD_ID2, 4, 0, // subfield ID, LEN
+    0, 0, 0, 0                       // member size, set below
+  };
+  const size_t nheader = sizeof(header);
+
+  out.clear();
+
+  z_stream strm;
+  strm.zalloc = Z_NULL;
+  strm.zfree = Z_NULL;
+  strm.opaque = Z_NULL;
+  if (deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    return;
+
+  size_t bound = deflateBound(&strm, length);
+  std::string member(nheader + bound + 8, '\0');
+  memcpy(&member[0], header, nheader);
+
+  strm.next_in = (Bytef *) in;
+  strm.avail_in = length;
+  strm.next_out = (Bytef *) &member[nheader];
+  strm.avail_out = bound;
+  int rv = deflate(&strm, Z_FINISH);
+  size_t ndeflate = strm.total_out;
+  deflateEnd(&strm);
+  if (rv != Z_STREAM_END) return;
+
+  // trailer = CRC32 and uncompressed size, little endian
+
+  uLong crc = crc32(0L, (const Bytef *) in, length);
+  size_t n = nheader + ndeflate;
+  for (int i = 0; i < 4; ++i) member[n++] = (char) ((crc >> (8*i)) & 0xff);
+  for (int i = 0; i < 4; ++i) member[n++] = (char) ((length >> (8*i)) & 0xff);
+  member.resize(n);
+
+  for (int i = 0; i < 4; ++i) member[nheader-4+i] = (char) ((n >> (8*i)) & 0xff);
+  out.swap(member);
+}
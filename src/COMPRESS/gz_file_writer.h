@@ -20,17 +20,31 @@
 
 #include "file_writer.h"
 
+#include <cstdio>
 #include <exception>
 #include <string>
+#include <vector>
 #include <zlib.h>
 
 namespace LAMMPS_NS {
 
 class GzFileWriter : public FileWriter {
   int compression_level;
+  int nthreads;           // 0 = single stream, else # of compression threads
 
-  gzFile gzFp;  // file pointer for the compressed output stream
+  gzFile gzFp;            // file pointer for the compressed output stream
+  FILE *fp;               // file pointer for block-parallel output
+  std::string inbuf;      // uncompressed data of blocks not yet written
+
+  void write_blocks();
 public:
+    static constexpr size_t BLOCK_SIZE = 1 << 20;
+
+    // subfield ID of the gzip extra field with the size of each member
+
+    static constexpr char SUBFIELD_ID1 = 'L';
+    static constexpr char SUBFIELD_ID2 = 'M';
+
     GzFileWriter();
     virtual ~GzFileWriter();
     virtual void open(const std::string &path, bool append = false) override;
@@ -40,6 +54,10 @@ public:
     virtual bool isopen() const override;
 
     void setCompressionLevel(int level);
+    void setThreads(int n);
+
+    static void compress_block(const char *in, size_t length, int level,
+                               std::string &out);
 };
 }
 
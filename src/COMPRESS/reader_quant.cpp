@@ -0,0 +1,260 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://lammps.sandia.gov/, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "reader_quant.h"
+
+#include "dump_custom_quant.h"
+#include "error.h"
+#include "memory.h"
+
+#include <cstring>
+#include <map>
+
+using namespace LAMMPS_NS;
+
+/* ---------------------------------------------------------------------- */
+
+ReaderQuant::ReaderQuant(LAMMPS *lmp) : ReaderNative(lmp)
+{
+  maxrows = maxq = 0;
+  qcur = qprev = nullptr;
+  match = nullptr;
+  natoms = nprev = -1;
+  nfield_prev = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+ReaderQuant::~ReaderQuant()
+{
+  memory->destroy(qcur);
+  memory->destroy(qprev);
+  memory->destroy(match);
+}
+
+/* ----------------------------------------------------------------------
+   open file, its first frame does not depend on earlier frames
+------------------------------------------------------------------------- */
+
+void ReaderQuant::open_file(const char *file)
+{
+  Reader::open_file(file);
+  natoms = nprev = -1;
+}
+
+/* ----------------------------------------------------------------------
+   read and decode the next frame, return its time stamp
+   every frame is decoded, since the next one may be delta coded against it
+   if first read reaches end-of-file, return 1 so caller can open next file
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+int ReaderQuant::read_time(bigint &ntimestep)
+{
+  const int nmagic = strlen(DumpCustomQuant::MAGIC);
+  char magic[16];
+  if (fread(magic,1,nmagic,fp) == 0) return 1;
+  magic[nmagic] = '\0';
+  if (strcmp(magic,DumpCustomQuant::MAGIC) != 0)
+    error->one(FLERR,"Dump file is incorrectly formatted");
+
+  // last decoded frame becomes the previous frame
+
+  if (natoms >= 0) {
+    int64_t *tmp = qprev;
+    qprev = qcur;
+    qcur = tmp;
+    nprev = natoms;
+    nfield_prev = names.size();
+  }
+
+  int revision;
+  read_bytes(&revision,sizeof(int));
+  if (revision != DumpCustomQuant::REVISION)
+    error->one(FLERR,"Dump file is incorrectly formatted");
+  read_bytes(&ntimestep,sizeof(bigint));
+  read_bytes(&natoms,sizeof(bigint));
+  read_bytes(&triclinic,sizeof(int));
+  read_bytes(box,sizeof(box));
+
+  int len,nfield;
+  read_bytes(&len,sizeof(int));
+  std::string boundstr(len,' ');
+  read_bytes(&boundstr[0],len);
+
+  read_bytes(&nfield,sizeof(int));
+  names.resize(nfield);
+  isdouble.resize(nfield);
+  step.resize(nfield);
+  for (int i = 0; i < nfield; i++) {
+    read_bytes(&len,sizeof(int));
+    names[i].resize(len);
+    read_bytes(&names[i][0],len);
+    read_bytes(&isdouble[i],sizeof(int));
+    read_bytes(&step[i],sizeof(double));
+  }
+  read_bytes(&idcol,sizeof(int));
+  int keyframe;
+  read_bytes(&keyframe,sizeof(int));
+
+  if (idcol < 0 || idcol >= nfield || natoms < 0)
+    error->one(FLERR,"Dump file is incorrectly formatted");
+  if (!keyframe && (nprev < 0 || nfield != nfield_prev))
+    error->one(FLERR,"Dump file is incorrectly formatted");
+
+  if (natoms*nfield > maxq) {
+    maxq = natoms*nfield;
+    memory->destroy(qcur);
+    memory->create(qcur,maxq,"read_dump:qcur");
+    memory->grow(qprev,maxq,"read_dump:qprev");
+  }
+  if (natoms > maxrows) {
+    maxrows = natoms;
+    memory->destroy(match);
+    memory->create(match,maxrows,"read_dump:match");
+  }
+
+  // decode atom IDs first, to match atoms to the previous frame
+
+  decode_column(idcol,keyframe);
+
+  if (!keyframe) {
+    const int64_t *id = &qcur[idcol*natoms];
+    const int64_t *idprev = &qprev[idcol*nprev];
+    bigint k = 0;
+    for (bigint i = 0; i < natoms; i++) {
+      while (k < nprev && idprev[k] < id[i]) k++;
+      match[i] = (k < nprev && idprev[k] == id[i]) ? k : -1;
+    }
+  }
+
+  for (int j = 0; j < nfield; j++)
+    if (j != idcol) decode_column(j,keyframe);
+
+  nrow = 0;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   frame was already decoded by read_time()
+------------------------------------------------------------------------- */
+
+void ReaderQuant::skip() {}
+
+/* ----------------------------------------------------------------------
+   return natoms and box bounds of current frame
+   match requested fields to column labels as for native dump files
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+bigint ReaderQuant::read_header(double boxout[3][3], int &boxinfo,
+                                int &triclinicout, int fieldinfo, int nfield,
+                                int *fieldtype, char **fieldlabel,
+                                int scaleflag, int wrapflag, int &fieldflag,
+                                int &xflag, int &yflag, int &zflag)
+{
+  boxinfo = 1;
+  triclinicout = triclinic;
+  for (int i = 0; i < 3; i++) {
+    boxout[i][0] = box[2*i];
+    boxout[i][1] = box[2*i+1];
+    boxout[i][2] = triclinic ? box[6+i] : 0.0;
+  }
+
+  if (!fieldinfo) return natoms;
+
+  std::map<std::string, int> labels;
+  nwords = names.size();
+  for (int i = 0; i < nwords; i++) labels[names[i]] = i;
+
+  fieldflag = match_fields(labels,nfield,fieldtype,fieldlabel,
+                           scaleflag,wrapflag,xflag,yflag,zflag);
+  return natoms;
+}
+
+/* ----------------------------------------------------------------------
+   return N rows of decoded values for selected fields
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+void ReaderQuant::read_atoms(int n, int nfield, double **fields)
+{
+  for (int i = 0; i < n; i++) {
+    if (nrow >= natoms) error->one(FLERR,"Unexpected end of dump file");
+    for (int m = 0; m < nfield; m++) {
+      int j = fieldindex[m];
+      int64_t q = qcur[j*natoms+nrow];
+      double value;
+      if (!isdouble[j]) value = static_cast<double> (q);
+      else if (step[j] == 0.0) memcpy(&value,&q,sizeof(double));
+      else value = q*step[j];
+      fields[i][m] = value;
+    }
+    nrow++;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   read n bytes from file, error on end-of-file
+------------------------------------------------------------------------- */
+
+void ReaderQuant::read_bytes(void *ptr, size_t n)
+{
+  if (n == 0) return;
+  if (fread(ptr,1,n,fp) != n)
+    error->one(FLERR,"Unexpected end of dump file");
+}
+
+/* ----------------------------------------------------------------------
+   read column j from file and decode it into qcur
+   inverse of DumpCustomQuant::encode_column()
+------------------------------------------------------------------------- */
+
+void ReaderQuant::decode_column(int j, int keyframe)
+{
+  bigint nbytes;
+  read_bytes(&nbytes,sizeof(bigint));
+  if (nbytes < natoms) error->one(FLERR,"Dump file is incorrectly formatted");
+  column.resize(nbytes);
+  read_bytes(&column[0],nbytes);
+
+  int64_t *q = &qcur[j*natoms];
+  const int64_t *p = keyframe ? nullptr : &qprev[j*nprev];
+  const int exact = (isdouble[j] && step[j] == 0.0);
+  const unsigned char *ptr = (const unsigned char *) column.data();
+  const unsigned char *end = ptr + nbytes;
+
+  for (bigint i = 0; i < natoms; i++) {
+    uint64_t u = 0;
+    int shift = 0;
+    while (1) {
+      if (ptr == end || shift > 63)
+        error->one(FLERR,"Dump file is incorrectly formatted");
+      unsigned char byte = *ptr++;
+      u |= (uint64_t) (byte & 0x7f) << shift;
+      if (!(byte & 0x80)) break;
+      shift += 7;
+    }
+
+    int64_t pred = 0;
+    if (j == idcol) {
+      if (i) pred = q[i-1];
+    } else if (!keyframe && match[i] >= 0) pred = p[match[i]];
+
+    if (exact) q[i] = (int64_t) (u ^ (uint64_t) pred);
+    else {
+      int64_t r = (int64_t) (u >> 1) ^ -(int64_t) (u & 1);
+      q[i] = (int64_t) ((uint64_t) pred + (uint64_t) r);
+    }
+  }
+}
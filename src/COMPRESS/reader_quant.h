@@ -0,0 +1,80 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://lammps.sandia.gov/, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef READER_CLASS
+
+ReaderStyle(quant,ReaderQuant)
+
+#else
+
+#ifndef LMP_READER_QUANT_H
+#define LMP_READER_QUANT_H
+
+#include "reader_native.h"
+
+#include <string>
+#include <vector>
+
+namespace LAMMPS_NS {
+
+class ReaderQuant : public ReaderNative {
+ public:
+  ReaderQuant(class LAMMPS *);
+  ~ReaderQuant();
+
+  int read_time(bigint &);
+  void skip();
+  bigint read_header(double [3][3], int &, int &, int, int, int *, char **,
+                     int, int, int &, int &, int &, int &);
+  void read_atoms(int, int, double **);
+
+  void open_file(const char *);
+
+ private:
+  bigint natoms;             // # of rows in current frame
+  int triclinic;
+  double box[9];             // box bounds and tilt factors
+
+  std::vector<std::string> names;   // column labels
+  std::vector<int> isdouble;        // 1 if column is floating point
+  std::vector<double> step;         // quantization step, 0 = exact
+  int idcol;                        // column with atom IDs
+
+  bigint maxq;               // allocated size of qcur and qprev
+  bigint maxrows;            // allocated size of match
+  int64_t *qcur;             // quantized columns of current frame
+  int64_t *qprev;            // same for previous frame
+  bigint nprev;              // # of rows in qprev, -1 if none
+  int nfield_prev;           // # of columns in qprev
+  bigint *match;             // row in qprev with the same atom ID, or -1
+  bigint nrow;               // next row returned by read_atoms()
+
+  std::string column;        // encoded bytes of one column
+
+  void read_bytes(void *, size_t);
+  void decode_column(int, int);
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Dump file is incorrectly formatted
+
+The file was not written by dump custom/quant, is truncated, or a
+frame refers to a previous frame that is not in the file.
+
+*/
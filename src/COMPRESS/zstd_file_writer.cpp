@@ -19,15 +19,24 @@
 
 #include "zstd_file_writer.h"
 #include <stdio.h>
+#include <algorithm>
+#include <thread>
 #include "fmt/format.h"
 
 using namespace LAMMPS_NS;
 
+constexpr size_t ZstdFileWriter::FRAME_SIZE;
+constexpr uint32_t ZstdFileWriter::SKIPPABLE_MAGIC;
+constexpr uint32_t ZstdFileWriter::SEEKABLE_MAGIC;
+
+/* ---------------------------------------------------------------------- */
+
 ZstdFileWriter::ZstdFileWriter() : FileWriter(),
     compression_level(0),
     checksum_flag(1),
     cctx(nullptr),
-    fp(nullptr)
+    fp(nullptr),
+    nthreads(0)
 {
   out_buffer_size = ZSTD_CStreamOutSize();
   out_buffer = new char[out_buffer_size];
@@ -50,6 +59,9 @@ void ZstdFileWriter::open(const std::string &path, bool append)
 {
     if (isopen()) return;
 
+    if (append && nthreads > 0)
+      throw FileWriterException("Zstd compression threads do not support append");
+
     if (append) {
       fp = fopen(path.c_str(), "ab");
     } else {
@@ -78,6 +90,12 @@ size_t ZstdFileWriter::write(const void * buffer, size_t length)
 {
   if (!isopen()) return 0;
 
+  if (nthreads > 0) {
+    inbuf.append((const char *) buffer, length);
+    if (inbuf.size() >= nthreads*FRAME_SIZE) write_frames();
+    return length;
+  }
+
   ZSTD_inBuffer input = { buffer, length, 0 };
   ZSTD_EndDirective mode = ZSTD_e_continue;
 
@@ -96,6 +114,12 @@ void ZstdFileWriter::flush()
 {
   if (!isopen()) return;
 
+  if (nthreads > 0) {
+    write_frames();
+    fflush(fp);
+    return;
+  }
+
   size_t remaining;
   ZSTD_inBuffer input = { nullptr, 0, 0 };
   ZSTD_EndDirective mode = ZSTD_e_flush;
@@ -115,15 +139,20 @@ void ZstdFileWriter::close()
 {
   if (!isopen()) return;
 
-  size_t remaining;
-  ZSTD_inBuffer input = { nullptr, 0, 0 };
-  ZSTD_EndDirective mode = ZSTD_e_end;
-
-  do {
-    ZSTD_outBuffer output = { out_buffer, out_buffer_size, 0 };
-    remaining = ZSTD_compressStream2(cctx, &output, &input, mode);
-    fwrite(out_buffer, sizeof(char), output.pos, fp);
-  } while (remaining);
+  if (nthreads > 0) {
+    write_frames();
+    write_seek_table();
+  } else {
+    size_t remaining;
+    ZSTD_inBuffer input = { nullptr, 0, 0 };
+    ZSTD_EndDirective mode = ZSTD_e_end;
+
+    do {
+      ZSTD_outBuffer output = { out_buffer, out_buffer_size, 0 };
+      remaining = ZSTD_compressStream2(cctx, &output, &input, mode);
+      fwrite(out_buffer, sizeof(char), output.pos, fp);
+    } while (remaining);
+  }
 
   ZSTD_freeCCtx(cctx);
   cctx = nullptr;
@@ -163,4 +192,91 @@ void ZstdFileWriter::setChecksum(bool enabled)
   checksum_flag = enabled ? 1 : 0;
 }
 
+/* ---------------------------------------------------------------------- */
+
+void ZstdFileWriter::setThreads(int n)
+{
+  if (isopen())
+    throw FileWriterException("Compression threads can not be changed while file is open");
+
+  if (n < 0)
+    throw FileWriterException("Number of compression threads must not be negative");
+
+  nthreads = n;
+}
+
+/* ----------------------------------------------------------------------
+   compress the buffered data in frames of up to FRAME_SIZE bytes
+   frames are compressed concurrently by nthreads threads, each with
+     its own context, and written to file in order
+   their sizes are recorded for the seek table
+------------------------------------------------------------------------- */
+
+void ZstdFileWriter::write_frames()
+{
+  if (inbuf.empty()) return;
+
+  size_t nframes = (inbuf.size() + FRAME_SIZE - 1) / FRAME_SIZE;
+  std::vector<std::string> outbuf(nframes);
+
+  auto compress_range = [&](size_t first) {
+    ZSTD_CCtx *ctx = ZSTD_createCCtx();
+    if (!ctx) return;
+    ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel, compression_level);
+    ZSTD_CCtx_setParameter(ctx, ZSTD_c_checksumFlag, checksum_flag);
+    for (size_t i = first; i < nframes; i += nthreads) {
+      size_t offset = i*FRAME_SIZE;
+      size_t length = std::min(FRAME_SIZE, inbuf.size() - offset);
+      std::string &out = outbuf[i];
+      out.resize(ZSTD_compressBound(length));
+      size_t n = ZSTD_compress2(ctx, &out[0], out.size(), inbuf.data() + offset, length);
+      if (ZSTD_isError(n)) out.clear();
+      else out.resize(n);
+    }
+    ZSTD_freeCCtx(ctx);
+  };
+
+  size_t nworkers = std::min((size_t) nthreads, nframes);
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < nworkers; ++i) workers.emplace_back(compress_range, i);
+  compress_range(0);
+  for (auto &w : workers) w.join();
+
+  for (size_t i = 0; i < nframes; ++i) {
+    std::string &out = outbuf[i];
+    if (out.empty())
+      throw FileWriterException("Error while compressing zstd frame");
+    if (fwrite(out.data(), 1, out.size(), fp) != out.size())
+      throw FileWriterException("Error while writing zstd frame");
+    seek_table.push_back(out.size());
+    seek_table.push_back(std::min(FRAME_SIZE, inbuf.size() - i*FRAME_SIZE));
+  }
+  inbuf.clear();
+}
+
+/* ----------------------------------------------------------------------
+   append the seek table as a skippable frame in the zstd seekable format
+   entries = compressed and decompressed size of each frame
+   footer = # of frames, descriptor (no checksums), seekable magic number
+------------------------------------------------------------------------- */
+
+void ZstdFileWriter::write_seek_table()
+{
+  std::string table;
+  auto append_u32 = [&](uint32_t value) {
+    for (int i = 0; i < 4; ++i) table.push_back((char) ((value >> (8*i)) & 0xff));
+  };
+
+  uint32_t nframes = seek_table.size() / 2;
+  append_u32(SKIPPABLE_MAGIC);
+  append_u32(8*nframes + 9);
+  for (auto size : seek_table) append_u32(size);
+  append_u32(nframes);
+  table.push_back((char) 0);
+  append_u32(SEEKABLE_MAGIC);
+
+  fwrite(table.data(), 1, table.size(), fp);
+  seek_table.clear();
+}
+
 #endif
@@ -22,7 +22,9 @@
 
 #include "file_writer.h"
 
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <zstd.h>
 
 namespace LAMMPS_NS {
@@ -35,7 +37,21 @@ class ZstdFileWriter : public FileWriter {
   FILE * fp;
   char * out_buffer;
   size_t out_buffer_size;
+
+  int nthreads;             // 0 = single stream, else # of compression threads
+  std::string inbuf;        // uncompressed data of frames not yet written
+  std::vector<uint32_t> seek_table;  // compressed and uncompressed frame sizes
+
+  void write_frames();
+  void write_seek_table();
 public:
+    static constexpr size_t FRAME_SIZE = 1 << 20;
+
+    // magic numbers of the zstd seekable format
+
+    static constexpr uint32_t SKIPPABLE_MAGIC = 0x184D2A5E;
+    static constexpr uint32_t SEEKABLE_MAGIC = 0x8F92EAB1;
+
     ZstdFileWriter();
     virtual ~ZstdFileWriter();
     virtual void open(const std::string &path, bool append = false) override;
@@ -46,6 +62,7 @@ public:
 
     void setCompressionLevel(int level);
     void setChecksum(bool enabled);
+    void setThreads(int n);
 };
 }
 
@@ -31,6 +31,7 @@ ComputeTempKokkos<DeviceType>::ComputeTempKokkos(LAMMPS *lmp, int narg, char **a
   ComputeTemp(lmp, narg, arg)
 {
   kokkosable = 1;
+  partial_scalar_flag = partial_vector_flag = 0;
   atomKK = (AtomKokkos *) atom;
   execution_space = ExecutionSpaceFromDevice<DeviceType>::space;
 
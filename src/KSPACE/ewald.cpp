@@ -49,6 +49,7 @@ Ewald::Ewald(LAMMPS *lmp) : KSpace(lmp),
   kmax_created = 0;
   ewaldflag = 1;
   group_group_enable = 1;
+  mc_delta_enable = 1;
 
   accuracy_relative = 0.0;
 
@@ -63,6 +64,9 @@ Ewald::Ewald(LAMMPS *lmp) : KSpace(lmp),
   cs = sn = nullptr;
 
   kcount = 0;
+
+  sfac_current = 0;
+  energy_sfac = qsum_sfac = qsum_delta = 0.0;
 }
 
 void Ewald::settings(int narg, char **arg)
@@ -110,6 +114,10 @@ void Ewald::init()
                  "and slab correction");
   }
 
+  // incremental energy changes do not include the slab correction
+
+  mc_delta_enable = (slabflag == 0) ? 1 : 0;
+
   // compute two charge force
 
   two_charge();
@@ -202,6 +210,8 @@ void Ewald::init()
 
 void Ewald::setup()
 {
+  sfac_current = 0;
+
   // volume-dependent factors
 
   double xprd = domain->xprd;
@@ -363,7 +373,10 @@ void Ewald::compute(int eflag, int vflag)
 
   // return if there are no charges
 
-  if (qsqsum == 0.0) return;
+  if (qsqsum == 0.0) {
+    sfac_current = 0;
+    return;
+  }
 
   // extend size of per-atom arrays if necessary
 
@@ -484,6 +497,14 @@ void Ewald::compute(int eflag, int vflag)
   // 2d slab correction
 
   if (slabflag == 1) slabcorr();
+
+  // reference for incremental energy changes
+
+  if (eflag_global) {
+    sfac_current = 1;
+    energy_sfac = energy;
+    qsum_sfac = qsum;
+  }
 }
 
 /* ---------------------------------------------------------------------- */
@@ -1221,6 +1242,117 @@ void Ewald::slabcorr()
   for (int i = 0; i < nlocal; i++) f[i][2] += ffact * q[i]*(dipole_all - qsum*x[i][2]);
 }
 
+/* ----------------------------------------------------------------------
+   change of the long-range energy after a few atoms were modified since
+   the last compute() with energy, e.g. by a Monte Carlo move
+   list = local indices of the modified atoms, whose current position and
+     charge are in atom->x and atom->q
+   xold,qold = old position and charge of each listed atom,
+     xold = nullptr if no atom was moved
+   an inserted atom has qold = 0, a deleted atom is listed with q = 0
+   only the structure factor contributions of the listed atoms are
+   computed, O(kcount) per atom instead of O(kcount*nlocal)
+   must be called on all procs, the trial energy is kept until
+   accept_delta() is called
+------------------------------------------------------------------------- */
+
+double Ewald::energy_delta(int n, int *list, double **xold, double *qold)
+{
+  if (!sfac_current)
+    error->all(FLERR,"Ewald structure factors are not current");
+
+  double **x = atom->x;
+  double *q = atom->q;
+
+  for (int k = 0; k < kcount; k++) sfacrl[k] = sfacim[k] = 0.0;
+
+  double dq[2],dq_all[2];
+  dq[0] = dq[1] = 0.0;
+
+  for (int m = 0; m < n; m++) {
+    const int i = list[m];
+    if (xold) {
+      sfac_one(x[i],q[i]);
+      sfac_one(xold[m],-qold[m]);
+    } else sfac_one(x[i],q[i]-qold[m]);
+    dq[0] += q[i] - qold[m];
+    dq[1] += q[i]*q[i] - qold[m]*qold[m];
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE,sfacrl,kcount,MPI_DOUBLE,MPI_SUM,world);
+  MPI_Allreduce(MPI_IN_PLACE,sfacim,kcount,MPI_DOUBLE,MPI_SUM,world);
+  MPI_Allreduce(dq,dq_all,2,MPI_DOUBLE,MPI_SUM,world);
+
+  // |S + dS|^2 - |S|^2 = dS (2 S + dS)
+
+  double eng = 0.0;
+  for (int k = 0; k < kcount; k++)
+    eng += ug[k] * (sfacrl[k]*(2.0*sfacrl_all[k] + sfacrl[k]) +
+                    sfacim[k]*(2.0*sfacim_all[k] + sfacim[k]));
+
+  // change of self energy and of the neutralizing background
+
+  qsum_delta = dq_all[0];
+  const double qsum_trial = qsum_sfac + qsum_delta;
+  eng -= g_ewald*dq_all[1]/MY_PIS +
+    MY_PI2*(qsum_trial*qsum_trial - qsum_sfac*qsum_sfac) /
+    (g_ewald*g_ewald*volume);
+  eng *= qqrd2e*scale;
+
+  energy = energy_sfac + eng;
+  return eng;
+}
+
+/* ----------------------------------------------------------------------
+   accept (flag = 1) or reject (flag = 0) the last energy_delta() trial
+   on acceptance the trial structure factors become the reference
+------------------------------------------------------------------------- */
+
+void Ewald::accept_delta(int flag)
+{
+  if (flag) {
+    for (int k = 0; k < kcount; k++) {
+      sfacrl_all[k] += sfacrl[k];
+      sfacim_all[k] += sfacim[k];
+    }
+    qsum_sfac += qsum_delta;
+    energy_sfac = energy;
+  } else energy = energy_sfac;
+}
+
+/* ----------------------------------------------------------------------
+   add structure factor contributions q exp(i k.x) of a single charge
+------------------------------------------------------------------------- */
+
+void Ewald::sfac_one(const double *xone, double qone)
+{
+  double kdotx[3];
+
+  if (triclinic == 0) {
+    kdotx[0] = unitk[0]*xone[0];
+    kdotx[1] = unitk[1]*xone[1];
+    kdotx[2] = unitk[2]*xone[2];
+  } else {
+    double unitk_lamda[3];
+    for (int ic = 0; ic < 3; ic++) {
+      unitk_lamda[0] = 0.0;
+      unitk_lamda[1] = 0.0;
+      unitk_lamda[2] = 0.0;
+      unitk_lamda[ic] = 2.0*MY_PI;
+      x2lamdaT(&unitk_lamda[0],&unitk_lamda[0]);
+      kdotx[ic] = unitk_lamda[0]*xone[0] + unitk_lamda[1]*xone[1] +
+        unitk_lamda[2]*xone[2];
+    }
+  }
+
+  for (int k = 0; k < kcount; k++) {
+    const double arg = kxvecs[k]*kdotx[0] + kyvecs[k]*kdotx[1] +
+      kzvecs[k]*kdotx[2];
+    sfacrl[k] += qone*cos(arg);
+    sfacim[k] += qone*sin(arg);
+  }
+}
+
 /* ----------------------------------------------------------------------
    memory usage of local arrays
 ------------------------------------------------------------------------- */
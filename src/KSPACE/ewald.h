@@ -36,6 +36,11 @@ class Ewald : public KSpace {
 
   void compute_group_group(int, int, int);
 
+  // incremental structure factors for Monte Carlo moves
+
+  double energy_delta(int, int *, double **, double *);
+  void accept_delta(int);
+
  protected:
   int kxmax,kymax,kzmax;
   int kcount,kmax,kmax3d,kmax_created;
@@ -51,6 +56,14 @@ class Ewald : public KSpace {
   double *sfacrl,*sfacim,*sfacrl_all,*sfacim_all;
   double ***cs,***sn;
 
+  // incremental structure factors for Monte Carlo moves
+
+  int sfac_current;                // 1 if sfacrl_all matches the atoms
+  double energy_sfac;              // energy matching sfacrl_all
+  double qsum_sfac;                // total charge matching sfacrl_all
+  double qsum_delta;               // change of total charge in last trial
+  void sfac_one(const double *, double);
+
   // group-group interactions
 
   int group_allocate_flag;
@@ -90,6 +103,12 @@ Self-explanatory.  Check the input script syntax and compare to the
 documentation for the command.  You can use -echo screen as a
 command-line option when running LAMMPS to see the offending line.
 
+E: Ewald structure factors are not current
+
+An incremental energy change was requested from kspace style ewald
+before the energy of the current configuration was computed, or after
+the box or the k-space vectors changed.
+
 E: Cannot use Ewald with 2d simulation
 
 The kspace style ewald cannot be used in 2d simulations.  You can use
@@ -44,6 +44,7 @@ EwaldDipole::EwaldDipole(LAMMPS *lmp) : Ewald(lmp),
 {
   ewaldflag = dipoleflag = 1;
   group_group_enable = 0;
+  mc_delta_enable = 0;
   tk = nullptr;
   vc = nullptr;
 }
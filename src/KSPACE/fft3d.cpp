@@ -24,6 +24,8 @@
 #include "remap.h"
 
 #include <cstdlib>
+#include <cstdio>
+#include <cstring>
 #include <cmath>
 
 #if defined(_OPENMP)
@@ -38,6 +40,51 @@
 #define MIN(A,B) ((A) < (B) ? (A) : (B))
 #define MAX(A,B) ((A) > (B) ? (A) : (B))
 
+/* ----------------------------------------------------------------------
+   cache of 1d FFT plans (FFTW3) or descriptors (MKL)
+   PPPM destroys and re-creates its 3d FFTs in every init(), i.e. for
+     every run command, but the 1d FFTs only depend on the FFT length,
+     the # of FFTs per proc, the planner effort and the # of threads
+   entries are reference counted, unused entries are kept so they can
+     be re-used by the next 3d FFT with the same grid and decomposition
+   they are freed when the cache is full or by fft_3d_clear_cache()
+------------------------------------------------------------------------- */
+
+#if defined(FFT_MKL) || defined(FFT_FFTW3)
+
+#define FFT_PLAN_CACHE 64
+
+struct fft_cache_entry {
+  int n,howmany;                    // length and # of 1d FFTs
+  int plantype,nthreads;            // planner effort and # of threads
+  int refcount;                     // # of 3d FFT plans using this entry
+  int stamp;                        // last use, for evicting old entries
+#if defined(FFT_MKL)
+  DFTI_DESCRIPTOR *handle;
+#else
+  FFTW_API(plan) forward;
+  FFTW_API(plan) backward;
+#endif
+};
+
+static struct fft_cache_entry plan_cache[FFT_PLAN_CACHE];
+static int ncache = 0;
+static int cache_stamp = 0;
+
+#if defined(FFT_FFTW3)
+static int wisdom_new = 0;          // 1 if plans were measured since export
+static char *wisdom_file = nullptr; // wisdom file imported last
+#if defined(FFT_FFTW_THREADS)
+static int threads_init = 0;
+#endif
+#endif
+
+static struct fft_cache_entry *fft_cache_acquire(int, int, int, int);
+static void fft_cache_release(struct fft_cache_entry *);
+static void fft_cache_destroy(struct fft_cache_entry *);
+
+#endif
+
 /* ----------------------------------------------------------------------
    Data layout for 3d FFTs:
 
@@ -238,6 +285,9 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
                           2 = permute twice = slow->fast, fast->mid, mid->slow
    nbuf                 returns size of internal storage buffers used by FFT
    usecollective        use collective MPI operations for remapping data
+   plantype             planner effort for 1d FFTs, only used by FFTW3
+                          FFT_PLAN_ESTIMATE, FFT_PLAN_MEASURE,
+                          FFT_PLAN_PATIENT, FFT_PLAN_EXHAUSTIVE
 ------------------------------------------------------------------------- */
 
 struct fft_plan_3d *fft_3d_create_plan(
@@ -246,7 +296,7 @@ struct fft_plan_3d *fft_3d_create_plan(
        int in_klo, int in_khi,
        int out_ilo, int out_ihi, int out_jlo, int out_jhi,
        int out_klo, int out_khi,
-       int scaled, int permute, int *nbuf, int usecollective)
+       int scaled, int permute, int *nbuf, int usecollective, int plantype)
 {
   struct fft_plan_3d *plan;
   int me,nprocs,nthreads;
@@ -480,81 +530,38 @@ struct fft_plan_3d *fft_3d_create_plan(
   // system specific pre-computation of 1d FFT coeffs
   // and scaling normalization
 
+#if defined(FFT_MKL) || defined(FFT_FFTW3)
+  struct fft_cache_entry *entry;
+
+  entry = fft_cache_acquire(nfast,plan->total1/plan->length1,
+                            plantype,nthreads);
+  if (entry == nullptr) return nullptr;
 #if defined(FFT_MKL)
-  DftiCreateDescriptor( &(plan->handle_fast), FFT_MKL_PREC, DFTI_COMPLEX, 1,
-                        (MKL_LONG)nfast);
-  DftiSetValue(plan->handle_fast, DFTI_NUMBER_OF_TRANSFORMS,
-               (MKL_LONG)plan->total1/nfast);
-  DftiSetValue(plan->handle_fast, DFTI_PLACEMENT,DFTI_INPLACE);
-  DftiSetValue(plan->handle_fast, DFTI_INPUT_DISTANCE, (MKL_LONG)nfast);
-  DftiSetValue(plan->handle_fast, DFTI_OUTPUT_DISTANCE, (MKL_LONG)nfast);
-#if defined(FFT_MKL_THREADS)
-  DftiSetValue(plan->handle_fast, DFTI_NUMBER_OF_USER_THREADS, nthreads);
+  plan->handle_fast = entry->handle;
+#else
+  plan->plan_fast_forward = entry->forward;
+  plan->plan_fast_backward = entry->backward;
 #endif
-  DftiCommitDescriptor(plan->handle_fast);
 
-  DftiCreateDescriptor( &(plan->handle_mid), FFT_MKL_PREC, DFTI_COMPLEX, 1,
-                        (MKL_LONG)nmid);
-  DftiSetValue(plan->handle_mid, DFTI_NUMBER_OF_TRANSFORMS,
-               (MKL_LONG)plan->total2/nmid);
-  DftiSetValue(plan->handle_mid, DFTI_PLACEMENT,DFTI_INPLACE);
-  DftiSetValue(plan->handle_mid, DFTI_INPUT_DISTANCE, (MKL_LONG)nmid);
-  DftiSetValue(plan->handle_mid, DFTI_OUTPUT_DISTANCE, (MKL_LONG)nmid);
-#if defined(FFT_MKL_THREADS)
-  DftiSetValue(plan->handle_mid, DFTI_NUMBER_OF_USER_THREADS, nthreads);
+  entry = fft_cache_acquire(nmid,plan->total2/plan->length2,
+                            plantype,nthreads);
+  if (entry == nullptr) return nullptr;
+#if defined(FFT_MKL)
+  plan->handle_mid = entry->handle;
+#else
+  plan->plan_mid_forward = entry->forward;
+  plan->plan_mid_backward = entry->backward;
 #endif
-  DftiCommitDescriptor(plan->handle_mid);
 
-  DftiCreateDescriptor( &(plan->handle_slow), FFT_MKL_PREC, DFTI_COMPLEX, 1,
-                        (MKL_LONG)nslow);
-  DftiSetValue(plan->handle_slow, DFTI_NUMBER_OF_TRANSFORMS,
-               (MKL_LONG)plan->total3/nslow);
-  DftiSetValue(plan->handle_slow, DFTI_PLACEMENT,DFTI_INPLACE);
-  DftiSetValue(plan->handle_slow, DFTI_INPUT_DISTANCE, (MKL_LONG)nslow);
-  DftiSetValue(plan->handle_slow, DFTI_OUTPUT_DISTANCE, (MKL_LONG)nslow);
-#if defined(FFT_MKL_THREADS)
-  DftiSetValue(plan->handle_slow, DFTI_NUMBER_OF_USER_THREADS, nthreads);
+  entry = fft_cache_acquire(nslow,plan->total3/plan->length3,
+                            plantype,nthreads);
+  if (entry == nullptr) return nullptr;
+#if defined(FFT_MKL)
+  plan->handle_slow = entry->handle;
+#else
+  plan->plan_slow_forward = entry->forward;
+  plan->plan_slow_backward = entry->backward;
 #endif
-  DftiCommitDescriptor(plan->handle_slow);
-
-#elif defined(FFT_FFTW3)
-#if defined(FFT_FFTW_THREADS)
-  if (nthreads > 1) {
-    FFTW_API(init_threads)();
-    FFTW_API(plan_with_nthreads)(nthreads);
-  }
-#endif
-
-  plan->plan_fast_forward =
-    FFTW_API(plan_many_dft)(1, &nfast,plan->total1/plan->length1,
-                            nullptr,&nfast,1,plan->length1,
-                            nullptr,&nfast,1,plan->length1,
-                            FFTW_FORWARD,FFTW_ESTIMATE);
-  plan->plan_fast_backward =
-    FFTW_API(plan_many_dft)(1, &nfast,plan->total1/plan->length1,
-                            nullptr,&nfast,1,plan->length1,
-                            nullptr,&nfast,1,plan->length1,
-                            FFTW_BACKWARD,FFTW_ESTIMATE);
-  plan->plan_mid_forward =
-    FFTW_API(plan_many_dft)(1, &nmid,plan->total2/plan->length2,
-                            nullptr,&nmid,1,plan->length2,
-                            nullptr,&nmid,1,plan->length2,
-                            FFTW_FORWARD,FFTW_ESTIMATE);
-  plan->plan_mid_backward =
-    FFTW_API(plan_many_dft)(1, &nmid,plan->total2/plan->length2,
-                            nullptr,&nmid,1,plan->length2,
-                            nullptr,&nmid,1,plan->length2,
-                            FFTW_BACKWARD,FFTW_ESTIMATE);
-  plan->plan_slow_forward =
-    FFTW_API(plan_many_dft)(1, &nslow,plan->total3/plan->length3,
-                            nullptr,&nslow,1,plan->length3,
-                            nullptr,&nslow,1,plan->length3,
-                            FFTW_FORWARD,FFTW_ESTIMATE);
-  plan->plan_slow_backward =
-    FFTW_API(plan_many_dft)(1, &nslow,plan->total3/plan->length3,
-                            nullptr,&nslow,1,plan->length3,
-                            nullptr,&nslow,1,plan->length3,
-                            FFTW_BACKWARD,FFTW_ESTIMATE);
 
 #else /* FFT_KISS */
 
@@ -611,20 +618,26 @@ void fft_3d_destroy_plan(struct fft_plan_3d *plan)
   if (plan->copy) free(plan->copy);
   if (plan->scratch) free(plan->scratch);
 
+#if defined(FFT_MKL) || defined(FFT_FFTW3)
+  // release 1d plans back to the cache, look them up by plan handle
+
+  for (int i = 0; i < ncache; i++) {
 #if defined(FFT_MKL)
-  DftiFreeDescriptor(&(plan->handle_fast));
-  DftiFreeDescriptor(&(plan->handle_mid));
-  DftiFreeDescriptor(&(plan->handle_slow));
-#elif defined(FFT_FFTW3)
-  FFTW_API(destroy_plan)(plan->plan_slow_forward);
-  FFTW_API(destroy_plan)(plan->plan_slow_backward);
-  FFTW_API(destroy_plan)(plan->plan_mid_forward);
-  FFTW_API(destroy_plan)(plan->plan_mid_backward);
-  FFTW_API(destroy_plan)(plan->plan_fast_forward);
-  FFTW_API(destroy_plan)(plan->plan_fast_backward);
-#if defined(FFT_FFTW_THREADS)
-  FFTW_API(cleanup_threads)();
+    if (plan_cache[i].handle == plan->handle_fast)
+      fft_cache_release(&plan_cache[i]);
+    if (plan_cache[i].handle == plan->handle_mid)
+      fft_cache_release(&plan_cache[i]);
+    if (plan_cache[i].handle == plan->handle_slow)
+      fft_cache_release(&plan_cache[i]);
+#else
+    if (plan_cache[i].forward == plan->plan_fast_forward)
+      fft_cache_release(&plan_cache[i]);
+    if (plan_cache[i].forward == plan->plan_mid_forward)
+      fft_cache_release(&plan_cache[i]);
+    if (plan_cache[i].forward == plan->plan_slow_forward)
+      fft_cache_release(&plan_cache[i]);
 #endif
+  }
 #else
   if (plan->cfg_slow_forward != plan->cfg_fast_forward &&
       plan->cfg_slow_forward != plan->cfg_mid_forward) {
@@ -813,3 +826,261 @@ void fft_1d_only(FFT_DATA *data, int nsize, int flag, struct fft_plan_3d *plan)
     }
   }
 }
+
+#if defined(FFT_MKL) || defined(FFT_FFTW3)
+
+/* ----------------------------------------------------------------------
+   return cache entry for howmany 1d FFTs of length n, create if needed
+   the same entry is returned for all 3 dims if they have the same shape
+   return nullptr if plan creation failed
+------------------------------------------------------------------------- */
+
+static struct fft_cache_entry *fft_cache_acquire(int n, int howmany,
+                                                 int plantype, int nthreads)
+{
+  int i;
+  struct fft_cache_entry *entry;
+
+#if defined(FFT_MKL)
+  plantype = FFT_PLAN_ESTIMATE;
+#endif
+
+  cache_stamp++;
+
+  for (i = 0; i < ncache; i++) {
+    entry = &plan_cache[i];
+    if (entry->n == n && entry->howmany == howmany &&
+        entry->plantype == plantype && entry->nthreads == nthreads) {
+      entry->refcount++;
+      entry->stamp = cache_stamp;
+      return entry;
+    }
+  }
+
+  // cache is full: replace least recently used entry not in use
+  // if all are in use, the cache is too small for the # of 3d FFTs
+
+  if (ncache < FFT_PLAN_CACHE) entry = &plan_cache[ncache++];
+  else {
+    entry = nullptr;
+    for (i = 0; i < ncache; i++)
+      if (plan_cache[i].refcount == 0 &&
+          (entry == nullptr || plan_cache[i].stamp < entry->stamp))
+        entry = &plan_cache[i];
+    if (entry == nullptr) return nullptr;
+    fft_cache_destroy(entry);
+  }
+
+  entry->n = n;
+  entry->howmany = howmany;
+  entry->plantype = plantype;
+  entry->nthreads = nthreads;
+  entry->refcount = 1;
+  entry->stamp = cache_stamp;
+
+#if defined(FFT_MKL)
+  DftiCreateDescriptor(&(entry->handle),FFT_MKL_PREC,DFTI_COMPLEX,1,
+                       (MKL_LONG)n);
+  DftiSetValue(entry->handle,DFTI_NUMBER_OF_TRANSFORMS,(MKL_LONG)howmany);
+  DftiSetValue(entry->handle,DFTI_PLACEMENT,DFTI_INPLACE);
+  DftiSetValue(entry->handle,DFTI_INPUT_DISTANCE,(MKL_LONG)n);
+  DftiSetValue(entry->handle,DFTI_OUTPUT_DISTANCE,(MKL_LONG)n);
+#if defined(FFT_MKL_THREADS)
+  DftiSetValue(entry->handle,DFTI_NUMBER_OF_USER_THREADS,nthreads);
+#endif
+  DftiCommitDescriptor(entry->handle);
+#else
+
+#if defined(FFT_FFTW_THREADS)
+  if (nthreads > 1) {
+    if (!threads_init) FFTW_API(init_threads)();
+    threads_init = 1;
+  }
+  if (threads_init) FFTW_API(plan_with_nthreads)(nthreads);
+#endif
+
+  // FFTW_ESTIMATE does not touch the data, so no array is needed
+  // all other planner modes run trial FFTs on a scratch array
+
+  unsigned int flags = FFTW_ESTIMATE;
+  if (plantype == FFT_PLAN_MEASURE) flags = FFTW_MEASURE;
+  else if (plantype == FFT_PLAN_PATIENT) flags = FFTW_PATIENT;
+  else if (plantype == FFT_PLAN_EXHAUSTIVE) flags = FFTW_EXHAUSTIVE;
+
+  FFT_DATA *data = nullptr;
+  if (flags != FFTW_ESTIMATE) {
+    data = (FFT_DATA *) FFTW_API(malloc)(sizeof(FFT_DATA)*n*howmany);
+    if (data == nullptr) {
+      ncache--;
+      return nullptr;
+    }
+    wisdom_new = 1;
+  }
+
+  entry->forward =
+    FFTW_API(plan_many_dft)(1,&n,howmany,data,&n,1,n,data,&n,1,n,
+                            FFTW_FORWARD,flags);
+  entry->backward =
+    FFTW_API(plan_many_dft)(1,&n,howmany,data,&n,1,n,data,&n,1,n,
+                            FFTW_BACKWARD,flags);
+  if (data) FFTW_API(free)(data);
+#endif
+
+  return entry;
+}
+
+/* ----------------------------------------------------------------------
+   drop one reference to a cache entry, keep it for later re-use
+------------------------------------------------------------------------- */
+
+static void fft_cache_release(struct fft_cache_entry *entry)
+{
+  if (entry->refcount > 0) entry->refcount--;
+}
+
+/* ----------------------------------------------------------------------
+   free the 1d FFT plans of a cache entry
+------------------------------------------------------------------------- */
+
+static void fft_cache_destroy(struct fft_cache_entry *entry)
+{
+#if defined(FFT_MKL)
+  DftiFreeDescriptor(&(entry->handle));
+#else
+  FFTW_API(destroy_plan)(entry->forward);
+  FFTW_API(destroy_plan)(entry->backward);
+#endif
+}
+
+#endif
+
+/* ----------------------------------------------------------------------
+   free all cached 1d FFT plans that are not used by a 3d FFT plan
+------------------------------------------------------------------------- */
+
+void fft_3d_clear_cache()
+{
+#if defined(FFT_MKL) || defined(FFT_FFTW3)
+  int i = 0;
+  while (i < ncache) {
+    if (plan_cache[i].refcount == 0) {
+      fft_cache_destroy(&plan_cache[i]);
+      plan_cache[i] = plan_cache[--ncache];
+    } else i++;
+  }
+#if defined(FFT_FFTW_THREADS)
+  if (ncache == 0 && threads_init) {
+    FFTW_API(cleanup_threads)();
+    threads_init = 0;
+  }
+#endif
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   read FFTW wisdom from file on proc 0 and broadcast to all procs
+   only done once per file, since FFTW keeps the wisdom in memory
+   return 1 if wisdom is available, 0 if the file could not be read
+   no-op for other FFT libraries
+------------------------------------------------------------------------- */
+
+int fft_3d_import_wisdom(MPI_Comm comm, const char *file)
+{
+#if defined(FFT_FFTW3)
+  int me,flag,n;
+  char *wisdom = nullptr;
+
+  if (wisdom_file && strcmp(wisdom_file,file) == 0) return 1;
+
+  MPI_Comm_rank(comm,&me);
+
+  flag = n = 0;
+  if (me == 0) {
+    flag = FFTW_API(import_wisdom_from_filename)(file);
+    if (flag) {
+      wisdom = FFTW_API(export_wisdom_to_string)();
+      n = strlen(wisdom) + 1;
+    }
+  }
+  MPI_Bcast(&flag,1,MPI_INT,0,comm);
+  if (!flag) return 0;
+
+  MPI_Bcast(&n,1,MPI_INT,0,comm);
+  if (me) wisdom = (char *) malloc(n);
+  MPI_Bcast(wisdom,n,MPI_CHAR,0,comm);
+  if (me) FFTW_API(import_wisdom_from_string)(wisdom);
+  free(wisdom);
+
+  free(wisdom_file);
+  wisdom_file = (char *) malloc(strlen(file)+1);
+  strcpy(wisdom_file,file);
+#endif
+  return 1;
+}
+
+/* ----------------------------------------------------------------------
+   merge FFTW wisdom of all procs on proc 0 and write it to file
+   procs have different # of 1d FFTs per dim and thus different wisdom
+   nothing is written if no proc planned new FFTs since the last export
+   return 1 on success, 0 if the file could not be written
+   no-op for other FFT libraries
+------------------------------------------------------------------------- */
+
+int fft_3d_export_wisdom(MPI_Comm comm, const char *file)
+{
+#if defined(FFT_FFTW3)
+  int me,nprocs,flag,n,ntotal;
+  int *recvcounts,*displs;
+  char *wisdom,*all;
+
+  MPI_Allreduce(&wisdom_new,&flag,1,MPI_INT,MPI_MAX,comm);
+  wisdom_new = 0;
+  if (!flag) return 1;
+
+  MPI_Comm_rank(comm,&me);
+  MPI_Comm_size(comm,&nprocs);
+
+  wisdom = FFTW_API(export_wisdom_to_string)();
+  n = strlen(wisdom) + 1;
+
+  recvcounts = displs = nullptr;
+  all = nullptr;
+  if (me == 0) {
+    recvcounts = (int *) malloc(nprocs*sizeof(int));
+    displs = (int *) malloc(nprocs*sizeof(int));
+  }
+  MPI_Gather(&n,1,MPI_INT,recvcounts,1,MPI_INT,0,comm);
+  if (me == 0) {
+    ntotal = 0;
+    for (int i = 0; i < nprocs; i++) {
+      displs[i] = ntotal;
+      ntotal += recvcounts[i];
+    }
+    all = (char *) malloc(ntotal);
+  }
+  MPI_Gatherv(wisdom,n,MPI_CHAR,all,recvcounts,displs,MPI_CHAR,0,comm);
+  free(wisdom);
+
+  flag = 0;
+  if (me == 0) {
+    for (int i = 1; i < nprocs; i++)
+      FFTW_API(import_wisdom_from_string)(&all[displs[i]]);
+    flag = FFTW_API(export_wisdom_to_filename)(file);
+    free(all);
+    free(recvcounts);
+    free(displs);
+  }
+  MPI_Bcast(&flag,1,MPI_INT,0,comm);
+
+  // wisdom in file is now identical to the one in memory
+
+  if (flag) {
+    free(wisdom_file);
+    wisdom_file = (char *) malloc(strlen(file)+1);
+    strcpy(wisdom_file,file);
+  }
+  return flag;
+#else
+  return 1;
+#endif
+}
@@ -142,6 +142,10 @@ struct fft_plan_3d {
 #endif
 };
 
+// planner effort for 1d FFTs, only used by FFTW3
+
+enum{FFT_PLAN_ESTIMATE,FFT_PLAN_MEASURE,FFT_PLAN_PATIENT,FFT_PLAN_EXHAUSTIVE};
+
 // function prototypes
 
 extern "C" {
@@ -149,8 +153,11 @@ extern "C" {
   struct fft_plan_3d *fft_3d_create_plan(MPI_Comm, int, int, int,
                                          int, int, int, int, int,
                                          int, int, int, int, int, int, int,
-                                         int, int, int *, int);
+                                         int, int, int *, int, int);
   void fft_3d_destroy_plan(struct fft_plan_3d *);
+  void fft_3d_clear_cache();
+  int fft_3d_import_wisdom(MPI_Comm, const char *);
+  int fft_3d_export_wisdom(MPI_Comm, const char *);
   void factor(int, int *, int *);
   void bifactor(int, int *, int *);
   void fft_1d_only(FFT_DATA *, int, int, struct fft_plan_3d *);
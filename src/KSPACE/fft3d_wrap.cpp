@@ -24,13 +24,27 @@ FFT3d::FFT3d(LAMMPS *lmp, MPI_Comm comm, int nfast, int nmid, int nslow,
              int in_klo, int in_khi,
              int out_ilo, int out_ihi, int out_jlo, int out_jhi,
              int out_klo, int out_khi,
-             int scaled, int permute, int *nbuf, int usecollective) : Pointers(lmp)
+             int scaled, int permute, int *nbuf, int usecollective,
+             int plantype, const char *wisdom) : Pointers(lmp)
 {
+  // previously saved wisdom makes measured FFTW plans cheap to create
+  // a missing wisdom file is not an error, it is written below
+
+  if (wisdom) fft_3d_import_wisdom(comm,wisdom);
+
   plan = fft_3d_create_plan(comm,nfast,nmid,nslow,
                             in_ilo,in_ihi,in_jlo,in_jhi,in_klo,in_khi,
                             out_ilo,out_ihi,out_jlo,out_jhi,out_klo,out_khi,
-                            scaled,permute,nbuf,usecollective);
+                            scaled,permute,nbuf,usecollective,plantype);
   if (plan == nullptr) error->one(FLERR,"Could not create 3d FFT plan");
+
+  if (wisdom && !fft_3d_export_wisdom(comm,wisdom)) {
+    int me;
+    MPI_Comm_rank(comm,&me);
+    if (me == 0)
+      error->warning(FLERR,fmt::format("Could not write FFTW wisdom file {}",
+                                       wisdom));
+  }
 }
 
 /* ---------------------------------------------------------------------- */
@@ -24,7 +24,8 @@ class FFT3d : protected Pointers {
   enum{FORWARD=1,BACKWARD=-1};
 
   FFT3d(class LAMMPS *, MPI_Comm,int,int,int,int,int,int,int,int,int,
-        int,int,int,int,int,int,int,int,int *,int);
+        int,int,int,int,int,int,int,int,int *,int,
+        int plantype = FFT_PLAN_ESTIMATE, const char *wisdom = nullptr);
   ~FFT3d();
   void compute(FFT_SCALAR *, FFT_SCALAR *, int);
   void timing1d(FFT_SCALAR *, int, int);
@@ -45,4 +46,9 @@ The FFT setup for the PPPM solver failed, typically due
 to lack of memory.  This is an unusual error.  Check the
 size of the FFT grid you are requesting.
 
+W: Could not write FFTW wisdom file {}
+
+The planner results of the FFTW library could not be saved, so they
+will be computed again when the same FFT is planned in a new LAMMPS run.
+
 */
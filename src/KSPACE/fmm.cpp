@@ -0,0 +1,1054 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://lammps.sandia.gov/, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------
+   Fast multipole method for the complete Coulomb interaction with free,
+   periodic, and mixed boundary conditions.  Uses complex scaled solid
+   harmonics R_lm, I_lm (see Helgaker, Jorgensen, Olsen, "Molecular
+   Electronic-Structure Theory", ch. 9.13) on a uniform octree.  Periodic
+   images beyond the nearest ones are included by a renormalization
+   lattice sum over 3x3x3 supercells (Lambert, Darden, Board, J Comput
+   Phys, 126, 274 (1996)).
+------------------------------------------------------------------------- */
+
+#include "fmm.h"
+
+#include "atom.h"
+#include "comm.h"
+#include "domain.h"
+#include "error.h"
+#include "force.h"
+#include "math_const.h"
+#include "memory.h"
+#include "pair.h"
+
+#include <cmath>
+#include <cstring>
+
+using namespace LAMMPS_NS;
+using namespace MathConst;
+
+#define SMALL 0.00001
+#define BIG 1.0e20
+#define MAXORDER 30
+#define MAXLEVELS 8
+#define NLATTICE 10
+#define LEAFATOMS 32
+
+/* ---------------------------------------------------------------------- */
+
+FMM::FMM(LAMMPS *lmp) : KSpace(lmp),
+  celloffset(nullptr), cellcount(nullptr), cellneed(nullptr),
+  mpole(nullptr), local(nullptr), rwork(nullptr), iwork(nullptr),
+  mwork(nullptr), shift_r(nullptr), shift_i(nullptr),
+  lattice_m2m(nullptr), lattice_m2l(nullptr), recvcounts(nullptr),
+  displs(nullptr), xq(nullptr), leafatoms(nullptr), leafstart(nullptr),
+  myleaf(nullptr), phi(nullptr), efield(nullptr)
+{
+  MPI_Comm_rank(world,&me);
+  MPI_Comm_size(world,&nprocs);
+
+  accuracy_relative = 0.0;
+  order_user = -1;
+  levels_user = -1;
+  levels = 0;
+  ncell = 0;
+  nterms = nterms2 = 0;
+  nlattice = 0;
+  nall = maxall = 0;
+  maxlocal = 0;
+  surface[0] = surface[1] = surface[2] = 0.0;
+
+  recvcounts = new int[nprocs];
+  displs = new int[nprocs];
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FMM::settings(int narg, char **arg)
+{
+  if (narg != 1) error->all(FLERR,"Illegal kspace_style fmm command");
+  accuracy_relative = fabs(utils::numeric(FLERR,arg[0],false,lmp));
+}
+
+/* ----------------------------------------------------------------------
+   free all memory
+------------------------------------------------------------------------- */
+
+FMM::~FMM()
+{
+  deallocate();
+  delete [] recvcounts;
+  delete [] displs;
+  memory->destroy(xq);
+  memory->destroy(leafatoms);
+  memory->destroy(myleaf);
+  memory->destroy(phi);
+  memory->destroy(efield);
+}
+
+/* ----------------------------------------------------------------------
+   called once before run
+------------------------------------------------------------------------- */
+
+void FMM::init()
+{
+  if (me == 0) utils::logmesg(lmp,"FMM initialization ...\n");
+
+  // error check
+
+  if (domain->dimension == 2)
+    error->all(FLERR,"Cannot use kspace_style fmm with 2d simulation");
+  if (domain->triclinic)
+    error->all(FLERR,"Cannot use kspace_style fmm with triclinic box");
+  if (!atom->q_flag) error->all(FLERR,"Kspace style requires atom attribute q");
+  if (atom->natoms > MAXSMALLINT/4)
+    error->all(FLERR,"Kspace style fmm atom count exceeds 2B");
+
+  // all Coulomb interactions are computed here, so the pair style
+  // must not have any
+
+  pair_check();
+  int itmp;
+  if (force->pair->extract("cut_coul",itmp))
+    error->all(FLERR,"Kspace style fmm requires a pair style "
+               "without Coulomb interactions");
+
+  two_charge();
+  scale = 1.0;
+  qqrd2e = force->qqrd2e;
+
+  // a net charge is fine for free boundaries, so do not warn
+
+  qsum_qsq(0);
+  natoms_original = atom->natoms;
+
+  periodicity[0] = domain->xperiodic;
+  periodicity[1] = domain->yperiodic;
+  periodicity[2] = domain->zperiodic;
+  nperiodic = periodicity[0] + periodicity[1] + periodicity[2];
+
+  if (nperiodic && fabs(qsum) > SMALL)
+    error->all(FLERR,"Kspace style fmm requires a charge neutral system "
+               "with periodic boundaries");
+  if (nperiodic && me == 0)
+    error->warning(FLERR,"FMM virial tensor with periodic boundaries "
+                   "is approximated as isotropic");
+
+  // set accuracy (force units) from accuracy_relative or accuracy_absolute
+
+  if (accuracy_absolute >= 0.0) accuracy = accuracy_absolute;
+  else accuracy = accuracy_relative * two_charge_force;
+  if (accuracy <= 0.0) error->all(FLERR,"KSpace accuracy must be > 0");
+
+  choose_parameters();
+  setup();
+
+  // stats
+
+  if (me == 0) {
+    std::string mesg = fmt::format("  expansion order = {}\n",order);
+    mesg += fmt::format("  tree levels = {}, leaf cells = {}\n",
+                        levels,1 << (3*levels));
+    mesg += fmt::format("  requested relative force accuracy = {:.8g}\n",
+                        accuracy/two_charge_force);
+    if (nperiodic)
+      mesg += fmt::format("  periodic lattice sum supercell levels = {}\n",
+                          nlattice);
+    utils::logmesg(lmp,mesg);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   choose expansion order and tree depth, unless set by kspace_modify.
+   the truncation error of a multipole to local translation between two
+   well separated cells decays roughly as 0.5^(order+1); the prefactor
+   was calibrated against direct sums for dense ionic systems.  with
+   periodic images the lattice sum converges more slowly, about 0.78^order
+   for higher orders, as calibrated against Ewald sums.  the work is
+   balanced between the near and far field with a few dozen atoms per leaf
+------------------------------------------------------------------------- */
+
+void FMM::choose_parameters()
+{
+  if (order_user > 0) order = order_user;
+  else {
+    const double relative = accuracy/two_charge_force;
+    order = static_cast<int> (ceil(log(8.0*relative)/log(0.5)));
+    if (nperiodic)
+      order = MAX(order,
+                  static_cast<int> (ceil(log(relative/5.0e-4)/log(0.78))));
+    order = MAX(order,2);
+    order = MIN(order,MAXORDER);
+  }
+
+  if (levels_user >= 0) levels = levels_user;
+  else {
+    levels = 0;
+    bigint nleaf = 1;
+    while (levels < MAXLEVELS-2 && 8*nleaf*LEAFATOMS <= atom->natoms) {
+      levels++;
+      nleaf *= 8;
+    }
+  }
+
+  deallocate();
+  allocate();
+}
+
+/* ----------------------------------------------------------------------
+   allocate memory that depends on expansion order and tree depth
+------------------------------------------------------------------------- */
+
+void FMM::allocate()
+{
+  nterms = (order+1)*(order+2)/2;
+  nterms2 = (2*order+1)*(2*order+2)/2;
+
+  celloffset = new int[levels+2];
+  ncell = 0;
+  for (int l = 0; l <= levels; l++) {
+    celloffset[l] = ncell;
+    ncell += 1 << (3*l);
+  }
+  celloffset[levels+1] = ncell;
+
+  memory->create(cellcount,ncell,"fmm:cellcount");
+  memory->create(cellneed,ncell,"fmm:cellneed");
+  memory->create(leafstart,(1 << (3*levels))+1,"fmm:leafstart");
+
+  mpole = new cplx[(bigint)ncell*nterms];
+  local = new cplx[(bigint)ncell*nterms];
+  rwork = new cplx[nterms2];
+  iwork = new cplx[nterms2];
+  mwork = new cplx[2*nterms];
+  shift_r = new cplx[8*nterms];
+  shift_i = new cplx[343*nterms2];
+
+  nlattice = NLATTICE;
+  lattice_m2m = new cplx[nlattice*nterms];
+  lattice_m2l = new cplx[nlattice*nterms2];
+}
+
+/* ----------------------------------------------------------------------
+   deallocate memory that depends on expansion order and tree depth
+------------------------------------------------------------------------- */
+
+void FMM::deallocate()
+{
+  delete [] celloffset;
+  memory->destroy(cellcount);
+  memory->destroy(cellneed);
+  memory->destroy(leafstart);
+  delete [] mpole;
+  delete [] local;
+  delete [] rwork;
+  delete [] iwork;
+  delete [] mwork;
+  delete [] shift_r;
+  delete [] shift_i;
+  delete [] lattice_m2m;
+  delete [] lattice_m2l;
+
+  celloffset = nullptr;
+  cellcount = cellneed = leafstart = nullptr;
+  mpole = local = rwork = iwork = mwork = nullptr;
+  shift_r = shift_i = lattice_m2m = lattice_m2l = nullptr;
+}
+
+/* ----------------------------------------------------------------------
+   adjust box dependent settings, called initially and whenever the
+   volume has changed: translation operators for the periodic lattice sum
+------------------------------------------------------------------------- */
+
+void FMM::setup()
+{
+  const double * const prd = domain->prd;
+  volume = prd[0]*prd[1]*prd[2];
+
+  if (!nperiodic) return;
+
+  // supercell k is made of 3x3x3 supercells of level k-1 in the periodic
+  // dims, supercell 0 is the simulation box.  the shell of supercells of
+  // level k between the 3x3x3 and 9x9x9 block around the box interacts
+  // with the box through the multipole expansion of supercell k.
+  // lattice_m2m sums the translations of the 27 sub-supercells to the
+  // supercell center, lattice_m2l sums the interactions with the shell.
+
+  int lo[3],hi[3];
+  for (int d = 0; d < 3; d++) {
+    lo[d] = periodicity[d] ? -4 : 0;
+    hi[d] = periodicity[d] ? 4 : 0;
+  }
+
+  double width[3],dx[3];
+  for (int d = 0; d < 3; d++) width[d] = periodicity[d] ? prd[d] : 0.0;
+
+  for (int k = 0; k < nlattice; k++) {
+    cplx *sum_r = lattice_m2m + k*nterms;
+    cplx *sum_i = lattice_m2l + k*nterms2;
+    for (int n = 0; n < nterms; n++) sum_r[n] = 0.0;
+    for (int n = 0; n < nterms2; n++) sum_i[n] = 0.0;
+
+    for (int iz = lo[2]; iz <= hi[2]; iz++)
+      for (int iy = lo[1]; iy <= hi[1]; iy++)
+        for (int ix = lo[0]; ix <= hi[0]; ix++) {
+          dx[0] = ix*width[0];
+          dx[1] = iy*width[1];
+          dx[2] = iz*width[2];
+          if (abs(ix) <= 1 && abs(iy) <= 1 && abs(iz) <= 1) {
+            regular(dx,rwork,order);
+            for (int n = 0; n < nterms; n++) sum_r[n] += rwork[n];
+          } else {
+            dx[0] = -dx[0];
+            dx[1] = -dx[1];
+            dx[2] = -dx[2];
+            irregular(dx,iwork,2*order);
+            for (int n = 0; n < nterms2; n++) sum_i[n] += iwork[n];
+          }
+        }
+
+    for (int d = 0; d < 3; d++) width[d] *= 3.0;
+  }
+
+  // the lattice sum in expanding rectangular shells converges to the
+  // result for a box surrounded by vacuum.  it differs from the Ewald
+  // sum with conducting (tinfoil) boundary conditions by a term that
+  // is quadratic in the box dipole.  its coefficients are the solid
+  // angles of the faces of a rectangular prism seen from its center.
+
+  surface[0] = surface[1] = surface[2] = 0.0;
+  if (nperiodic == 3) {
+    const double diag = sqrt(prd[0]*prd[0] + prd[1]*prd[1] + prd[2]*prd[2]);
+    for (int d = 0; d < 3; d++) {
+      const double a = prd[(d+1)%3];
+      const double b = prd[(d+2)%3];
+      surface[d] = 4.0*atan(a*b/(prd[d]*diag)) / volume;
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   compute the complete Coulomb force, energy, virial
+------------------------------------------------------------------------- */
+
+void FMM::compute(int eflag, int vflag)
+{
+  // set energy/virial flags
+
+  ev_init(eflag,vflag);
+
+  if (vflag_atom)
+    error->all(FLERR,"Kspace style fmm does not support per-atom virial");
+
+  // if atom count has changed, update qsum and qsqsum
+
+  if (atom->natoms != natoms_original) {
+    qsum_qsq(0);
+    natoms_original = atom->natoms;
+  }
+
+  // return if there are no charges
+
+  if (qsqsum == 0.0) return;
+
+  const int nlocal = atom->nlocal;
+  if (atom->nmax > maxlocal) {
+    memory->destroy(myleaf);
+    memory->destroy(phi);
+    memory->destroy(efield);
+    maxlocal = atom->nmax;
+    memory->create(myleaf,maxlocal,"fmm:myleaf");
+    memory->create(phi,maxlocal,"fmm:phi");
+    memory->create(efield,maxlocal,3,"fmm:efield");
+  }
+
+  gather_atoms();
+  build_tree();
+  upward_pass();
+  downward_pass();
+  evaluate();
+
+  if (atom->molecular != Atom::ATOMIC) special_correction();
+  if (nperiodic == 3) dipole_correction();
+
+  // apply the electric field to my atoms, accumulate energy and virial
+
+  const double qscale = qqrd2e * scale;
+  const double * const q = atom->q;
+  double ** const x = atom->x;
+  double ** const f = atom->f;
+  double eng = 0.0;
+  double vir[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+
+  for (int i = 0; i < nlocal; i++) {
+    const double qone = qscale*q[i];
+    const double fx = qone*efield[i][0];
+    const double fy = qone*efield[i][1];
+    const double fz = qone*efield[i][2];
+    f[i][0] += fx;
+    f[i][1] += fy;
+    f[i][2] += fz;
+    eng += 0.5*qone*phi[i];
+    if (eflag_atom) eatom[i] += 0.5*qone*phi[i];
+    if (vflag_global && !nperiodic) {
+      vir[0] += x[i][0]*fx;
+      vir[1] += x[i][1]*fy;
+      vir[2] += x[i][2]*fz;
+      vir[3] += x[i][0]*fy;
+      vir[4] += x[i][0]*fz;
+      vir[5] += x[i][1]*fz;
+    }
+  }
+
+  if (eflag_global || (vflag_global && nperiodic))
+    MPI_Allreduce(&eng,&energy,1,MPI_DOUBLE,MPI_SUM,world);
+
+  // with periodic boundaries, the trace of the Coulomb virial equals the
+  // energy but the per-atom r*f sum is not translation invariant
+
+  if (vflag_global) {
+    if (nperiodic) {
+      for (int i = 0; i < 3; i++) virial[i] = energy/3.0;
+      for (int i = 3; i < 6; i++) virial[i] = 0.0;
+    } else MPI_Allreduce(vir,virial,6,MPI_DOUBLE,MPI_SUM,world);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   collect coordinates and charges of all atoms on all procs
+   coordinates are remapped into the periodic box
+------------------------------------------------------------------------- */
+
+void FMM::gather_atoms()
+{
+  const int nlocal = atom->nlocal;
+  double ** const x = atom->x;
+  const double * const q = atom->q;
+
+  MPI_Allgather(&nlocal,1,MPI_INT,recvcounts,1,MPI_INT,world);
+  nall = 0;
+  for (int iproc = 0; iproc < nprocs; iproc++) {
+    displs[iproc] = 4*nall;
+    nall += recvcounts[iproc];
+    recvcounts[iproc] *= 4;
+  }
+
+  if (nall > maxall) {
+    memory->destroy(xq);
+    memory->destroy(leafatoms);
+    maxall = nall;
+    memory->create(xq,4*maxall,"fmm:xq");
+    memory->create(leafatoms,maxall,"fmm:leafatoms");
+  }
+
+  double *xqme = xq + displs[me];
+  for (int i = 0; i < nlocal; i++) {
+    xqme[4*i+0] = x[i][0];
+    xqme[4*i+1] = x[i][1];
+    xqme[4*i+2] = x[i][2];
+    if (nperiodic) domain->remap(&xqme[4*i]);
+    xqme[4*i+3] = q[i];
+  }
+
+  MPI_Allgatherv(MPI_IN_PLACE,0,MPI_DATATYPE_NULL,xq,recvcounts,displs,
+                 MPI_DOUBLE,world);
+}
+
+/* ----------------------------------------------------------------------
+   set the root cell, sort all atoms into leaf cells and flag the cells
+   that hold my atoms, which are the only ones whose local expansions
+   are required on this proc
+------------------------------------------------------------------------- */
+
+void FMM::build_tree()
+{
+  // periodic dims span the box, free dims the extent of the atoms
+
+  double lo[3],hi[3];
+  lo[0] = lo[1] = lo[2] = BIG;
+  hi[0] = hi[1] = hi[2] = -BIG;
+  for (int i = 0; i < nall; i++)
+    for (int d = 0; d < 3; d++) {
+      lo[d] = MIN(lo[d],xq[4*i+d]);
+      hi[d] = MAX(hi[d],xq[4*i+d]);
+    }
+
+  double maxlen = 0.0;
+  for (int d = 0; d < 3; d++)
+    if (periodicity[d]) maxlen = MAX(maxlen,domain->prd[d]);
+    else maxlen = MAX(maxlen,hi[d]-lo[d]);
+  if (maxlen == 0.0) maxlen = 1.0;
+
+  for (int d = 0; d < 3; d++) {
+    if (periodicity[d]) {
+      rootlo[d] = domain->boxlo[d];
+      rootlen[d] = domain->prd[d];
+    } else {
+      // use a cube for free boundaries, pad so the extremal atoms are inside
+      double len = (nperiodic == 0) ? maxlen : hi[d]-lo[d];
+      len = MAX(len,SMALL*maxlen) * (1.0 + SMALL);
+      rootlo[d] = 0.5*(lo[d]+hi[d]) - 0.5*len;
+      rootlen[d] = len;
+    }
+  }
+
+  // bin all atoms into leaf cells with a counting sort
+
+  const int nc = 1 << levels;
+  const int nleaf = nc*nc*nc;
+  int *leafcount = cellcount + celloffset[levels];
+
+  for (int n = 0; n < ncell; n++) cellcount[n] = 0;
+
+  for (int i = 0; i < nall; i++) {
+    int c[3];
+    for (int d = 0; d < 3; d++) {
+      c[d] = static_cast<int> ((xq[4*i+d]-rootlo[d])/rootlen[d] * nc);
+      c[d] = MAX(c[d],0);
+      c[d] = MIN(c[d],nc-1);
+    }
+    leafatoms[i] = (c[2]*nc + c[1])*nc + c[0];
+    leafcount[leafatoms[i]]++;
+  }
+
+  const int myfirst = displs[me]/4;
+  const int nlocal = atom->nlocal;
+  for (int i = 0; i < nlocal; i++) myleaf[i] = leafatoms[myfirst+i];
+
+  leafstart[0] = 0;
+  for (int n = 0; n < nleaf; n++) leafstart[n+1] = leafstart[n] + leafcount[n];
+
+  // reuse leafstart as insertion pointer, then shift it back
+
+  int *cell = new int[nall];
+  for (int i = 0; i < nall; i++) cell[i] = leafatoms[i];
+  for (int i = 0; i < nall; i++) leafatoms[leafstart[cell[i]]++] = i;
+  for (int n = nleaf; n > 0; n--) leafstart[n] = leafstart[n-1];
+  leafstart[0] = 0;
+  delete [] cell;
+
+  // accumulate atom counts in coarser levels
+
+  for (int l = levels; l > 0; l--) {
+    const int ncl = 1 << l;
+    for (int iz = 0; iz < ncl; iz++)
+      for (int iy = 0; iy < ncl; iy++)
+        for (int ix = 0; ix < ncl; ix++) {
+          const int child = celloffset[l] + (iz*ncl + iy)*ncl + ix;
+          const int parent = celloffset[l-1] +
+            ((iz/2)*(ncl/2) + iy/2)*(ncl/2) + ix/2;
+          cellcount[parent] += cellcount[child];
+        }
+  }
+
+  // flag leaves with my atoms and all their ancestors
+
+  for (int n = 0; n < ncell; n++) cellneed[n] = 0;
+  for (int i = 0; i < nlocal; i++) {
+    int ix = myleaf[i] % nc;
+    int iy = (myleaf[i] / nc) % nc;
+    int iz = myleaf[i] / (nc*nc);
+    for (int l = levels; l >= 0; l--) {
+      const int ncl = 1 << l;
+      cellneed[celloffset[l] + (iz*ncl + iy)*ncl + ix] = 1;
+      ix /= 2;
+      iy /= 2;
+      iz /= 2;
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   center of cell (ix,iy,iz) on level l, indices may be outside of the
+   root cell for periodic images
+------------------------------------------------------------------------- */
+
+void FMM::cell_center(int l, int ix, int iy, int iz, double *center)
+{
+  const double inv = 1.0 / (1 << l);
+  center[0] = rootlo[0] + (ix + 0.5)*rootlen[0]*inv;
+  center[1] = rootlo[1] + (iy + 0.5)*rootlen[1]*inv;
+  center[2] = rootlo[2] + (iz + 0.5)*rootlen[2]*inv;
+}
+
+/* ----------------------------------------------------------------------
+   multipole expansions of my atoms, translated up the tree and summed
+   over all procs
+------------------------------------------------------------------------- */
+
+void FMM::upward_pass()
+{
+  const int nlocal = atom->nlocal;
+  const int myfirst = displs[me]/4;
+  const int nc = 1 << levels;
+
+  for (bigint n = 0; n < (bigint)ncell*nterms; n++) mpole[n] = 0.0;
+
+  // P2M: expand my atoms about the centers of their leaf cells
+
+  double center[3],dx[3];
+  for (int i = 0; i < nlocal; i++) {
+    const double * const xi = xq + 4*(myfirst+i);
+    const int leaf = myleaf[i];
+    cell_center(levels,leaf % nc,(leaf/nc) % nc,leaf/(nc*nc),center);
+    dx[0] = xi[0] - center[0];
+    dx[1] = xi[1] - center[1];
+    dx[2] = xi[2] - center[2];
+    regular(dx,rwork,order);
+    cplx *m = mpole + (bigint)(celloffset[levels] + leaf)*nterms;
+    for (int n = 0; n < nterms; n++) m[n] += xi[3]*std::conj(rwork[n]);
+  }
+
+  // M2M: translate to parent cells, the 8 child offsets of a level
+  // are tabulated once
+
+  for (int l = levels; l > 0; l--) {
+    const int ncl = 1 << l;
+    const double inv = 0.25 / (1 << (l-1));
+    for (int oct = 0; oct < 8; oct++) {
+      dx[0] = ((oct & 1) ? 1.0 : -1.0) * rootlen[0]*inv;
+      dx[1] = ((oct & 2) ? 1.0 : -1.0) * rootlen[1]*inv;
+      dx[2] = ((oct & 4) ? 1.0 : -1.0) * rootlen[2]*inv;
+      regular(dx,shift_r + oct*nterms,order);
+    }
+
+    for (int iz = 0; iz < ncl; iz++)
+      for (int iy = 0; iy < ncl; iy++)
+        for (int ix = 0; ix < ncl; ix++) {
+          const int child = celloffset[l] + (iz*ncl + iy)*ncl + ix;
+          if (!cellneed[child]) continue;
+          const int parent = celloffset[l-1] +
+            ((iz/2)*(ncl/2) + iy/2)*(ncl/2) + ix/2;
+          const int oct = (ix & 1) + 2*(iy & 1) + 4*(iz & 1);
+          m2m(mpole + (bigint)child*nterms,shift_r + oct*nterms,
+              mpole + (bigint)parent*nterms);
+        }
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE,mpole,2*ncell*nterms,MPI_DOUBLE,MPI_SUM,world);
+}
+
+/* ----------------------------------------------------------------------
+   local expansions of the cells that hold my atoms, from the lattice
+   sum, the parent cell and the interaction list
+------------------------------------------------------------------------- */
+
+void FMM::downward_pass()
+{
+  for (bigint n = 0; n < (bigint)ncell*nterms; n++) local[n] = 0.0;
+
+  if (nperiodic) lattice_sum();
+
+  double dx[3];
+  for (int l = 1; l <= levels; l++) {
+    const int ncl = 1 << l;
+    double width[3];
+    for (int d = 0; d < 3; d++) width[d] = rootlen[d]/ncl;
+
+    // tabulate L2L for the 8 child offsets and M2L for all 7x7x7
+    // offsets between well separated cells of this level
+
+    for (int oct = 0; oct < 8; oct++) {
+      dx[0] = ((oct & 1) ? 0.5 : -0.5) * width[0];
+      dx[1] = ((oct & 2) ? 0.5 : -0.5) * width[1];
+      dx[2] = ((oct & 4) ? 0.5 : -0.5) * width[2];
+      regular(dx,shift_r + oct*nterms,order);
+    }
+    for (int oz = -3; oz <= 3; oz++)
+      for (int oy = -3; oy <= 3; oy++)
+        for (int ox = -3; ox <= 3; ox++) {
+          if (abs(ox) <= 1 && abs(oy) <= 1 && abs(oz) <= 1) continue;
+          dx[0] = -ox*width[0];
+          dx[1] = -oy*width[1];
+          dx[2] = -oz*width[2];
+          irregular(dx,shift_i + (((oz+3)*7 + oy+3)*7 + ox+3)*nterms2,
+                    2*order);
+        }
+
+    int t[3],p[3],s[3],w[3];
+    for (t[2] = 0; t[2] < ncl; t[2]++)
+      for (t[1] = 0; t[1] < ncl; t[1]++)
+        for (t[0] = 0; t[0] < ncl; t[0]++) {
+          const int target = celloffset[l] + (t[2]*ncl + t[1])*ncl + t[0];
+          if (!cellneed[target]) continue;
+          cplx *lt = local + (bigint)target*nterms;
+
+          // L2L from parent
+
+          const int parent = celloffset[l-1] +
+            ((t[2]/2)*(ncl/2) + t[1]/2)*(ncl/2) + t[0]/2;
+          const int oct = (t[0] & 1) + 2*(t[1] & 1) + 4*(t[2] & 1);
+          l2l(local + (bigint)parent*nterms,shift_r + oct*nterms,lt);
+
+          // M2L from children of the parent's neighbors that are not
+          // neighbors themselves, periodic images are wrapped around
+
+          int plo[3],phi_[3];
+          for (int d = 0; d < 3; d++) {
+            p[d] = t[d]/2;
+            plo[d] = p[d]-1;
+            phi_[d] = p[d]+1;
+            if (!periodicity[d]) {
+              plo[d] = MAX(plo[d],0);
+              phi_[d] = MIN(phi_[d],ncl/2-1);
+            }
+          }
+
+          for (s[2] = 2*plo[2]; s[2] <= 2*phi_[2]+1; s[2]++)
+            for (s[1] = 2*plo[1]; s[1] <= 2*phi_[1]+1; s[1]++)
+              for (s[0] = 2*plo[0]; s[0] <= 2*phi_[0]+1; s[0]++) {
+                if (abs(s[0]-t[0]) <= 1 && abs(s[1]-t[1]) <= 1 &&
+                    abs(s[2]-t[2]) <= 1) continue;
+                for (int d = 0; d < 3; d++) w[d] = (s[d] + ncl) % ncl;
+                const int source = celloffset[l] + (w[2]*ncl + w[1])*ncl + w[0];
+                if (!cellcount[source]) continue;
+                const int o = ((s[2]-t[2]+3)*7 + s[1]-t[1]+3)*7 + s[0]-t[0]+3;
+                m2l(mpole + (bigint)source*nterms,shift_i + o*nterms2,lt);
+              }
+        }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   local expansion of the root cell due to all periodic images outside
+   of the 3x3x3 block of images around the box
+------------------------------------------------------------------------- */
+
+void FMM::lattice_sum()
+{
+  cplx *msuper = mwork;
+  cplx *mnext = mwork + nterms;
+  for (int n = 0; n < nterms; n++) msuper[n] = mpole[n];
+
+  for (int k = 0; k < nlattice; k++) {
+    m2l(msuper,lattice_m2l + k*nterms2,local);
+    for (int n = 0; n < nterms; n++) mnext[n] = 0.0;
+    m2m(msuper,lattice_m2m + k*nterms,mnext);
+    for (int n = 0; n < nterms; n++) msuper[n] = mnext[n];
+  }
+}
+
+/* ----------------------------------------------------------------------
+   potential and field at my atoms from the local expansion of their
+   leaf cell (L2P) and direct sums over the neighboring leaves (P2P)
+------------------------------------------------------------------------- */
+
+void FMM::evaluate()
+{
+  const int nlocal = atom->nlocal;
+  const int myfirst = displs[me]/4;
+  const int nc = 1 << levels;
+
+  double center[3],dx[3],grad[3];
+  for (int i = 0; i < nlocal; i++) {
+    const double * const xi = xq + 4*(myfirst+i);
+    const int leaf = myleaf[i];
+    cell_center(levels,leaf % nc,(leaf/nc) % nc,leaf/(nc*nc),center);
+    dx[0] = xi[0] - center[0];
+    dx[1] = xi[1] - center[1];
+    dx[2] = xi[2] - center[2];
+    regular(dx,rwork,order);
+
+    // phi = sum_jk L_jk conj(R_jk), with dR_jk/dz = R_j-1,k and
+    // (d/dx +- i d/dy) R_jk = +- R_j-1,k+-1
+
+    const cplx *lc = local + (bigint)(celloffset[levels] + leaf)*nterms;
+    double pot = 0.0;
+    grad[0] = grad[1] = grad[2] = 0.0;
+    for (int j = 0; j <= order; j++) {
+      for (int k = -j; k <= j; k++) {
+        const cplx ljk = coeff(lc,j,k);
+        pot += std::real(ljk*std::conj(coeff(rwork,j,k)));
+        if (j == 0) continue;
+        const cplx rp = (k+1 <= j-1) ? coeff(rwork,j-1,k+1) : cplx(0.0);
+        const cplx rm = (k-1 >= -(j-1)) ? coeff(rwork,j-1,k-1) : cplx(0.0);
+        const cplx rz = (abs(k) <= j-1) ? coeff(rwork,j-1,k) : cplx(0.0);
+        const cplx drx = 0.5*(rp - rm);
+        const cplx dry = cplx(0.0,-0.5)*(rp + rm);
+        grad[0] += std::real(ljk*std::conj(drx));
+        grad[1] += std::real(ljk*std::conj(dry));
+        grad[2] += std::real(ljk*std::conj(rz));
+      }
+    }
+
+    phi[i] = pot;
+    efield[i][0] = -grad[0];
+    efield[i][1] = -grad[1];
+    efield[i][2] = -grad[2];
+
+    near_field(i,efield[i],phi[i]);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   direct sum over all atoms in the leaf of my atom i and its neighbor
+   leaves, including periodic images
+------------------------------------------------------------------------- */
+
+void FMM::near_field(int i, double *field, double &pot)
+{
+  const int nc = 1 << levels;
+  const int me_i = displs[me]/4 + i;
+  const double * const xi = xq + 4*me_i;
+  const int leaf = myleaf[i];
+  int t[3],s[3],w[3],lo[3],hi[3];
+  t[0] = leaf % nc;
+  t[1] = (leaf/nc) % nc;
+  t[2] = leaf/(nc*nc);
+
+  for (int d = 0; d < 3; d++) {
+    lo[d] = t[d]-1;
+    hi[d] = t[d]+1;
+    if (!periodicity[d]) {
+      lo[d] = MAX(lo[d],0);
+      hi[d] = MIN(hi[d],nc-1);
+    }
+  }
+
+  double shift[3];
+  double ex = 0.0, ey = 0.0, ez = 0.0, sum = 0.0;
+  for (s[2] = lo[2]; s[2] <= hi[2]; s[2]++)
+    for (s[1] = lo[1]; s[1] <= hi[1]; s[1]++)
+      for (s[0] = lo[0]; s[0] <= hi[0]; s[0]++) {
+        for (int d = 0; d < 3; d++) {
+          w[d] = (s[d] + nc) % nc;
+          shift[d] = ((s[d] - w[d]) / nc) * rootlen[d];
+        }
+        const int self = (s[0] == t[0] && s[1] == t[1] && s[2] == t[2]);
+        const int source = (w[2]*nc + w[1])*nc + w[0];
+        for (int n = leafstart[source]; n < leafstart[source+1]; n++) {
+          const int j = leafatoms[n];
+          if (self && j == me_i) continue;
+          const double * const xj = xq + 4*j;
+          const double delx = xi[0] - xj[0] - shift[0];
+          const double dely = xi[1] - xj[1] - shift[1];
+          const double delz = xi[2] - xj[2] - shift[2];
+          const double rinv = 1.0/sqrt(delx*delx + dely*dely + delz*delz);
+          const double qr = xj[3]*rinv;
+          const double qr3 = qr*rinv*rinv;
+          sum += qr;
+          ex += delx*qr3;
+          ey += dely*qr3;
+          ez += delz*qr3;
+        }
+      }
+
+  pot += sum;
+  field[0] += ex;
+  field[1] += ey;
+  field[2] += ez;
+}
+
+/* ----------------------------------------------------------------------
+   remove the excluded or scaled part of the Coulomb interaction between
+   special neighbors, i.e. (1 - special_coul) q_j / r for the closest image
+------------------------------------------------------------------------- */
+
+void FMM::special_correction()
+{
+  const double * const special_coul = force->special_coul;
+  if (special_coul[1] == 1.0 && special_coul[2] == 1.0 &&
+      special_coul[3] == 1.0) return;
+
+  double ** const x = atom->x;
+  const double * const q = atom->q;
+  int ** const nspecial = atom->nspecial;
+  tagint ** const special = atom->special;
+  const int nlocal = atom->nlocal;
+
+  for (int i = 0; i < nlocal; i++) {
+    for (int k = 0; k < nspecial[i][2]; k++) {
+      double factor;
+      if (k < nspecial[i][0]) factor = special_coul[1];
+      else if (k < nspecial[i][1]) factor = special_coul[2];
+      else factor = special_coul[3];
+      if (factor == 1.0) continue;
+
+      int j = atom->map(special[i][k]);
+      if (j < 0) error->one(FLERR,"FMM special neighbor atom missing");
+      j = domain->closest_image(i,j);
+
+      const double delx = x[i][0] - x[j][0];
+      const double dely = x[i][1] - x[j][1];
+      const double delz = x[i][2] - x[j][2];
+      const double rinv = 1.0/sqrt(delx*delx + dely*dely + delz*delz);
+      const double qr = (1.0 - factor)*q[j]*rinv;
+      const double qr3 = qr*rinv*rinv;
+      phi[i] -= qr;
+      efield[i][0] -= delx*qr3;
+      efield[i][1] -= dely*qr3;
+      efield[i][2] -= delz*qr3;
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   convert the vacuum boundary of the 3d lattice sum to the conducting
+   boundary used by the Ewald and PPPM solvers: E -= sum_d surface_d D_d^2
+------------------------------------------------------------------------- */
+
+void FMM::dipole_correction()
+{
+  double dipole[3] = {0.0, 0.0, 0.0};
+  for (int i = 0; i < nall; i++) {
+    dipole[0] += xq[4*i+3]*xq[4*i+0];
+    dipole[1] += xq[4*i+3]*xq[4*i+1];
+    dipole[2] += xq[4*i+3]*xq[4*i+2];
+  }
+
+  const int nlocal = atom->nlocal;
+  const double * const xme = xq + displs[me];
+  for (int i = 0; i < nlocal; i++)
+    for (int d = 0; d < 3; d++) {
+      phi[i] -= 2.0*surface[d]*dipole[d]*xme[4*i+d];
+      efield[i][d] += 2.0*surface[d]*dipole[d];
+    }
+}
+
+/* ----------------------------------------------------------------------
+   scaled regular solid harmonics R_lm(x) for l <= p and m >= 0
+   R_00 = 1, R_ll = -(x+iy)/(2l) R_l-1,l-1,
+   R_lm = ((2l-1) z R_l-1,m - r^2 R_l-2,m) / ((l+m)(l-m))
+------------------------------------------------------------------------- */
+
+void FMM::regular(const double *x, cplx *r, int p)
+{
+  const double rsq = x[0]*x[0] + x[1]*x[1] + x[2]*x[2];
+  const cplx xy(x[0],x[1]);
+
+  r[0] = 1.0;
+  for (int m = 0; m <= p; m++) {
+    if (m > 0) r[idx(m,m)] = -xy/(2.0*m) * r[idx(m-1,m-1)];
+    if (m < p) r[idx(m+1,m)] = x[2]*r[idx(m,m)];
+    for (int l = m+2; l <= p; l++)
+      r[idx(l,m)] = ((2*l-1)*x[2]*r[idx(l-1,m)] - rsq*r[idx(l-2,m)]) /
+        static_cast<double>((l+m)*(l-m));
+  }
+}
+
+/* ----------------------------------------------------------------------
+   scaled irregular solid harmonics I_lm(x) for l <= p and m >= 0
+   I_00 = 1/r, I_ll = -(2l-1)(x+iy)/r^2 I_l-1,l-1,
+   I_lm = ((2l-1) z I_l-1,m - ((l-1)^2 - m^2) I_l-2,m) / r^2
+------------------------------------------------------------------------- */
+
+void FMM::irregular(const double *x, cplx *r, int p)
+{
+  const double rsqinv = 1.0/(x[0]*x[0] + x[1]*x[1] + x[2]*x[2]);
+  const cplx xy(x[0],x[1]);
+
+  r[0] = sqrt(rsqinv);
+  for (int m = 0; m <= p; m++) {
+    if (m > 0) r[idx(m,m)] = -(2.0*m-1.0)*rsqinv*xy * r[idx(m-1,m-1)];
+    if (m < p) r[idx(m+1,m)] = (2.0*m+1.0)*x[2]*rsqinv*r[idx(m,m)];
+    for (int l = m+2; l <= p; l++)
+      r[idx(l,m)] = ((2*l-1)*x[2]*r[idx(l-1,m)] -
+                     static_cast<double>((l-1)*(l-1) - m*m)*r[idx(l-2,m)]) *
+        rsqinv;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   translate multipole expansion mc about a child center to its parent
+   center, r holds R_lm(child - parent)
+   M_lm += sum_jk conj(R_jk) Mc_l-j,m-k
+------------------------------------------------------------------------- */
+
+void FMM::m2m(const cplx *mc, const cplx *r, cplx *mp)
+{
+  for (int l = 0; l <= order; l++)
+    for (int m = 0; m <= l; m++) {
+      cplx sum = 0.0;
+      for (int j = 0; j <= l; j++)
+        for (int k = -j; k <= j; k++) {
+          if (abs(m-k) > l-j) continue;
+          sum += std::conj(coeff(r,j,k)) * coeff(mc,l-j,m-k);
+        }
+      mp[idx(l,m)] += sum;
+    }
+}
+
+/* ----------------------------------------------------------------------
+   convert multipole expansion m into a local expansion, i holds
+   I_lm(target - source) up to order 2*order
+   L_jk += (-1)^j sum_lm M_lm I_l+j,m+k
+------------------------------------------------------------------------- */
+
+void FMM::m2l(const cplx *mp, const cplx *i, cplx *lc)
+{
+  for (int j = 0; j <= order; j++)
+    for (int k = 0; k <= j; k++) {
+      cplx sum = 0.0;
+      for (int l = 0; l <= order; l++)
+        for (int m = -l; m <= l; m++)
+          sum += coeff(mp,l,m) * coeff(i,l+j,m+k);
+      if (j & 1) lc[idx(j,k)] -= sum;
+      else lc[idx(j,k)] += sum;
+    }
+}
+
+/* ----------------------------------------------------------------------
+   translate local expansion lp about a parent center to a child center,
+   r holds R_lm(child - parent)
+   Lc_np += sum_st Lp_n+s,p+t conj(R_st)
+------------------------------------------------------------------------- */
+
+void FMM::l2l(const cplx *lp, const cplx *r, cplx *lc)
+{
+  for (int n = 0; n <= order; n++)
+    for (int p = 0; p <= n; p++) {
+      cplx sum = 0.0;
+      for (int s = 0; s <= order-n; s++)
+        for (int t = -s; t <= s; t++)
+          sum += coeff(lp,n+s,p+t) * std::conj(coeff(r,s,t));
+      lc[idx(n,p)] += sum;
+    }
+}
+
+/* ----------------------------------------------------------------------
+   kspace_modify fmm/order N and fmm/levels N
+------------------------------------------------------------------------- */
+
+int FMM::modify_param(int narg, char **arg)
+{
+  if (strcmp(arg[0],"fmm/order") == 0) {
+    if (narg < 2) error->all(FLERR,"Illegal kspace_modify command");
+    order_user = utils::inumeric(FLERR,arg[1],false,lmp);
+    if (order_user < 1 || order_user > MAXORDER)
+      error->all(FLERR,"FMM expansion order must be between 1 and 30");
+    return 2;
+  } else if (strcmp(arg[0],"fmm/levels") == 0) {
+    if (narg < 2) error->all(FLERR,"Illegal kspace_modify command");
+    levels_user = utils::inumeric(FLERR,arg[1],false,lmp);
+    if (levels_user < 0 || levels_user > MAXLEVELS)
+      error->all(FLERR,"FMM tree levels must be between 0 and 8");
+    return 2;
+  }
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   memory usage of local arrays
+------------------------------------------------------------------------- */
+
+double FMM::memory_usage()
+{
+  double bytes = 0.0;
+  bytes += (double)2*ncell*nterms * sizeof(cplx);
+  bytes += (double)(343+nlattice)*nterms2 * sizeof(cplx);
+  bytes += (double)2*ncell * sizeof(int);
+  bytes += (double)maxall * (4*sizeof(double) + sizeof(int));
+  bytes += (double)maxlocal * (4*sizeof(double) + sizeof(int));
+  return bytes;
+}
@@ -0,0 +1,173 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://lammps.sandia.gov/, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef KSPACE_CLASS
+
+KSpaceStyle(fmm,FMM)
+
+#else
+
+#ifndef LMP_FMM_H
+#define LMP_FMM_H
+
+#include "kspace.h"
+
+#include <complex>
+
+namespace LAMMPS_NS {
+
+class FMM : public KSpace {
+ public:
+  FMM(class LAMMPS *);
+  virtual ~FMM();
+  void init();
+  void setup();
+  void settings(int, char **);
+  void compute(int, int);
+  int modify_param(int, char **);
+  double memory_usage();
+
+ protected:
+  typedef std::complex<double> cplx;
+
+  int me,nprocs;
+  double qqrd2e;
+  int nterms;                  // # of expansion coeffs with m >= 0
+  int nterms2;                 // same for expansions of order 2*order
+  int levels;                  // # of tree levels below the root cell
+  int levels_user;             // requested # of levels, -1 = automatic
+  int order_user;              // requested expansion order, -1 = automatic
+  int ncell;                   // # of cells in all levels of the tree
+  int *celloffset;             // index of first cell of each level
+  int *cellcount;              // # of atoms in each cell
+  int *cellneed;               // 1 if cell holds my atoms or their ancestors
+
+  int periodicity[3];          // 1 if dim is periodic
+  int nperiodic;               // # of periodic dims
+  double rootlo[3],rootlen[3]; // lower corner and size of root cell
+  double volume;
+
+  cplx *mpole;                 // multipole expansions of all cells
+  cplx *local;                 // local expansions of all cells
+  cplx *rwork,*iwork;          // scratch harmonics
+  cplx *mwork;                 // scratch expansions
+  cplx *shift_r;               // child/parent translations of one level
+  cplx *shift_i;               // interactions for all offsets of one level
+
+  int nlattice;                // # of supercell levels in lattice sum
+  cplx *lattice_m2m;           // summed translations for supercells
+  cplx *lattice_m2l;           // summed interactions for supercell shells
+  double surface[3];           // shape dependent dipole correction factors
+
+  int nall,maxall;             // # of atoms in all procs, allocated size
+  int *recvcounts,*displs;
+  double *xq;                  // coords and charges of all atoms
+  int *leafatoms;              // atoms sorted by leaf cell
+  int *leafstart;              // index of first atom in each leaf in leafatoms
+  int *myleaf;                 // leaf of each of my atoms
+  int maxlocal;
+  double *phi;                 // potential at my atoms
+  double **efield;             // electric field at my atoms
+
+  inline int idx(int l, int m) const { return l*(l+1)/2 + m; }
+  inline cplx coeff(const cplx *a, int l, int m) const {
+    if (m >= 0) return a[idx(l,m)];
+    return (m & 1) ? -std::conj(a[idx(l,-m)]) : std::conj(a[idx(l,-m)]);
+  }
+
+  void choose_parameters();
+  void allocate();
+  void deallocate();
+  void gather_atoms();
+  void build_tree();
+  void upward_pass();
+  void downward_pass();
+  void lattice_sum();
+  void evaluate();
+  void near_field(int, double *, double &);
+  void special_correction();
+  void dipole_correction();
+
+  void regular(const double *, cplx *, int);
+  void irregular(const double *, cplx *, int);
+  void m2m(const cplx *, const cplx *, cplx *);
+  void m2l(const cplx *, const cplx *, cplx *);
+  void l2l(const cplx *, const cplx *, cplx *);
+  void cell_center(int, int, int, int, double *);
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Illegal ... command
+
+Self-explanatory.  Check the input script syntax and compare to the
+documentation for the command.  You can use -echo screen as a
+command-line option when running LAMMPS to see the offending line.
+
+E: Cannot use kspace_style fmm with 2d simulation
+
+This feature is not yet supported.
+
+E: Cannot use kspace_style fmm with triclinic box
+
+This feature is not yet supported.
+
+E: Kspace style requires atom attribute q
+
+The atom style defined does not have these attributes.
+
+E: Kspace style fmm requires a pair style without Coulomb interactions
+
+The fmm style computes the complete Coulomb interaction between all
+pairs of atoms.  A pair style that also includes Coulomb terms would
+count them twice.
+
+E: Kspace style fmm does not support per-atom virial
+
+Self-explanatory.
+
+E: Kspace style fmm requires a charge neutral system with periodic boundaries
+
+The lattice sum over periodic images of a system with a net charge does
+not converge.
+
+E: Kspace style fmm atom count exceeds 2B
+
+The fmm style gathers the coordinates of all atoms on all processors
+and is therefore limited to less than 2^31 atoms.
+
+E: FMM expansion order must be between 1 and 30
+
+Self-explanatory.
+
+E: FMM tree levels must be between 0 and 8
+
+Self-explanatory.
+
+E: FMM special neighbor atom missing
+
+A bond partner of a local atom is not available as local or ghost atom,
+so the excluded part of the Coulomb interaction cannot be removed.
+
+W: FMM virial tensor with periodic boundaries is approximated as isotropic
+
+With periodic boundaries only the trace of the virial is computed
+exactly by the fmm style.  The pressure is correct, but the individual
+components of the pressure tensor are not.
+
+*/
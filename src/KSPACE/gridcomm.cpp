@@ -155,6 +155,21 @@ GridComm::~GridComm()
   memory->sfree(copy);
 
   delete [] requests;
+
+  // neighbor collective data structs
+
+  if (neighbor_flag) {
+    MPI_Comm_free(&neighcomm_forward);
+    MPI_Comm_free(&neighcomm_reverse);
+  }
+  memory->destroy(sendproc_count);
+  memory->destroy(sendproc_offset);
+  memory->destroy(recvproc_count);
+  memory->destroy(recvproc_offset);
+  memory->destroy(sendcounts);
+  memory->destroy(sdispls);
+  memory->destroy(recvcounts);
+  memory->destroy(rdispls);
 }
 
 /* ----------------------------------------------------------------------
@@ -218,6 +233,12 @@ void GridComm::initialize(MPI_Comm gcomm,
   recv = nullptr;
   copy = nullptr;
   requests = nullptr;
+
+  neighbor_flag = 0;
+  nsendproc = nrecvproc = 0;
+  sendproc_count = sendproc_offset = nullptr;
+  recvproc_count = recvproc_offset = nullptr;
+  sendcounts = sdispls = recvcounts = rdispls = nullptr;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -754,6 +775,82 @@ void GridComm::setup_tiled(int &nbuf1, int &nbuf2)
   }
 
   nbuf2 = MAX(nbufs,nbufr);
+
+  // neighbor collectives pack all messages into buf1 at once
+
+  setup_neighbor();
+  if (neighbor_flag) nbuf1 = MAX(nbuf1,nbuf2);
+}
+
+/* ----------------------------------------------------------------------
+   create distributed graph communicators for tiled forward/reverse comm
+   via MPI_Neighbor_alltoallv(), requires MPI-3
+   Irregular returns requests and responses sorted by proc, so the Send
+     and Recv entries for one proc are consecutive in the comm buffers
+     and can be combined into a single message per proc
+   the Send entries on a proc match the Recv entries on the other proc
+     one by one, so combined messages match as well
+------------------------------------------------------------------------- */
+
+void GridComm::setup_neighbor()
+{
+#if defined(MPI_VERSION) && (MPI_VERSION > 2)
+  if (nprocs == 1) return;
+
+  int m;
+  int *sendprocs,*recvprocs;
+
+  memory->create(sendprocs,nsend,"GridComm:sendprocs");
+  memory->create(sendproc_count,nsend,"GridComm:sendproc_count");
+  memory->create(sendproc_offset,nsend,"GridComm:sendproc_offset");
+  memory->create(recvprocs,nrecv,"GridComm:recvprocs");
+  memory->create(recvproc_count,nrecv,"GridComm:recvproc_count");
+  memory->create(recvproc_offset,nrecv,"GridComm:recvproc_offset");
+
+  nsendproc = 0;
+  for (m = 0; m < nsend; m++) {
+    if (nsendproc && send[m].proc == sendprocs[nsendproc-1])
+      sendproc_count[nsendproc-1] += send[m].npack;
+    else {
+      sendprocs[nsendproc] = send[m].proc;
+      sendproc_count[nsendproc] = send[m].npack;
+      sendproc_offset[nsendproc] = send[m].offset;
+      nsendproc++;
+    }
+  }
+
+  nrecvproc = 0;
+  for (m = 0; m < nrecv; m++) {
+    if (nrecvproc && recv[m].proc == recvprocs[nrecvproc-1])
+      recvproc_count[nrecvproc-1] += recv[m].nunpack;
+    else {
+      recvprocs[nrecvproc] = recv[m].proc;
+      recvproc_count[nrecvproc] = recv[m].nunpack;
+      recvproc_offset[nrecvproc] = recv[m].offset;
+      nrecvproc++;
+    }
+  }
+
+  MPI_Dist_graph_create_adjacent(gridcomm,nrecvproc,recvprocs,MPI_UNWEIGHTED,
+                                 nsendproc,sendprocs,MPI_UNWEIGHTED,
+                                 MPI_INFO_NULL,0,&neighcomm_forward);
+  MPI_Dist_graph_create_adjacent(gridcomm,nsendproc,sendprocs,MPI_UNWEIGHTED,
+                                 nrecvproc,recvprocs,MPI_UNWEIGHTED,
+                                 MPI_INFO_NULL,0,&neighcomm_reverse);
+
+  // counts and offsets for one call, in units of the comm datatype
+
+  int nmax = MAX(nsendproc,nrecvproc);
+  memory->create(sendcounts,nmax,"GridComm:sendcounts");
+  memory->create(sdispls,nmax,"GridComm:sdispls");
+  memory->create(recvcounts,nmax,"GridComm:recvcounts");
+  memory->create(rdispls,nmax,"GridComm:rdispls");
+
+  memory->destroy(sendprocs);
+  memory->destroy(recvprocs);
+
+  neighbor_flag = 1;
+#endif
 }
 
 /* ----------------------------------------------------------------------
@@ -930,6 +1027,8 @@ void GridComm::forward_comm_kspace(KSpace *kspace, int nper, int nbyte, int whic
 {
   if (layout == REGULAR)
     forward_comm_kspace_regular(kspace,nper,nbyte,which,buf1,buf2,datatype);
+  else if (neighbor_flag)
+    forward_comm_kspace_neighbor(kspace,nper,nbyte,which,buf1,buf2,datatype);
   else
     forward_comm_kspace_tiled(kspace,nper,nbyte,which,buf1,buf2,datatype);
 }
@@ -1016,6 +1115,8 @@ void GridComm::reverse_comm_kspace(KSpace *kspace, int nper, int nbyte, int whic
 {
   if (layout == REGULAR)
     reverse_comm_kspace_regular(kspace,nper,nbyte,which,buf1,buf2,datatype);
+  else if (neighbor_flag)
+    reverse_comm_kspace_neighbor(kspace,nper,nbyte,which,buf1,buf2,datatype);
   else
     reverse_comm_kspace_tiled(kspace,nper,nbyte,which,buf1,buf2,datatype);
 }
@@ -1093,6 +1194,110 @@ reverse_comm_kspace_tiled(KSpace *kspace, int nper, int nbyte, int which,
   }
 }
 
+/* ----------------------------------------------------------------------
+   forward comm on tiled grid decomp via one neighbor collective
+   all Send lists are packed into buf1 before the exchange
+------------------------------------------------------------------------- */
+
+void GridComm::
+forward_comm_kspace_neighbor(KSpace *kspace, int nper, int nbyte, int which,
+                             void *vbuf1, void *vbuf2, MPI_Datatype datatype)
+{
+#if defined(MPI_VERSION) && (MPI_VERSION > 2)
+  int m,offset;
+
+  char *buf1 = (char *) vbuf1;
+  char *buf2 = (char *) vbuf2;
+
+  // pack all sends to other procs
+
+  for (m = 0; m < nsend; m++) {
+    offset = nper * send[m].offset * nbyte;
+    kspace->pack_forward_grid(which,(void *) &buf1[offset],
+                              send[m].npack,send[m].packlist);
+  }
+
+  for (m = 0; m < nsendproc; m++) {
+    sendcounts[m] = nper * sendproc_count[m];
+    sdispls[m] = nper * sendproc_offset[m];
+  }
+  for (m = 0; m < nrecvproc; m++) {
+    recvcounts[m] = nper * recvproc_count[m];
+    rdispls[m] = nper * recvproc_offset[m];
+  }
+
+  MPI_Neighbor_alltoallv(buf1,sendcounts,sdispls,datatype,
+                         buf2,recvcounts,rdispls,datatype,neighcomm_forward);
+
+  // perform all copies to self
+
+  for (m = 0; m < ncopy; m++) {
+    kspace->pack_forward_grid(which,buf1,copy[m].npack,copy[m].packlist);
+    kspace->unpack_forward_grid(which,buf1,copy[m].nunpack,copy[m].unpacklist);
+  }
+
+  // unpack all received data
+
+  for (m = 0; m < nrecv; m++) {
+    offset = nper * recv[m].offset * nbyte;
+    kspace->unpack_forward_grid(which,(void *) &buf2[offset],
+                                recv[m].nunpack,recv[m].unpacklist);
+  }
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   reverse comm on tiled grid decomp via one neighbor collective
+   all Recv lists are packed into buf1 before the exchange
+------------------------------------------------------------------------- */
+
+void GridComm::
+reverse_comm_kspace_neighbor(KSpace *kspace, int nper, int nbyte, int which,
+                             void *vbuf1, void *vbuf2, MPI_Datatype datatype)
+{
+#if defined(MPI_VERSION) && (MPI_VERSION > 2)
+  int m,offset;
+
+  char *buf1 = (char *) vbuf1;
+  char *buf2 = (char *) vbuf2;
+
+  // pack all sends to other procs
+
+  for (m = 0; m < nrecv; m++) {
+    offset = nper * recv[m].offset * nbyte;
+    kspace->pack_reverse_grid(which,(void *) &buf1[offset],
+                              recv[m].nunpack,recv[m].unpacklist);
+  }
+
+  for (m = 0; m < nrecvproc; m++) {
+    sendcounts[m] = nper * recvproc_count[m];
+    sdispls[m] = nper * recvproc_offset[m];
+  }
+  for (m = 0; m < nsendproc; m++) {
+    recvcounts[m] = nper * sendproc_count[m];
+    rdispls[m] = nper * sendproc_offset[m];
+  }
+
+  MPI_Neighbor_alltoallv(buf1,sendcounts,sdispls,datatype,
+                         buf2,recvcounts,rdispls,datatype,neighcomm_reverse);
+
+  // perform all copies to self
+
+  for (m = 0; m < ncopy; m++) {
+    kspace->pack_reverse_grid(which,buf1,copy[m].nunpack,copy[m].unpacklist);
+    kspace->unpack_reverse_grid(which,buf1,copy[m].npack,copy[m].packlist);
+  }
+
+  // unpack all received data
+
+  for (m = 0; m < nsend; m++) {
+    offset = nper * send[m].offset * nbyte;
+    kspace->unpack_reverse_grid(which,(void *) &buf2[offset],
+                                send[m].npack,send[m].packlist);
+  }
+#endif
+}
+
 /* ----------------------------------------------------------------------
    create swap stencil for grid own/ghost communication
    swaps covers all 3 dimensions and both directions
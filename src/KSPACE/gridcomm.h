@@ -172,6 +172,22 @@ class GridComm : protected Pointers {
   Recv *recv;
   Copy *copy;
 
+  // neighbor = distributed graph communicators for MPI_Neighbor_alltoallv()
+  // one edge per distinct proc, all Send or Recv messages with that proc
+  //   are consecutive in the comm buffers and are sent as one message
+  // forward comm sends to Send procs and recvs from Recv procs
+  // reverse comm uses a 2nd communicator with the opposite direction
+
+  int neighbor_flag;           // 1 if neighbor collectives are used
+  MPI_Comm neighcomm_forward,neighcomm_reverse;
+  int nsendproc,nrecvproc;     // # of distinct procs in Send, Recv
+  int *sendproc_count;         // # of grid pts sent to each distinct proc
+  int *sendproc_offset;        // offset of 1st grid pt for each proc
+  int *recvproc_count;         // same for Recv procs
+  int *recvproc_offset;
+  int *sendcounts,*sdispls;    // counts and offsets in units of datatype
+  int *recvcounts,*rdispls;
+
   // -------------------------------------------
   // internal methods
   // -------------------------------------------
@@ -198,6 +214,12 @@ class GridComm : protected Pointers {
   void reverse_comm_kspace_tiled(class KSpace *, int, int, int,
                                  void *, void *, MPI_Datatype);
 
+  void setup_neighbor();
+  void forward_comm_kspace_neighbor(class KSpace *, int, int, int,
+                                    void *, void *, MPI_Datatype);
+  void reverse_comm_kspace_neighbor(class KSpace *, int, int, int,
+                                    void *, void *, MPI_Datatype);
+
   virtual void grow_swap();
   void grow_overlap();
 
@@ -2274,19 +2274,15 @@ void MSM::direct_peratom_top(int n)
 }
 
 /* ----------------------------------------------------------------------
-   MSM restriction procedure for intermediate grid levels, interpolate
-   charges from finer grid to coarser grid
+   compute the 1d interpolation weights phi1d between grid levels n and
+   n+1 and the corresponding fine grid offsets
 ------------------------------------------------------------------------- */
 
-void MSM::restriction(int n)
+void MSM::setup_stencil(int n, int *index)
 {
   const int p = order-1;
 
-  double ***qgrid1 = qgrid[n];
-  double ***qgrid2 = qgrid[n+1];
-
   int k = 0;
-  int *index = new int[p+2];
   for (int nu=-p; nu<=p; nu++) {
     if (nu%2 == 0 && nu != 0) continue;
     phi1d[0][k] = compute_phi(nu*delxinv[n+1]/delxinv[n]);
@@ -2295,8 +2291,24 @@ void MSM::restriction(int n)
     index[k] = nu;
     k++;
   }
+}
 
-  int ip,jp,kp,ic,jc,kc,i,j;
+/* ----------------------------------------------------------------------
+   MSM restriction procedure for intermediate grid levels, interpolate
+   charges from finer grid to coarser grid
+------------------------------------------------------------------------- */
+
+void MSM::restriction(int n)
+{
+  const int p = order-1;
+
+  double ***qgrid1 = qgrid[n];
+  double ***qgrid2 = qgrid[n+1];
+
+  int *index = new int[p+2];
+  setup_stencil(n,index);
+
+  int ip,jp,kp,ic,jc,kc,i,j,k;
   int ii,jj,kk;
   double phiz,phizy,q2sum;
 
@@ -2369,18 +2381,10 @@ void MSM::prolongation(int n)
   double ***v5grid1 = v5grid[n];
   double ***v5grid2 = v5grid[n+1];
 
-  int k = 0;
   int *index = new int[p+2];
-  for (int nu=-p; nu<=p; nu++) {
-    if (nu%2 == 0 && nu != 0) continue;
-    phi1d[0][k] = compute_phi(nu*delxinv[n+1]/delxinv[n]);
-    phi1d[1][k] = compute_phi(nu*delyinv[n+1]/delyinv[n]);
-    phi1d[2][k] = compute_phi(nu*delzinv[n+1]/delzinv[n]);
-    index[k] = nu;
-    k++;
-  }
+  setup_stencil(n,index);
 
-  int ip,jp,kp,ic,jc,kc,i,j;
+  int ip,jp,kp,ic,jc,kc,i,j,k;
   int ii,jj,kk;
   double phiz,phizy,phi3d;
   double etmp2,v0tmp2,v1tmp2,v2tmp2,v3tmp2,v4tmp2,v5tmp2;
@@ -249,6 +249,9 @@ PPPMDisp::~PPPMDisp()
   memory->destroy(part2grid);
   memory->destroy(part2grid_6);
   part2grid = part2grid_6 = nullptr;
+  // free cached 1d FFT plans no longer used by any 3d FFT
+
+  fft_3d_clear_cache();
 }
 
 /* ----------------------------------------------------------------------
@@ -1742,12 +1745,12 @@ void _noopt PPPMDisp::allocate()
     fft1 = new FFT3d(lmp,world,nx_pppm,ny_pppm,nz_pppm,
                      nxlo_fft,nxhi_fft,nylo_fft,nyhi_fft,nzlo_fft,nzhi_fft,
                      nxlo_fft,nxhi_fft,nylo_fft,nyhi_fft,nzlo_fft,nzhi_fft,
-                     0,0,&tmp,collective_flag);
+                     0,0,&tmp,collective_flag,fft_plan,fft_wisdom);
 
     fft2 = new FFT3d(lmp,world,nx_pppm,ny_pppm,nz_pppm,
                      nxlo_fft,nxhi_fft,nylo_fft,nyhi_fft,nzlo_fft,nzhi_fft,
                      nxlo_in,nxhi_in,nylo_in,nyhi_in,nzlo_in,nzhi_in,
-                     0,0,&tmp,collective_flag);
+                     0,0,&tmp,collective_flag,fft_plan,fft_wisdom);
 
     remap = new Remap(lmp,world,
                       nxlo_in,nxhi_in,nylo_in,nyhi_in,nzlo_in,nzhi_in,
@@ -1823,13 +1826,13 @@ void _noopt PPPMDisp::allocate()
       new FFT3d(lmp,world,nx_pppm_6,ny_pppm_6,nz_pppm_6,
                 nxlo_fft_6,nxhi_fft_6,nylo_fft_6,nyhi_fft_6,nzlo_fft_6,nzhi_fft_6,
                 nxlo_fft_6,nxhi_fft_6,nylo_fft_6,nyhi_fft_6,nzlo_fft_6,nzhi_fft_6,
-                0,0,&tmp,collective_flag);
+                0,0,&tmp,collective_flag,fft_plan,fft_wisdom);
 
     fft2_6 =
       new FFT3d(lmp,world,nx_pppm_6,ny_pppm_6,nz_pppm_6,
                 nxlo_fft_6,nxhi_fft_6,nylo_fft_6,nyhi_fft_6,nzlo_fft_6,nzhi_fft_6,
                 nxlo_in_6,nxhi_in_6,nylo_in_6,nyhi_in_6,nzlo_in_6,nzhi_in_6,
-                0,0,&tmp,collective_flag);
+                0,0,&tmp,collective_flag,fft_plan,fft_wisdom);
 
     remap_6 =
       new Remap(lmp,world,
@@ -1988,12 +1991,12 @@ void _noopt PPPMDisp::allocate()
     fft1_6 = new FFT3d(lmp,world,nx_pppm_6,ny_pppm_6,nz_pppm_6,
                      nxlo_fft_6,nxhi_fft_6,nylo_fft_6,nyhi_fft_6,nzlo_fft_6,nzhi_fft_6,
                      nxlo_fft_6,nxhi_fft_6,nylo_fft_6,nyhi_fft_6,nzlo_fft_6,nzhi_fft_6,
-                     0,0,&tmp,collective_flag);
+                     0,0,&tmp,collective_flag,fft_plan,fft_wisdom);
 
     fft2_6 = new FFT3d(lmp,world,nx_pppm_6,ny_pppm_6,nz_pppm_6,
                      nxlo_fft_6,nxhi_fft_6,nylo_fft_6,nyhi_fft_6,nzlo_fft_6,nzhi_fft_6,
                      nxlo_in_6,nxhi_in_6,nylo_in_6,nyhi_in_6,nzlo_in_6,nzhi_in_6,
-                     0,0,&tmp,collective_flag);
+                     0,0,&tmp,collective_flag,fft_plan,fft_wisdom);
 
     remap_6 = new Remap(lmp,world,
                       nxlo_in_6,nxhi_in_6,nylo_in_6,nyhi_in_6,nzlo_in_6,nzhi_in_6,
@@ -2075,12 +2078,12 @@ void _noopt PPPMDisp::allocate()
     fft1_6 = new FFT3d(lmp,world,nx_pppm_6,ny_pppm_6,nz_pppm_6,
                      nxlo_fft_6,nxhi_fft_6,nylo_fft_6,nyhi_fft_6,nzlo_fft_6,nzhi_fft_6,
                      nxlo_fft_6,nxhi_fft_6,nylo_fft_6,nyhi_fft_6,nzlo_fft_6,nzhi_fft_6,
-                     0,0,&tmp,collective_flag);
+                     0,0,&tmp,collective_flag,fft_plan,fft_wisdom);
 
     fft2_6 = new FFT3d(lmp,world,nx_pppm_6,ny_pppm_6,nz_pppm_6,
                      nxlo_fft_6,nxhi_fft_6,nylo_fft_6,nyhi_fft_6,nzlo_fft_6,nzhi_fft_6,
                      nxlo_in_6,nxhi_in_6,nylo_in_6,nyhi_in_6,nzlo_in_6,nzhi_in_6,
-                     0,0,&tmp,collective_flag);
+                     0,0,&tmp,collective_flag,fft_plan,fft_wisdom);
 
     remap_6 = new Remap(lmp,world,
                       nxlo_in_6,nxhi_in_6,nylo_in_6,nyhi_in_6,nzlo_in_6,nzhi_in_6,
@@ -275,6 +275,12 @@ void FixAtomSwap::init()
         if (cutsq[type_list[iswaptype]][ktype] != cutsq[type_list[jswaptype]][ktype])
           unequal_cutoffs = true;
 
+  // trial swaps only change charges, so a kspace style that supports it
+  // can update its energy from the changed atoms instead of all atoms
+
+  kspace_delta = force->kspace && force->kspace->mc_delta_enable;
+  kspace_trial = false;
+
   // check that no swappable atoms are in atom->firstgroup
   // swapping such an atom might not leave firstgroup atoms first
 
@@ -366,7 +372,9 @@ int FixAtomSwap::attempt_semi_grand()
   }
 
   if (force->kspace) force->kspace->qsum_qsq();
+  kspace_trial = kspace_delta;
   double energy_after = energy_full();
+  kspace_trial = false;
 
   int success = 0;
   if (i >= 0)
@@ -434,6 +442,22 @@ int FixAtomSwap::attempt_swap()
     if (atom->q_flag) atom->q[j] = qtype[0];
   }
 
+  if (kspace_delta) {
+    int n = 0;
+    int list[2];
+    double qold[2];
+    if (i >= 0) {
+      list[n] = i;
+      qold[n++] = qtype[0];
+    }
+    if (j >= 0) {
+      list[n] = j;
+      qold[n++] = qtype[1];
+    }
+    force->kspace->energy_delta(n,list,nullptr,qold);
+    kspace_trial = true;
+  }
+
   if (unequal_cutoffs) {
     if (domain->triclinic) domain->x2lamda(atom->nlocal);
     domain->pbc();
@@ -447,9 +471,11 @@ int FixAtomSwap::attempt_swap()
   }
 
   double energy_after = energy_full();
+  kspace_trial = false;
 
   if (random_equal->uniform() <
       exp(beta*(energy_before - energy_after))) {
+    if (kspace_delta) force->kspace->accept_delta(1);
     update_swap_atoms_list();
     energy_stored = energy_after;
     if (conserve_ke_flag) {
@@ -466,6 +492,7 @@ int FixAtomSwap::attempt_swap()
     }
     return 1;
   } else {
+    if (kspace_delta) force->kspace->accept_delta(0);
     if (i >= 0) {
       atom->type[i] =  type_list[0];
       if (atom->q_flag) atom->q[i] = qtype[0];
@@ -512,7 +539,7 @@ double FixAtomSwap::energy_full()
     if (force->improper) force->improper->compute(eflag,vflag);
   }
 
-  if (force->kspace) force->kspace->compute(eflag,vflag);
+  if (force->kspace && !kspace_trial) force->kspace->compute(eflag,vflag);
 
   if (modify->n_post_force) modify->post_force(vflag);
   if (modify->n_end_of_step) modify->end_of_step();
@@ -69,6 +69,8 @@ class FixAtomSwap : public Fix {
   double nswap_successes;
 
   bool unequal_cutoffs;
+  bool kspace_delta;                      // kspace updates energy incrementally
+  bool kspace_trial;                      // skip kspace compute in energy_full()
 
   int atom_swap_nmax;
   double beta;
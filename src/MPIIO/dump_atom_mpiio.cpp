@@ -38,7 +38,12 @@ using namespace LAMMPS_NS;
 /* ---------------------------------------------------------------------- */
 
 DumpAtomMPIIO::DumpAtomMPIIO(LAMMPS *lmp, int narg, char **arg) :
-  DumpAtom(lmp, narg, arg) {}
+  DumpAtom(lmp, narg, arg)
+{
+  // MPI-IO output is written by all procs within write()
+
+  async_allow = 0;
+}
 
 /* ---------------------------------------------------------------------- */
 
@@ -50,7 +50,12 @@ using namespace LAMMPS_NS;
 /* ---------------------------------------------------------------------- */
 
 DumpCFGMPIIO::DumpCFGMPIIO(LAMMPS *lmp, int narg, char **arg) :
-  DumpCFG(lmp, narg, arg) {}
+  DumpCFG(lmp, narg, arg)
+{
+  // MPI-IO output is written by all procs within write()
+
+  async_allow = 0;
+}
 
 /* ---------------------------------------------------------------------- */
 
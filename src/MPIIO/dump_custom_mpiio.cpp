@@ -53,7 +53,12 @@ enum{LT,LE,GT,GE,EQ,NEQ};
 /* ---------------------------------------------------------------------- */
 
 DumpCustomMPIIO::DumpCustomMPIIO(LAMMPS *lmp, int narg, char **arg) :
-  DumpCustom(lmp, narg, arg) {}
+  DumpCustom(lmp, narg, arg)
+{
+  // MPI-IO output is written by all procs within write()
+
+  async_allow = 0;
+}
 
 /* ---------------------------------------------------------------------- */
 
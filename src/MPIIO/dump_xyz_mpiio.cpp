@@ -50,7 +50,12 @@ enum{LT,LE,GT,GE,EQ,NEQ};
 /* ---------------------------------------------------------------------- */
 
 DumpXYZMPIIO::DumpXYZMPIIO(LAMMPS *lmp, int narg, char **arg) :
-  DumpXYZ(lmp, narg, arg) {}
+  DumpXYZ(lmp, narg, arg)
+{
+  // MPI-IO output is written by all procs within write()
+
+  async_allow = 0;
+}
 
 /* ---------------------------------------------------------------------- */
 
@@ -152,7 +152,7 @@ void RestartMPIIO::read(MPI_Offset chunkOffset, bigint chunkSize, double *buf)
     error->one(FLERR,str);
   }
 
-  MPI_Offset currentOffset = chunkOffset+intChunkSize;
+  MPI_Offset currentOffset = chunkOffset+intChunkSize*sizeof(double);
   MPI_Offset bufOffset = intChunkSize;
   while (remainingSize > 0) {
     int currentChunkSize;
@@ -175,7 +175,7 @@ void RestartMPIIO::read(MPI_Offset chunkOffset, bigint chunkSize, double *buf)
               mpiErrorString);
       error->one(FLERR,str);
     }
-    currentOffset += currentChunkSize;
+    currentOffset += currentChunkSize*sizeof(double);
     bufOffset += currentChunkSize;
   }
 }
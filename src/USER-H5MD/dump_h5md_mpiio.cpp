@@ -0,0 +1,616 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://lammps.sandia.gov/, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "dump_h5md_mpiio.h"
+
+#include "atom.h"
+#include "domain.h"
+#include "error.h"
+#include "group.h"
+#include "memory.h"
+#include "update.h"
+#include "version.h"
+
+#include <cstring>
+
+using namespace LAMMPS_NS;
+
+// with a parallel HDF5 library all procs write their own rows collectively
+// else proc 0 writes the rows of one proc at a time
+
+#if defined(H5_HAVE_PARALLEL) && !defined(MPI_STUBS)
+#define LMP_H5MD_PARALLEL
+#endif
+
+#define NFRAMECHUNK 128     // # of frames per chunk of step and time
+#define CHUNKSIZE 65536     // default max # of atoms per chunk
+
+/* ---------------------------------------------------------------------- */
+
+DumpH5MDMPIIO::DumpH5MDMPIIO(LAMMPS *lmp, int narg, char **arg) :
+  Dump(lmp, narg, arg), author_name(nullptr), dslab(nullptr), islab(nullptr)
+{
+  if (narg < 6) error->all(FLERR,"Illegal dump h5md/mpiio command");
+  if (binary || compressed || multifile || multiproc)
+    error->all(FLERR,"Invalid dump h5md/mpiio filename");
+  if (domain->triclinic)
+    error->all(FLERR,"Dump h5md/mpiio only supports orthogonal boxes");
+
+  for (int i = 0; i < NELEMENT; i++) {
+    element_flag[i] = 0;
+    value[i] = step[i] = time[i] = -1;
+  }
+  edges_value = edges_step = edges_time = -1;
+  origin_value = origin_step = origin_time = -1;
+
+  // atom IDs are always written, since rows are in the order procs own atoms
+
+  element_flag[ID] = 1;
+
+  int iarg = 5;
+  while (iarg < narg) {
+    if (strcmp(arg[iarg],"position") == 0) element_flag[POSITION] = 1;
+    else if (strcmp(arg[iarg],"image") == 0) element_flag[IMAGE] = 1;
+    else if (strcmp(arg[iarg],"velocity") == 0) element_flag[VELOCITY] = 1;
+    else if (strcmp(arg[iarg],"force") == 0) element_flag[FORCE] = 1;
+    else if (strcmp(arg[iarg],"species") == 0) element_flag[SPECIES] = 1;
+    else if (strcmp(arg[iarg],"charge") == 0) {
+      if (!atom->q_flag)
+        error->all(FLERR,"Dump h5md/mpiio charge requires atom attribute q");
+      element_flag[CHARGE] = 1;
+    } else if (strcmp(arg[iarg],"author") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal dump h5md/mpiio command");
+      delete [] author_name;
+      author_name = utils::strdup(arg[iarg+1]);
+      iarg++;
+    } else error->all(FLERR,"Illegal dump h5md/mpiio command");
+    iarg++;
+  }
+
+  if (!element_flag[POSITION] && !element_flag[IMAGE] &&
+      !element_flag[VELOCITY] && !element_flag[FORCE] &&
+      !element_flag[SPECIES] && !element_flag[CHARGE])
+    error->all(FLERR,"Dump h5md/mpiio requires at least one per-atom element");
+
+  int dim = domain->dimension;
+  element_ncol[ID] = element_ncol[SPECIES] = element_ncol[CHARGE] = 1;
+  element_ncol[POSITION] = element_ncol[IMAGE] = dim;
+  element_ncol[VELOCITY] = element_ncol[FORCE] = dim;
+
+  size_one = 0;
+  for (int i = 0; i < NELEMENT; i++)
+    if (element_flag[i]) size_one += element_ncol[i];
+
+#if defined(LMP_H5MD_PARALLEL)
+  h5flag = 1;
+#else
+  h5flag = (me == 0);
+#endif
+
+  sort_flag = 0;
+  format_default = nullptr;
+  unwrap_flag = 0;
+  chunk_size = CHUNKSIZE;
+  deflate_level = 0;
+
+  natoms_file = 0;
+  nframe = 0;
+  slab_offset = 0;
+  file = xfer = -1;
+  maxslab = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+DumpH5MDMPIIO::~DumpH5MDMPIIO()
+{
+  close_file();
+  memory->destroy(dslab);
+  memory->destroy(islab);
+  delete [] author_name;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void DumpH5MDMPIIO::init_style()
+{
+  if (sort_flag) error->all(FLERR,"Dump h5md/mpiio cannot sort output");
+  if (append_flag) error->all(FLERR,"Dump h5md/mpiio cannot append to a file");
+}
+
+/* ---------------------------------------------------------------------- */
+
+int DumpH5MDMPIIO::modify_param(int narg, char **arg)
+{
+  if (strcmp(arg[0],"unwrap") == 0) {
+    if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+    if (strcmp(arg[1],"yes") == 0) unwrap_flag = 1;
+    else if (strcmp(arg[1],"no") == 0) unwrap_flag = 0;
+    else error->all(FLERR,"Illegal dump_modify command");
+    return 2;
+  } else if (strcmp(arg[0],"chunk") == 0) {
+    if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+    if (nframe) error->all(FLERR,"Dump_modify chunk must be set before first snapshot");
+    chunk_size = utils::inumeric(FLERR,arg[1],false,lmp);
+    if (chunk_size <= 0) error->all(FLERR,"Illegal dump_modify command");
+    return 2;
+  } else if (strcmp(arg[0],"deflate") == 0) {
+    if (narg < 2) error->all(FLERR,"Illegal dump_modify command");
+    if (nframe) error->all(FLERR,"Dump_modify deflate must be set before first snapshot");
+    deflate_level = utils::inumeric(FLERR,arg[1],false,lmp);
+    if (deflate_level < 0 || deflate_level > 9)
+      error->all(FLERR,"Illegal dump_modify command");
+    if (deflate_level && !H5Zfilter_avail(H5Z_FILTER_DEFLATE))
+      error->all(FLERR,"Dump h5md/mpiio deflate filter is not available");
+    return 2;
+  }
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   create the file and the H5MD layout, called at the first snapshot
+   all datasets have natoms_file rows per frame and grow by one frame
+     per snapshot, the atom dimension is split into chunks of chunk_size
+------------------------------------------------------------------------- */
+
+void DumpH5MDMPIIO::openfile()
+{
+  int flag = 0;
+
+  if (h5flag) {
+    hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+    xfer = H5Pcreate(H5P_DATASET_XFER);
+#if defined(LMP_H5MD_PARALLEL)
+    H5Pset_fapl_mpio(fapl,world,MPI_INFO_NULL);
+    H5Pset_dxpl_mpio(xfer,H5FD_MPIO_COLLECTIVE);
+#endif
+    file = H5Fcreate(filename,H5F_ACC_TRUNC,H5P_DEFAULT,fapl);
+    H5Pclose(fapl);
+    if (file < 0) flag = 1;
+  }
+
+  int flagall;
+  MPI_Allreduce(&flag,&flagall,1,MPI_INT,MPI_MAX,world);
+  if (flagall) error->all(FLERR,"Cannot open dump file {}",filename);
+  if (!h5flag) return;
+
+  // h5md group with version, author, and creator
+
+  hid_t h5md = H5Gcreate2(file,"h5md",H5P_DEFAULT,H5P_DEFAULT,H5P_DEFAULT);
+  int version[2] = {1,1};
+  hsize_t two = 2;
+  hid_t space = H5Screate_simple(1,&two,nullptr);
+  hid_t attr = H5Acreate2(h5md,"version",H5T_STD_I32LE,space,H5P_DEFAULT,H5P_DEFAULT);
+  H5Awrite(attr,H5T_NATIVE_INT,version);
+  H5Aclose(attr);
+  H5Sclose(space);
+
+  hid_t info = H5Gcreate2(h5md,"author",H5P_DEFAULT,H5P_DEFAULT,H5P_DEFAULT);
+  write_attribute(info,"name",author_name ? author_name : "N/A");
+  H5Gclose(info);
+  info = H5Gcreate2(h5md,"creator",H5P_DEFAULT,H5P_DEFAULT,H5P_DEFAULT);
+  write_attribute(info,"name","LAMMPS");
+  write_attribute(info,"version",LAMMPS_VERSION);
+  H5Gclose(info);
+  H5Gclose(h5md);
+
+  // particles group named after the dump group, with its box
+
+  hid_t particles = H5Gcreate2(file,"particles",H5P_DEFAULT,H5P_DEFAULT,H5P_DEFAULT);
+  hid_t pgroup = H5Gcreate2(particles,group->names[igroup],
+                            H5P_DEFAULT,H5P_DEFAULT,H5P_DEFAULT);
+
+  int dim = domain->dimension;
+  hid_t box = H5Gcreate2(pgroup,"box",H5P_DEFAULT,H5P_DEFAULT,H5P_DEFAULT);
+  space = H5Screate(H5S_SCALAR);
+  attr = H5Acreate2(box,"dimension",H5T_STD_I32LE,space,H5P_DEFAULT,H5P_DEFAULT);
+  H5Awrite(attr,H5T_NATIVE_INT,&dim);
+  H5Aclose(attr);
+  H5Sclose(space);
+
+  char boundary[3][9];
+  for (int i = 0; i < 3; i++)
+    strcpy(boundary[i],domain->periodicity[i] ? "periodic" : "none");
+  hid_t strtype = H5Tcopy(H5T_C_S1);
+  H5Tset_size(strtype,9);
+  hsize_t ndim = dim;
+  space = H5Screate_simple(1,&ndim,nullptr);
+  attr = H5Acreate2(box,"boundary",strtype,space,H5P_DEFAULT,H5P_DEFAULT);
+  H5Awrite(attr,strtype,boundary);
+  H5Aclose(attr);
+  H5Sclose(space);
+  H5Tclose(strtype);
+
+  // H5MD only stores the box edges, the origin is an extension
+  //   so that read_dump can restore the box bounds
+
+  create_element(box,"edges",0,dim,H5T_IEEE_F64LE,edges_value,edges_step,edges_time);
+  create_element(box,"origin",0,dim,H5T_IEEE_F64LE,
+                 origin_value,origin_step,origin_time);
+  H5Gclose(box);
+
+  const char *names[NELEMENT] = {"id","position","image","velocity",
+                                 "force","species","charge"};
+  for (int i = 0; i < NELEMENT; i++) {
+    if (!element_flag[i]) continue;
+    hid_t type = H5T_IEEE_F64LE;
+    if (i == ID) type = H5T_STD_I64LE;
+    else if (i == IMAGE || i == SPECIES) type = H5T_STD_I32LE;
+    create_element(pgroup,names[i],1,element_ncol[i],type,value[i],step[i],time[i]);
+  }
+
+  H5Gclose(pgroup);
+  H5Gclose(particles);
+}
+
+/* ----------------------------------------------------------------------
+   write one snapshot
+   every element grows by one frame, then each proc's atoms are written
+     as a contiguous range of rows starting at the sum of nme of lower procs
+------------------------------------------------------------------------- */
+
+void DumpH5MDMPIIO::write()
+{
+  // if timestep < delaystep, just return
+
+  if (delay_flag && update->ntimestep < delaystep) return;
+
+  boxxlo = domain->boxlo[0];
+  boxxhi = domain->boxhi[0];
+  boxylo = domain->boxlo[1];
+  boxyhi = domain->boxhi[1];
+  boxzlo = domain->boxlo[2];
+  boxzhi = domain->boxhi[2];
+
+  // nme = # of atoms this proc contributes to dump
+  // nmax = max # of atoms on any proc
+
+  nme = count();
+  h5status = 0;
+  bigint bnme = nme;
+  MPI_Allreduce(&bnme,&ntotal,1,MPI_LMP_BIGINT,MPI_SUM,world);
+  int nmax;
+  MPI_Allreduce(&nme,&nmax,1,MPI_INT,MPI_MAX,world);
+
+  if (nframe == 0) {
+    natoms_file = ntotal;
+    openfile();
+  } else if (ntotal != natoms_file)
+    error->all(FLERR,"Dump h5md/mpiio number of atoms cannot change");
+
+  // use nmax to insure proc 0 can receive info from others
+
+  if (nmax > maxbuf) {
+    if ((bigint) nmax * size_one > MAXSMALLINT)
+      error->all(FLERR,"Too much per-proc info for dump");
+    maxbuf = nmax;
+    memory->destroy(buf);
+    memory->create(buf,maxbuf*size_one,"dump:buf");
+  }
+  if (nmax > maxslab) {
+    maxslab = nmax;
+    memory->destroy(dslab);
+    memory->destroy(islab);
+    memory->create(dslab,3*maxslab,"dump:dslab");
+    memory->create(islab,3*maxslab,"dump:islab");
+  }
+
+  pack(nullptr);
+
+  // add one frame to every element, proc 0 writes step, time and box
+
+  int flag = 0;
+  if (h5flag) {
+    for (int i = 0; i < NELEMENT; i++)
+      if (element_flag[i]) flag |= extend_element(value[i],step[i],time[i]);
+    flag |= extend_element(edges_value,edges_step,edges_time);
+    flag |= extend_element(origin_value,origin_step,origin_time);
+
+    double edges[3] = {boxxhi-boxxlo, boxyhi-boxylo, boxzhi-boxzlo};
+    double origin[3] = {boxxlo, boxylo, boxzlo};
+    hsize_t start[2] = {(hsize_t) nframe, 0};
+    hsize_t count[2] = {1, (hsize_t) domain->dimension};
+    if (me) count[0] = count[1] = 0;
+    flag |= write_slab(edges_value,H5T_NATIVE_DOUBLE,edges,2,start,count);
+    flag |= write_slab(origin_value,H5T_NATIVE_DOUBLE,origin,2,start,count);
+  }
+
+#if defined(LMP_H5MD_PARALLEL)
+  MPI_Scan(&bnme,&slab_offset,1,MPI_LMP_BIGINT,MPI_SUM,world);
+  slab_offset -= bnme;
+  write_data(nme,buf);
+#else
+  if (me == 0) {
+    MPI_Status status;
+    MPI_Request request;
+    int tmp,nlines;
+
+    slab_offset = 0;
+    for (int iproc = 0; iproc < nprocs; iproc++) {
+      if (iproc) {
+        MPI_Irecv(buf,maxbuf*size_one,MPI_DOUBLE,iproc,0,world,&request);
+        MPI_Send(&tmp,0,MPI_INT,iproc,0,world);
+        MPI_Wait(&request,&status);
+        MPI_Get_count(&status,MPI_DOUBLE,&nlines);
+        nlines /= size_one;
+      } else nlines = nme;
+
+      write_data(nlines,buf);
+      slab_offset += nlines;
+    }
+  } else {
+    int tmp;
+    MPI_Recv(&tmp,0,MPI_INT,0,0,world,MPI_STATUS_IGNORE);
+    MPI_Rsend(buf,nme*size_one,MPI_DOUBLE,0,0,world);
+  }
+#endif
+
+  if (h5flag && flush_flag) H5Fflush(file,H5F_SCOPE_GLOBAL);
+
+  flag |= h5status;
+  int flagall;
+  MPI_Allreduce(&flag,&flagall,1,MPI_INT,MPI_MAX,world);
+  if (flagall) error->all(FLERR,"HDF5 error while writing dump file {}",filename);
+
+  nframe++;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void DumpH5MDMPIIO::write_header(bigint /* ndump */)
+{
+}
+
+/* ---------------------------------------------------------------------- */
+
+void DumpH5MDMPIIO::pack(tagint * /* ids */)
+{
+  tagint *tag = atom->tag;
+  int *type = atom->type;
+  int *mask = atom->mask;
+  double **x = atom->x;
+  double **v = atom->v;
+  double **f = atom->f;
+  double *q = atom->q;
+  imageint *image = atom->image;
+  int nlocal = atom->nlocal;
+  int dim = domain->dimension;
+
+  double xprd = domain->xprd;
+  double yprd = domain->yprd;
+  double zprd = domain->zprd;
+
+  int m = 0;
+  for (int i = 0; i < nlocal; i++) {
+    if (!(mask[i] & groupbit)) continue;
+
+    int ix = (image[i] & IMGMASK) - IMGMAX;
+    int iy = (image[i] >> IMGBITS & IMGMASK) - IMGMAX;
+    int iz = (image[i] >> IMG2BITS) - IMGMAX;
+
+    buf[m++] = tag[i];
+    if (element_flag[POSITION]) {
+      if (unwrap_flag) {
+        buf[m++] = x[i][0] + ix*xprd;
+        buf[m++] = x[i][1] + iy*yprd;
+        if (dim > 2) buf[m++] = x[i][2] + iz*zprd;
+      } else {
+        buf[m++] = x[i][0];
+        buf[m++] = x[i][1];
+        if (dim > 2) buf[m++] = x[i][2];
+      }
+    }
+    if (element_flag[IMAGE]) {
+      buf[m++] = ix;
+      buf[m++] = iy;
+      if (dim > 2) buf[m++] = iz;
+    }
+    if (element_flag[VELOCITY]) {
+      buf[m++] = v[i][0];
+      buf[m++] = v[i][1];
+      if (dim > 2) buf[m++] = v[i][2];
+    }
+    if (element_flag[FORCE]) {
+      buf[m++] = f[i][0];
+      buf[m++] = f[i][1];
+      if (dim > 2) buf[m++] = f[i][2];
+    }
+    if (element_flag[SPECIES]) buf[m++] = type[i];
+    if (element_flag[CHARGE]) buf[m++] = q[i];
+  }
+}
+
+/* ----------------------------------------------------------------------
+   write N atoms in mybuf to rows slab_offset to slab_offset+N-1
+     of the current frame of every element
+   with parallel HDF5 this is collective, N may be 0
+------------------------------------------------------------------------- */
+
+void DumpH5MDMPIIO::write_data(int n, double *mybuf)
+{
+  int flag = 0;
+  int icol = 0;
+
+  for (int ielem = 0; ielem < NELEMENT; ielem++) {
+    if (!element_flag[ielem]) continue;
+    int ncol = element_ncol[ielem];
+    int integer = (ielem == ID || ielem == IMAGE || ielem == SPECIES);
+
+    // copy the element's columns into a contiguous array
+
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < ncol; j++) {
+        if (integer) islab[i*ncol+j] = static_cast<bigint> (mybuf[i*size_one+icol+j]);
+        else dslab[i*ncol+j] = mybuf[i*size_one+icol+j];
+      }
+    }
+    icol += ncol;
+
+    hsize_t start[3] = {(hsize_t) nframe, (hsize_t) slab_offset, 0};
+    hsize_t count[3] = {1, (hsize_t) n, (hsize_t) ncol};
+    int rank = (ncol > 1) ? 3 : 2;
+    if (integer) flag |= write_slab(value[ielem],H5T_NATIVE_INT64,islab,rank,start,count);
+    else flag |= write_slab(value[ielem],H5T_NATIVE_DOUBLE,dslab,rank,start,count);
+  }
+
+  h5status |= flag;
+}
+
+/* ----------------------------------------------------------------------
+   create time-dependent H5MD element with step, time, and value datasets
+   value is (frames,natoms,ncol) if peratom, else (frames,ncol)
+   a per-atom element with ncol = 1 drops the last dimension
+------------------------------------------------------------------------- */
+
+void DumpH5MDMPIIO::create_element(hid_t parent, const char *name, int peratom,
+                                   int ncol, hid_t type, hid_t &evalue,
+                                   hid_t &estep, hid_t &etime)
+{
+  hid_t egroup = H5Gcreate2(parent,name,H5P_DEFAULT,H5P_DEFAULT,H5P_DEFAULT);
+
+  hsize_t dims[3] = {0,0,0};
+  hsize_t maxdims[3] = {H5S_UNLIMITED,H5S_UNLIMITED,H5S_UNLIMITED};
+  hsize_t chunk[3] = {NFRAMECHUNK,1,1};
+
+  hid_t space = H5Screate_simple(1,dims,maxdims);
+  hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(dcpl,1,chunk);
+  estep = H5Dcreate2(egroup,"step",H5T_STD_I64LE,space,H5P_DEFAULT,dcpl,H5P_DEFAULT);
+  etime = H5Dcreate2(egroup,"time",H5T_IEEE_F64LE,space,H5P_DEFAULT,dcpl,H5P_DEFAULT);
+  H5Pclose(dcpl);
+  H5Sclose(space);
+
+  // one frame per chunk, so a snapshot is written without touching others
+  // the atom dimension is unlimited so a chunk never exceeds the extent
+
+  int rank = 1;
+  chunk[0] = 1;
+  if (peratom) {
+    dims[rank] = natoms_file;
+    chunk[rank] = MAX(1,MIN(natoms_file,chunk_size));
+    rank++;
+  }
+  if (ncol > 1 || !peratom) {
+    dims[rank] = maxdims[rank] = chunk[rank] = ncol;
+    rank++;
+  }
+
+  space = H5Screate_simple(rank,dims,maxdims);
+  dcpl = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(dcpl,rank,chunk);
+  if (peratom && deflate_level) {
+    H5Pset_shuffle(dcpl);
+    H5Pset_deflate(dcpl,deflate_level);
+  }
+  evalue = H5Dcreate2(egroup,"value",type,space,H5P_DEFAULT,dcpl,H5P_DEFAULT);
+  H5Pclose(dcpl);
+  H5Sclose(space);
+  H5Gclose(egroup);
+
+  if (evalue < 0 || estep < 0 || etime < 0) h5status = 1;
+}
+
+/* ----------------------------------------------------------------------
+   grow element by one frame and store current step and time
+   return 1 if an HDF5 call failed, else 0
+------------------------------------------------------------------------- */
+
+int DumpH5MDMPIIO::extend_element(hid_t evalue, hid_t estep, hid_t etime)
+{
+  int flag = 0;
+  hsize_t dims[3];
+
+  hid_t space = H5Dget_space(evalue);
+  H5Sget_simple_extent_dims(space,dims,nullptr);
+  H5Sclose(space);
+  dims[0] = nframe+1;
+  if (H5Dset_extent(evalue,dims) < 0) flag = 1;
+
+  hsize_t nnew = nframe+1;
+  if (H5Dset_extent(estep,&nnew) < 0) flag = 1;
+  if (H5Dset_extent(etime,&nnew) < 0) flag = 1;
+
+  bigint ntimestep = update->ntimestep;
+  double t = compute_time();
+  hsize_t start = nframe;
+  hsize_t count = (me == 0) ? 1 : 0;
+  flag |= write_slab(estep,H5T_NATIVE_INT64,&ntimestep,1,&start,&count);
+  flag |= write_slab(etime,H5T_NATIVE_DOUBLE,&t,1,&start,&count);
+
+  return flag;
+}
+
+/* ----------------------------------------------------------------------
+   write block of count entries starting at start to dataset
+   count with a zero entry selects nothing, for collective writes
+   return 1 if an HDF5 call failed, else 0
+------------------------------------------------------------------------- */
+
+int DumpH5MDMPIIO::write_slab(hid_t dset, hid_t memtype, const void *data,
+                              int rank, hsize_t *start, hsize_t *count)
+{
+  int empty = 0;
+  for (int i = 0; i < rank; i++)
+    if (count[i] == 0) empty = 1;
+
+  hid_t fspace = H5Dget_space(dset);
+  hid_t mspace = H5Screate_simple(rank,count,nullptr);
+  if (empty) {
+    H5Sselect_none(fspace);
+    H5Sselect_none(mspace);
+  } else H5Sselect_hyperslab(fspace,H5S_SELECT_SET,start,nullptr,count,nullptr);
+
+  herr_t rv = H5Dwrite(dset,memtype,mspace,fspace,xfer,data);
+  H5Sclose(mspace);
+  H5Sclose(fspace);
+  return (rv < 0) ? 1 : 0;
+}
+
+/* ----------------------------------------------------------------------
+   write string attribute to HDF5 object
+------------------------------------------------------------------------- */
+
+void DumpH5MDMPIIO::write_attribute(hid_t obj, const char *name, const char *str)
+{
+  hid_t strtype = H5Tcopy(H5T_C_S1);
+  H5Tset_size(strtype,strlen(str)+1);
+  hid_t space = H5Screate(H5S_SCALAR);
+  hid_t attr = H5Acreate2(obj,name,strtype,space,H5P_DEFAULT,H5P_DEFAULT);
+  H5Awrite(attr,strtype,str);
+  H5Aclose(attr);
+  H5Sclose(space);
+  H5Tclose(strtype);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void DumpH5MDMPIIO::close_file()
+{
+  if (file < 0) return;
+
+  for (int i = 0; i < NELEMENT; i++) {
+    if (!element_flag[i]) continue;
+    H5Dclose(value[i]);
+    H5Dclose(step[i]);
+    H5Dclose(time[i]);
+  }
+  H5Dclose(edges_value);
+  H5Dclose(edges_step);
+  H5Dclose(edges_time);
+  H5Dclose(origin_value);
+  H5Dclose(origin_step);
+  H5Dclose(origin_time);
+  H5Pclose(xfer);
+  H5Fclose(file);
+  file = -1;
+}
@@ -0,0 +1,148 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://lammps.sandia.gov/, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef DUMP_CLASS
+
+DumpStyle(h5md/mpiio,DumpH5MDMPIIO)
+
+#else
+
+#ifndef LMP_DUMP_H5MD_MPIIO_H
+#define LMP_DUMP_H5MD_MPIIO_H
+
+#include "dump.h"
+#include <hdf5.h>
+
+namespace LAMMPS_NS {
+
+class DumpH5MDMPIIO : public Dump {
+ public:
+  DumpH5MDMPIIO(class LAMMPS *, int, char**);
+  virtual ~DumpH5MDMPIIO();
+
+  // per-atom elements in the order their columns appear in buf
+
+  enum{ID,POSITION,IMAGE,VELOCITY,FORCE,SPECIES,CHARGE,NELEMENT};
+
+ private:
+  int h5flag;                // 1 if this proc makes HDF5 calls
+  int h5status;              // 1 if an HDF5 call failed, else 0
+  int unwrap_flag;           // 1 if atom coords are unwrapped, 0 if no
+  int chunk_size;            // max # of atoms per dataset chunk
+  int deflate_level;         // 0 = no compression, 1-9 = deflate level
+  char *author_name;
+
+  int element_flag[NELEMENT];   // 1 if element is written
+  int element_ncol[NELEMENT];   // # of columns of element in buf
+
+  bigint natoms_file;        // # of atoms per snapshot in the file
+  bigint nframe;             // # of snapshots written to the file
+  bigint slab_offset;        // first row of the next hyperslab written
+
+  hid_t file;                // HDF5 file and element datasets
+  hid_t xfer;                // data transfer property list
+  hid_t value[NELEMENT],step[NELEMENT],time[NELEMENT];
+  hid_t edges_value,edges_step,edges_time;
+  hid_t origin_value,origin_step,origin_time;
+
+  int maxslab;               // size of dslab and islab
+  double *dslab;             // contiguous copy of one element
+  bigint *islab;             // same for integer elements
+
+  void init_style();
+  int modify_param(int, char **);
+  void openfile();
+  void write();
+  void write_header(bigint);
+  void pack(tagint *);
+  void write_data(int, double *);
+
+  void create_element(hid_t, const char *, int, int, hid_t,
+                      hid_t &, hid_t &, hid_t &);
+  int extend_element(hid_t, hid_t, hid_t);
+  int write_slab(hid_t, hid_t, const void *, int, hsize_t *, hsize_t *);
+  void write_attribute(hid_t, const char *, const char *);
+  void close_file();
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Illegal ... command
+
+Self-explanatory.  Check the input script syntax and compare to the
+documentation for the command.  You can use -echo screen as a
+command-line option when running LAMMPS to see the offending line.
+
+E: Invalid dump h5md/mpiio filename
+
+Binary, compressed, multi-file, and multi-proc file names are not
+supported by this dump style.
+
+E: Dump h5md/mpiio only supports orthogonal boxes
+
+Self-explanatory.
+
+E: Dump h5md/mpiio requires at least one per-atom element
+
+Select one or more of position, velocity, force, species, or charge.
+
+E: Dump h5md/mpiio charge requires atom attribute q
+
+The atom style does not define charges.
+
+E: Dump h5md/mpiio cannot sort output
+
+Each proc writes its own rows of every dataset, so the rows are in
+the order in which procs own the atoms.  The atom IDs are stored in
+the id element.
+
+E: Dump h5md/mpiio cannot append to a file
+
+H5MD datasets of an existing file are not reopened.
+
+E: Dump_modify chunk must be set before first snapshot
+
+The datasets are created at the first snapshot.
+
+E: Dump_modify deflate must be set before first snapshot
+
+The datasets are created at the first snapshot.
+
+E: Dump h5md/mpiio deflate filter is not available
+
+The HDF5 library was built without the zlib (deflate) filter.
+
+E: Cannot open dump file %s
+
+The output file could not be created.
+
+E: Dump h5md/mpiio number of atoms cannot change
+
+All snapshots in an H5MD file have the same number of rows.
+
+E: Too much per-proc info for dump
+
+Number of local atoms times number of columns must fit in a 32-bit
+integer for dump.
+
+E: HDF5 error while writing dump file %s
+
+An HDF5 call failed.  The HDF5 library prints more details about the
+failure to the screen.
+
+*/
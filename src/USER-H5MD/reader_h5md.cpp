@@ -0,0 +1,375 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://lammps.sandia.gov/, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "reader_h5md.h"
+
+#include "error.h"
+#include "memory.h"
+
+using namespace LAMMPS_NS;
+
+// also in read_dump.cpp
+
+enum{ID,TYPE,X,Y,Z,VX,VY,VZ,Q,IX,IY,IZ,FX,FY,FZ};
+enum{UNSET,NOSCALE_NOWRAP,NOSCALE_WRAP,SCALE_NOWRAP,SCALE_WRAP};
+
+/* ---------------------------------------------------------------------- */
+
+ReaderH5MD::ReaderH5MD(LAMMPS *lmp) : Reader(lmp)
+{
+  file = frame_step = -1;
+  for (int i = 0; i < NELEMENT; i++) {
+    value[i] = -1;
+    timedep[i] = ncol[i] = 0;
+  }
+  nframes = nextframe = frame = natoms = nrow = 0;
+
+  fieldelement = fieldcol = nullptr;
+  maxrbuf = 0;
+  rbuf = nullptr;
+}
+
+/* ---------------------------------------------------------------------- */
+
+ReaderH5MD::~ReaderH5MD()
+{
+  close_file();
+  memory->destroy(fieldelement);
+  memory->destroy(fieldcol);
+  memory->destroy(rbuf);
+}
+
+/* ----------------------------------------------------------------------
+   optional argument = name of the particles group to read
+------------------------------------------------------------------------- */
+
+void ReaderH5MD::settings(int narg, char **arg)
+{
+  if (narg > 1) error->all(FLERR,"Illegal read_dump command");
+  groupname = arg[0];
+}
+
+/* ----------------------------------------------------------------------
+   open the file and the elements of its particles group
+   the frames are those of the first time-dependent element found
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+void ReaderH5MD::open_file(const char *filename)
+{
+  if (file >= 0) close_file();
+
+  file = H5Fopen(filename,H5F_ACC_RDONLY,H5P_DEFAULT);
+  if (file < 0) error->one(FLERR,"Cannot open file {}",filename);
+
+  hid_t particles = -1;
+  std::string name = groupname;
+  if (H5Lexists(file,"particles",H5P_DEFAULT) > 0) {
+    particles = H5Gopen2(file,"particles",H5P_DEFAULT);
+    if (name.empty()) {
+      ssize_t len = H5Lget_name_by_idx(particles,".",H5_INDEX_NAME,H5_ITER_INC,
+                                       0,nullptr,0,H5P_DEFAULT);
+      if (len > 0) {
+        char *first = new char[len+1];
+        H5Lget_name_by_idx(particles,".",H5_INDEX_NAME,H5_ITER_INC,
+                           0,first,len+1,H5P_DEFAULT);
+        name = first;
+        delete [] first;
+      }
+    }
+  }
+
+  if (particles < 0 || name.empty() ||
+      H5Lexists(particles,name.c_str(),H5P_DEFAULT) <= 0)
+    error->one(FLERR,"Dump file {} has no H5MD particles group {}",
+               filename,groupname);
+
+  // position comes first, so its steps define the frames if present
+
+  hid_t pgroup = H5Gopen2(particles,name.c_str(),H5P_DEFAULT);
+  value[EPOSITION] = open_element(pgroup,"position",EPOSITION);
+  value[EVELOCITY] = open_element(pgroup,"velocity",EVELOCITY);
+  value[EFORCE] = open_element(pgroup,"force",EFORCE);
+  value[EIMAGE] = open_element(pgroup,"image",EIMAGE);
+  value[ESPECIES] = open_element(pgroup,"species",ESPECIES);
+  value[ECHARGE] = open_element(pgroup,"charge",ECHARGE);
+  value[EID] = open_element(pgroup,"id",EID);
+
+  if (H5Lexists(pgroup,"box",H5P_DEFAULT) > 0) {
+    hid_t box = H5Gopen2(pgroup,"box",H5P_DEFAULT);
+    value[EEDGES] = open_element(box,"edges",EEDGES);
+    value[EORIGIN] = open_element(box,"origin",EORIGIN);
+    H5Gclose(box);
+  }
+
+  H5Gclose(pgroup);
+  H5Gclose(particles);
+
+  if (frame_step < 0)
+    error->one(FLERR,"Dump file {} has no time-dependent H5MD element",filename);
+
+  hsize_t dims;
+  hid_t space = H5Dget_space(frame_step);
+  H5Sget_simple_extent_dims(space,&dims,nullptr);
+  H5Sclose(space);
+  nframes = dims;
+  nextframe = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void ReaderH5MD::close_file()
+{
+  if (file < 0) return;
+
+  for (int i = 0; i < NELEMENT; i++) {
+    if (value[i] >= 0) H5Dclose(value[i]);
+    value[i] = -1;
+  }
+  if (frame_step >= 0) H5Dclose(frame_step);
+  frame_step = -1;
+  H5Fclose(file);
+  file = -1;
+}
+
+/* ----------------------------------------------------------------------
+   read and return time stamp of next frame
+   if no frames are left, return 1 so caller can open next file
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+int ReaderH5MD::read_time(bigint &ntimestep)
+{
+  if (nextframe >= nframes) return 1;
+
+  hsize_t start = nextframe;
+  hsize_t count = 1;
+  hid_t space = H5Dget_space(frame_step);
+  H5Sselect_hyperslab(space,H5S_SELECT_SET,&start,nullptr,&count,nullptr);
+  hid_t mspace = H5Screate_simple(1,&count,nullptr);
+  int64_t step;
+  herr_t rv = H5Dread(frame_step,H5T_NATIVE_INT64,mspace,space,H5P_DEFAULT,&step);
+  H5Sclose(mspace);
+  H5Sclose(space);
+  if (rv < 0) error->one(FLERR,"HDF5 error while reading dump file");
+
+  ntimestep = step;
+  frame = nextframe++;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   skip snapshot, frames are accessed directly so nothing to do
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+void ReaderH5MD::skip()
+{
+}
+
+/* ----------------------------------------------------------------------
+   read remaining header info:
+     return natoms
+     box bounds from box edges and origin, triclinic = 0,
+     fieldflag (-1 if any fields not found),
+     xyz flags = UNSET (not a requested field), H5MD positions are
+       never scaled, wrapping is set by input wrapflag
+   if fieldinfo set:
+     match Nfield fields to elements and columns
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+bigint ReaderH5MD::read_header(double box[3][3], int &boxinfo, int &triclinic,
+                               int fieldinfo, int nfield,
+                               int *fieldtype, char ** /*fieldlabel*/,
+                               int /*scaleflag*/, int wrapflag, int &fieldflag,
+                               int &xflag, int &yflag, int &zflag)
+{
+  natoms = 0;
+  for (int i = 0; i < EEDGES; i++) {
+    if (value[i] < 0) continue;
+    hsize_t dims[3];
+    hid_t space = H5Dget_space(value[i]);
+    H5Sget_simple_extent_dims(space,dims,nullptr);
+    H5Sclose(space);
+    natoms = dims[timedep[i]];
+    break;
+  }
+  nrow = 0;
+
+  // H5MD files from other codes have no origin, assume box starts at 0.0
+  // 2d files have no z extent, use the LAMMPS default for 2d boxes
+
+  triclinic = 0;
+  boxinfo = 0;
+  if (value[EEDGES] >= 0) {
+    double edges[3] = {1.0,1.0,1.0};
+    double origin[3] = {0.0,0.0,0.0};
+    if (ncol[EEDGES] < 3) origin[2] = -0.5;
+    read_rows(EEDGES,0,1,edges);
+    if (value[EORIGIN] >= 0) read_rows(EORIGIN,0,1,origin);
+    for (int i = 0; i < 3; i++) {
+      box[i][0] = origin[i];
+      box[i][1] = origin[i] + edges[i];
+      box[i][2] = 0.0;
+    }
+    boxinfo = 1;
+  }
+
+  if (!fieldinfo) return natoms;
+
+  memory->destroy(fieldelement);
+  memory->destroy(fieldcol);
+  memory->create(fieldelement,nfield,"read_dump:fieldelement");
+  memory->create(fieldcol,nfield,"read_dump:fieldcol");
+
+  xflag = yflag = zflag = UNSET;
+  int xyzflag = wrapflag ? NOSCALE_WRAP : NOSCALE_NOWRAP;
+
+  // without an id element, atom IDs are the row numbers
+
+  fieldflag = 0;
+  for (int i = 0; i < nfield; i++) {
+    int ielem = -1;
+    int icol = 0;
+    switch (fieldtype[i]) {
+    case ID: ielem = EID; break;
+    case TYPE: ielem = ESPECIES; break;
+    case X: ielem = EPOSITION; xflag = xyzflag; break;
+    case Y: ielem = EPOSITION; icol = 1; yflag = xyzflag; break;
+    case Z: ielem = EPOSITION; icol = 2; zflag = xyzflag; break;
+    case VX: ielem = EVELOCITY; break;
+    case VY: ielem = EVELOCITY; icol = 1; break;
+    case VZ: ielem = EVELOCITY; icol = 2; break;
+    case Q: ielem = ECHARGE; break;
+    case IX: ielem = EIMAGE; break;
+    case IY: ielem = EIMAGE; icol = 1; break;
+    case IZ: ielem = EIMAGE; icol = 2; break;
+    case FX: ielem = EFORCE; break;
+    case FY: ielem = EFORCE; icol = 1; break;
+    case FZ: ielem = EFORCE; icol = 2; break;
+    }
+
+    if (ielem == EID && value[EID] < 0) ielem = -1;
+    else if (ielem < 0 || value[ielem] < 0 || icol >= ncol[ielem]) fieldflag = -1;
+    fieldelement[i] = ielem;
+    fieldcol[i] = icol;
+  }
+
+  return natoms;
+}
+
+/* ----------------------------------------------------------------------
+   read N atoms of current frame, starting after the ones read before
+   stores appropriate values in fields array
+   only called by proc 0
+------------------------------------------------------------------------- */
+
+void ReaderH5MD::read_atoms(int n, int nfield, double **fields)
+{
+  if (3*n > maxrbuf) {
+    maxrbuf = 3*n;
+    memory->destroy(rbuf);
+    memory->create(rbuf,maxrbuf,"read_dump:rbuf");
+  }
+
+  for (int m = 0; m < nfield; m++)
+    if (fieldelement[m] < 0)
+      for (int i = 0; i < n; i++) fields[i][m] = nrow + i + 1;
+
+  // read each element once for all fields that use it
+
+  for (int ielem = 0; ielem < EEDGES; ielem++) {
+    int used = 0;
+    for (int m = 0; m < nfield; m++)
+      if (fieldelement[m] == ielem) used = 1;
+    if (!used) continue;
+
+    read_rows(ielem,nrow,n,rbuf);
+    for (int m = 0; m < nfield; m++) {
+      if (fieldelement[m] != ielem) continue;
+      for (int i = 0; i < n; i++)
+        fields[i][m] = rbuf[i*ncol[ielem]+fieldcol[m]];
+    }
+  }
+
+  nrow += n;
+}
+
+/* ----------------------------------------------------------------------
+   open value dataset of time-dependent or fixed element
+   set frame_step to the first step dataset found
+   return -1 if element does not exist
+------------------------------------------------------------------------- */
+
+hid_t ReaderH5MD::open_element(hid_t parent, const char *name, int ielem)
+{
+  if (H5Lexists(parent,name,H5P_DEFAULT) <= 0) return -1;
+
+  hid_t dset;
+  hid_t obj = H5Oopen(parent,name,H5P_DEFAULT);
+  if (H5Iget_type(obj) == H5I_GROUP) {
+    timedep[ielem] = 1;
+    dset = H5Dopen2(obj,"value",H5P_DEFAULT);
+    if (frame_step < 0) frame_step = H5Dopen2(obj,"step",H5P_DEFAULT);
+  } else {
+    timedep[ielem] = 0;
+    dset = H5Dopen2(parent,name,H5P_DEFAULT);
+  }
+  H5Oclose(obj);
+  if (dset < 0) error->one(FLERR,"HDF5 error while reading dump file");
+
+  // per-atom elements with one value per atom have no column dimension
+
+  hsize_t dims[3] = {1,1,1};
+  hid_t space = H5Dget_space(dset);
+  int rank = H5Sget_simple_extent_ndims(space);
+  if (rank > 3) error->one(FLERR,"HDF5 error while reading dump file");
+  H5Sget_simple_extent_dims(space,dims,nullptr);
+  H5Sclose(space);
+
+  if (ielem < EEDGES && rank == 1 + timedep[ielem]) ncol[ielem] = 1;
+  else ncol[ielem] = MIN((int) dims[rank-1],3);
+  return dset;
+}
+
+/* ----------------------------------------------------------------------
+   read N rows starting at first of element in current frame into buf
+   box elements have a single row
+------------------------------------------------------------------------- */
+
+void ReaderH5MD::read_rows(int ielem, bigint first, int n, double *buf)
+{
+  hsize_t start[3] = {0,0,0};
+  hsize_t count[3] = {1,1,1};
+  int rank = 0;
+
+  if (timedep[ielem]) {
+    start[rank] = frame;
+    count[rank++] = 1;
+  }
+  if (ielem < EEDGES) {
+    start[rank] = first;
+    count[rank++] = n;
+  }
+
+  hid_t space = H5Dget_space(value[ielem]);
+  if (rank < H5Sget_simple_extent_ndims(space)) count[rank++] = ncol[ielem];
+  H5Sselect_hyperslab(space,H5S_SELECT_SET,start,nullptr,count,nullptr);
+  hsize_t nmem = (hsize_t) n * ncol[ielem];
+  hid_t mspace = H5Screate_simple(1,&nmem,nullptr);
+  herr_t rv = H5Dread(value[ielem],H5T_NATIVE_DOUBLE,mspace,space,H5P_DEFAULT,buf);
+  H5Sclose(mspace);
+  H5Sclose(space);
+  if (rv < 0) error->one(FLERR,"HDF5 error while reading dump file");
+}
@@ -0,0 +1,105 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://lammps.sandia.gov/, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef READER_CLASS
+
+ReaderStyle(h5md,ReaderH5MD)
+
+#else
+
+#ifndef LMP_READER_H5MD_H
+#define LMP_READER_H5MD_H
+
+#include "reader.h"
+#include <hdf5.h>
+#include <string>
+
+namespace LAMMPS_NS {
+
+class ReaderH5MD : public Reader {
+ public:
+  ReaderH5MD(class LAMMPS *);
+  ~ReaderH5MD();
+
+  void settings(int, char **);
+
+  int read_time(bigint &);
+  void skip();
+  bigint read_header(double [3][3], int &, int &, int, int, int *, char **,
+                     int, int, int &, int &, int &, int &);
+  void read_atoms(int, int, double **);
+
+  void open_file(const char *);
+  void close_file();
+
+  // H5MD elements that read_dump fields map to
+
+  enum{EID,EPOSITION,EIMAGE,EVELOCITY,EFORCE,ESPECIES,ECHARGE,EEDGES,EORIGIN,
+       NELEMENT};
+
+ private:
+  std::string groupname;   // particles group to read, empty = first one
+
+  hid_t file;              // open HDF5 file
+  hid_t frame_step;        // step dataset that defines the frames
+  hid_t value[NELEMENT];   // value dataset of each element, -1 if missing
+  int timedep[NELEMENT];   // 1 if element is time-dependent, 0 if fixed
+  int ncol[NELEMENT];      // # of columns per atom or box
+
+  bigint nframes;          // # of frames in file
+  bigint nextframe;        // index of frame read_time() returns next
+  bigint frame;            // index of current frame
+  bigint natoms;           // # of atoms per frame
+  bigint nrow;             // first row that read_atoms() reads next
+
+  int *fieldelement;       // element and column of each requested field
+  int *fieldcol;
+  int maxrbuf;             // size of rbuf
+  double *rbuf;            // rows of one element
+
+  hid_t open_element(hid_t, const char *, int);
+  void read_rows(int, bigint, int, double *);
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Illegal read_dump command
+
+Self-explanatory.
+
+E: Cannot open file %s
+
+The specified file cannot be opened.  Check that the path and name are
+correct.
+
+E: Dump file %s has no H5MD particles group %s
+
+The file has no particles group, or not the one given with the format
+keyword.
+
+E: Dump file %s has no time-dependent H5MD element
+
+At least one element of the particles group must store frames with a
+step dataset.
+
+E: HDF5 error while reading dump file
+
+An HDF5 call failed.  The HDF5 library prints more details about the
+failure to the screen.
+
+*/
@@ -31,6 +31,7 @@ ComputePressureGrem::ComputePressureGrem(LAMMPS *lmp, int narg, char **arg) :
   ComputePressure(lmp, narg-1, arg)
 {
   fix_grem = utils::strdup(arg[narg-1]);
+  partial_scalar_flag = partial_vector_flag = 0;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -0,0 +1,142 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://lammps.sandia.gov/, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "compute_rdf_omp.h"
+
+#include "atom.h"
+#include "comm.h"
+#include "force.h"
+#include "memory.h"
+#include "neigh_list.h"
+#include "neighbor.h"
+#include "thr_omp.h"
+
+#include <cmath>
+
+#include "omp_compat.h"
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+using namespace LAMMPS_NS;
+
+/* ---------------------------------------------------------------------- */
+
+ComputeRDFOMP::ComputeRDFOMP(LAMMPS *lmp, int narg, char **arg) :
+  ComputeRDF(lmp, narg, arg), nthr(0), histthr(nullptr) {}
+
+/* ---------------------------------------------------------------------- */
+
+ComputeRDFOMP::~ComputeRDFOMP()
+{
+  memory->destroy(histthr);
+}
+
+/* ----------------------------------------------------------------------
+   each thread tallies a chunk of the neighbor list into its own bins,
+     which are then summed into hist
+   pairs are counted in the same way as by ComputeRDF::tally_pairs()
+------------------------------------------------------------------------- */
+
+void ComputeRDFOMP::tally_pairs()
+{
+  const int nthreads = comm->nthreads;
+  const int nhist = npairs*nbin;
+
+  if (nthreads > nthr) {
+    nthr = nthreads;
+    memory->destroy(histthr);
+    memory->create(histthr,nthr,nhist,"rdf/omp:histthr");
+  }
+
+  const int inum = list->inum;
+
+#if defined(_OPENMP)
+#pragma omp parallel LMP_DEFAULT_NONE LMP_SHARED(nthreads,nhist,inum)
+#endif
+  {
+    int i,j,m,ii,jj,jnum,itype,jtype,ipair,jpair,ibin,ihisto;
+    double xtmp,ytmp,ztmp,delx,dely,delz,r;
+    double factor_lj,factor_coul;
+    int ifrom,ito,tid;
+
+    loop_setup_thr(ifrom,ito,tid,inum,nthreads);
+
+    double *h = histthr[tid];
+    for (m = 0; m < nhist; m++) h[m] = 0.0;
+
+    const int * const ilist = list->ilist;
+    const int * const numneigh = list->numneigh;
+    int ** const firstneigh = list->firstneigh;
+    const double * const * const x = atom->x;
+    const int * const type = atom->type;
+    const int * const mask = atom->mask;
+    const int nlocal = atom->nlocal;
+    const double * const special_coul = force->special_coul;
+    const double * const special_lj = force->special_lj;
+    const int newton_pair = force->newton_pair;
+
+    for (ii = ifrom; ii < ito; ii++) {
+      i = ilist[ii];
+      if (!(mask[i] & groupbit)) continue;
+      xtmp = x[i][0];
+      ytmp = x[i][1];
+      ztmp = x[i][2];
+      itype = type[i];
+      const int *jlist = firstneigh[i];
+      jnum = numneigh[i];
+
+      for (jj = 0; jj < jnum; jj++) {
+        j = jlist[jj];
+        factor_lj = special_lj[sbmask(j)];
+        factor_coul = special_coul[sbmask(j)];
+        j &= NEIGHMASK;
+
+        if (factor_lj == 0.0 && factor_coul == 0.0) continue;
+
+        if (!(mask[j] & groupbit)) continue;
+        jtype = type[j];
+        ipair = nrdfpair[itype][jtype];
+        jpair = nrdfpair[jtype][itype];
+        if (!ipair && !jpair) continue;
+
+        delx = xtmp - x[j][0];
+        dely = ytmp - x[j][1];
+        delz = ztmp - x[j][2];
+        r = sqrt(delx*delx + dely*dely + delz*delz);
+        ibin = static_cast<int> (r*delrinv);
+        if (ibin >= nbin) continue;
+
+        for (ihisto = 0; ihisto < ipair; ihisto++) {
+          m = rdfpair[ihisto][itype][jtype];
+          h[m*nbin+ibin] += 1.0;
+        }
+        if (newton_pair || j < nlocal) {
+          for (ihisto = 0; ihisto < jpair; ihisto++) {
+            m = rdfpair[ihisto][jtype][itype];
+            h[m*nbin+ibin] += 1.0;
+          }
+        }
+      }
+    }
+  }
+
+  // sum bins of all threads, in thread order for reproducible results
+
+  double *hall = hist[0];
+  for (int m = 0; m < nhist; m++) {
+    double sum = 0.0;
+    for (int t = 0; t < nthreads; t++) sum += histthr[t][m];
+    hall[m] = sum;
+  }
+}
@@ -0,0 +1,43 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://lammps.sandia.gov/, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef COMPUTE_CLASS
+
+ComputeStyle(rdf/omp,ComputeRDFOMP)
+
+#else
+
+#ifndef LMP_COMPUTE_RDF_OMP_H
+#define LMP_COMPUTE_RDF_OMP_H
+
+#include "compute_rdf.h"
+
+namespace LAMMPS_NS {
+
+class ComputeRDFOMP : public ComputeRDF {
+ public:
+  ComputeRDFOMP(class LAMMPS *, int, char **);
+  ~ComputeRDFOMP();
+
+ protected:
+  void tally_pairs();
+
+ private:
+  int nthr;              // # of threads histthr is allocated for
+  double **histthr;      // histogram bins of each thread
+};
+
+}
+
+#endif
+#endif
@@ -227,6 +227,14 @@ void EwaldOMP::compute(int eflag, int vflag)
   }
 
   if (slabflag == 1) slabcorr();
+
+  // reference for incremental energy changes
+
+  if (eflag_global) {
+    sfac_current = 1;
+    energy_sfac = energy;
+    qsum_sfac = qsum;
+  }
 }
 
 /* ---------------------------------------------------------------------- */
@@ -464,3 +464,345 @@ void MSMOMP::direct_peratom(const int nn)
 
   }
 }
+
+/* ----------------------------------------------------------------------
+   tabulate for each coarse grid point of level n+1 along dimension dim
+   the list of contributing fine grid points of level n and their weights.
+   the non-periodic boundary checks are applied here once, so that the
+   threaded loops over the 3d grid only have to run over the tables.
+   each list holds up to order+1 entries and starts at c*(order+1).
+------------------------------------------------------------------------- */
+
+void MSMOMP::restriction_stencil(int dim, int n, int *index,
+                                 int *cnt, int *fidx, double *w)
+{
+  const int p = order-1;
+  const int ns = p+2;
+  int clo,chi,ratio,periodic,hi;
+
+  if (dim == 0) {
+    clo = nxlo_in[n+1]; chi = nxhi_in[n+1];
+    ratio = static_cast<int> (delxinv[n]/delxinv[n+1]);
+    periodic = domain->xperiodic; hi = betax[n];
+  } else if (dim == 1) {
+    clo = nylo_in[n+1]; chi = nyhi_in[n+1];
+    ratio = static_cast<int> (delyinv[n]/delyinv[n+1]);
+    periodic = domain->yperiodic; hi = betay[n];
+  } else {
+    clo = nzlo_in[n+1]; chi = nzhi_in[n+1];
+    ratio = static_cast<int> (delzinv[n]/delzinv[n+1]);
+    periodic = domain->zperiodic; hi = betaz[n];
+  }
+
+  for (int c = clo; c <= chi; c++) {
+    const int m = c - clo;
+    const int fc = c * ratio;
+    cnt[m] = 0;
+    for (int k = 0; k < ns; k++) {
+      const int f = fc + index[k];
+      if (!periodic) {
+        if (f < alpha[n]) continue;
+        if (f > hi) break;
+      }
+      fidx[m*ns + cnt[m]] = f;
+      w[m*ns + cnt[m]] = phi1d[dim][k];
+      cnt[m]++;
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   tabulate for each fine grid point of level n along dimension dim the
+   list of coarse grid points of level n+1 that it receives a contribution
+   from during prolongation. this transposes the scatter of the serial
+   version into a gather, so that each fine grid point is updated by
+   exactly one thread. returns the number of fine grid points and sets
+   flo to the index of the first one.
+------------------------------------------------------------------------- */
+
+int MSMOMP::prolongation_stencil(int dim, int n, int *index, int &flo,
+                                 int *cnt, int *cidx, double *w)
+{
+  const int p = order-1;
+  const int ns = p+2;
+  int clo,chi,ratio,periodic,hi;
+
+  if (dim == 0) {
+    clo = nxlo_in[n+1]; chi = nxhi_in[n+1];
+    ratio = static_cast<int> (delxinv[n]/delxinv[n+1]);
+    periodic = domain->xperiodic; hi = betax[n];
+  } else if (dim == 1) {
+    clo = nylo_in[n+1]; chi = nyhi_in[n+1];
+    ratio = static_cast<int> (delyinv[n]/delyinv[n+1]);
+    periodic = domain->yperiodic; hi = betay[n];
+  } else {
+    clo = nzlo_in[n+1]; chi = nzhi_in[n+1];
+    ratio = static_cast<int> (delzinv[n]/delzinv[n+1]);
+    periodic = domain->zperiodic; hi = betaz[n];
+  }
+
+  flo = clo*ratio - p;
+  const int nf = (chi - clo)*ratio + 2*p + 1;
+  for (int m = 0; m < nf; m++) cnt[m] = 0;
+
+  // coarse points are visited in ascending order, so the contributions
+  // are accumulated in the same order as in MSM::prolongation()
+
+  for (int c = clo; c <= chi; c++) {
+    const int fc = c * ratio;
+    for (int k = 0; k < ns; k++) {
+      const int f = fc + index[k];
+      if (!periodic) {
+        if (f < alpha[n]) continue;
+        if (f > hi) break;
+      }
+      const int m = f - flo;
+      cidx[m*ns + cnt[m]] = c;
+      w[m*ns + cnt[m]] = phi1d[dim][k];
+      cnt[m]++;
+    }
+  }
+  return nf;
+}
+
+/* ----------------------------------------------------------------------
+   MSM restriction procedure for intermediate grid levels, calculate
+   charge density on coarser grid. each coarse grid point is only
+   written by a single thread.
+------------------------------------------------------------------------- */
+
+void MSMOMP::restriction(int n)
+{
+  const int p = order-1;
+  const int ns = p+2;
+
+  double * _noalias const * _noalias const * _noalias const qgrid2 = qgrid[n+1];
+  const double * _noalias const * _noalias const * _noalias const qgrid1 = qgrid[n];
+
+  int *index = new int[ns];
+  setup_stencil(n,index);
+
+  const int nxlo_c = nxlo_in[n+1];
+  const int nylo_c = nylo_in[n+1];
+  const int nzlo_c = nzlo_in[n+1];
+  const int numx = nxhi_in[n+1] - nxlo_c + 1;
+  const int numy = nyhi_in[n+1] - nylo_c + 1;
+  const int numz = nzhi_in[n+1] - nzlo_c + 1;
+
+  int * const xcnt = new int[numx];
+  int * const ycnt = new int[numy];
+  int * const zcnt = new int[numz];
+  int * const xidx = new int[numx*ns];
+  int * const yidx = new int[numy*ns];
+  int * const zidx = new int[numz*ns];
+  double * const xw = new double[numx*ns];
+  double * const yw = new double[numy*ns];
+  double * const zw = new double[numz*ns];
+
+  restriction_stencil(0,n,index,xcnt,xidx,xw);
+  restriction_stencil(1,n,index,ycnt,yidx,yw);
+  restriction_stencil(2,n,index,zcnt,zidx,zw);
+
+  // zero out charge on coarser grid
+
+  memset(&(qgrid2[nzlo_out[n+1]][nylo_out[n+1]][nxlo_out[n+1]]),0,
+         ngrid[n+1]*sizeof(double));
+
+  // merge the two outer loops into one for better threading
+
+  const int inum = numz*numy;
+
+#if defined(_OPENMP)
+#pragma omp parallel LMP_DEFAULT_NONE
+#endif
+  {
+    int i,ifrom,ito,tid,a,b,c;
+
+    loop_setup_thr(ifrom, ito, tid, inum, comm->nthreads);
+    ThrData *thr = fix->get_thr(tid);
+    thr->timer(Timer::START);
+
+    for (i = ifrom; i < ito; ++i) {
+      const int mz = i/numy;
+      const int my = i - mz*numy;
+      const int kp = mz + nzlo_c;
+      const int jp = my + nylo_c;
+
+      for (int mx = 0; mx < numx; ++mx) {
+        double q2sum = 0.0;
+
+        for (a = 0; a < zcnt[mz]; ++a) {
+          const int kk = zidx[mz*ns+a];
+          const double phiz = zw[mz*ns+a];
+          for (b = 0; b < ycnt[my]; ++b) {
+            const int jj = yidx[my*ns+b];
+            const double phizy = yw[my*ns+b]*phiz;
+            const double * _noalias const qgrid1kj = qgrid1[kk][jj];
+            for (c = 0; c < xcnt[mx]; ++c)
+              q2sum += qgrid1kj[xidx[mx*ns+c]] * xw[mx*ns+c]*phizy;
+          }
+        }
+        qgrid2[kp][jp][mx + nxlo_c] += q2sum;
+      }
+    }
+    thr->timer(Timer::KSPACE);
+  } // end of omp parallel region
+
+  delete[] index;
+  delete[] xcnt;
+  delete[] ycnt;
+  delete[] zcnt;
+  delete[] xidx;
+  delete[] yidx;
+  delete[] zidx;
+  delete[] xw;
+  delete[] yw;
+  delete[] zw;
+}
+
+/* ----------------------------------------------------------------------
+   MSM prolongation procedure for intermediate grid levels, interpolate
+   per-atom energy/virial from coarser grid to finer grid
+------------------------------------------------------------------------- */
+
+void MSMOMP::prolongation(int n)
+{
+  if (vflag_atom)
+    prolongation_eval<1>(n);
+  else
+    prolongation_eval<0>(n);
+}
+
+template <int VFLAG_ATOM>
+void MSMOMP::prolongation_eval(const int n)
+{
+  const int p = order-1;
+  const int ns = p+2;
+
+  double * _noalias const * _noalias const * _noalias const egrid1 = egrid[n];
+  double * _noalias const * _noalias const * _noalias const v0grid1 = v0grid[n];
+  double * _noalias const * _noalias const * _noalias const v1grid1 = v1grid[n];
+  double * _noalias const * _noalias const * _noalias const v2grid1 = v2grid[n];
+  double * _noalias const * _noalias const * _noalias const v3grid1 = v3grid[n];
+  double * _noalias const * _noalias const * _noalias const v4grid1 = v4grid[n];
+  double * _noalias const * _noalias const * _noalias const v5grid1 = v5grid[n];
+  const double * _noalias const * _noalias const * _noalias const egrid2 = egrid[n+1];
+  const double * _noalias const * _noalias const * _noalias const v0grid2 = v0grid[n+1];
+  const double * _noalias const * _noalias const * _noalias const v1grid2 = v1grid[n+1];
+  const double * _noalias const * _noalias const * _noalias const v2grid2 = v2grid[n+1];
+  const double * _noalias const * _noalias const * _noalias const v3grid2 = v3grid[n+1];
+  const double * _noalias const * _noalias const * _noalias const v4grid2 = v4grid[n+1];
+  const double * _noalias const * _noalias const * _noalias const v5grid2 = v5grid[n+1];
+
+  int *index = new int[ns];
+  setup_stencil(n,index);
+
+  // upper bound for the number of fine grid points in each dimension
+
+  const int nfxmax = (nxhi_in[n+1] - nxlo_in[n+1])*2 + 2*p + 1;
+  const int nfymax = (nyhi_in[n+1] - nylo_in[n+1])*2 + 2*p + 1;
+  const int nfzmax = (nzhi_in[n+1] - nzlo_in[n+1])*2 + 2*p + 1;
+
+  int * const xcnt = new int[nfxmax];
+  int * const ycnt = new int[nfymax];
+  int * const zcnt = new int[nfzmax];
+  int * const xidx = new int[nfxmax*ns];
+  int * const yidx = new int[nfymax*ns];
+  int * const zidx = new int[nfzmax*ns];
+  double * const xw = new double[nfxmax*ns];
+  double * const yw = new double[nfymax*ns];
+  double * const zw = new double[nfzmax*ns];
+
+  int flo;
+  const int nfx = prolongation_stencil(0,n,index,flo,xcnt,xidx,xw);
+  const int nxlo_f = flo;
+  const int nfy = prolongation_stencil(1,n,index,flo,ycnt,yidx,yw);
+  const int nylo_f = flo;
+  const int nfz = prolongation_stencil(2,n,index,flo,zcnt,zidx,zw);
+  const int nzlo_f = flo;
+
+  // merge the two outer loops over fine grid points into one
+
+  const int inum = nfz*nfy;
+
+#if defined(_OPENMP)
+#pragma omp parallel LMP_DEFAULT_NONE
+#endif
+  {
+    int i,ifrom,ito,tid,a,b,c;
+
+    loop_setup_thr(ifrom, ito, tid, inum, comm->nthreads);
+    ThrData *thr = fix->get_thr(tid);
+    thr->timer(Timer::START);
+
+    for (i = ifrom; i < ito; ++i) {
+      const int mz = i/nfy;
+      const int my = i - mz*nfy;
+      if ((zcnt[mz] == 0) || (ycnt[my] == 0)) continue;
+      const int kk = mz + nzlo_f;
+      const int jj = my + nylo_f;
+
+      for (int mx = 0; mx < nfx; ++mx) {
+        if (xcnt[mx] == 0) continue;
+        const int ii = mx + nxlo_f;
+
+        double etmp = egrid1[kk][jj][ii];
+        double v0tmp,v1tmp,v2tmp,v3tmp,v4tmp,v5tmp;
+        if (VFLAG_ATOM) {
+          v0tmp = v0grid1[kk][jj][ii];
+          v1tmp = v1grid1[kk][jj][ii];
+          v2tmp = v2grid1[kk][jj][ii];
+          v3tmp = v3grid1[kk][jj][ii];
+          v4tmp = v4grid1[kk][jj][ii];
+          v5tmp = v5grid1[kk][jj][ii];
+        }
+
+        for (a = 0; a < zcnt[mz]; ++a) {
+          const int kp = zidx[mz*ns+a];
+          const double phiz = zw[mz*ns+a];
+          for (b = 0; b < ycnt[my]; ++b) {
+            const int jp = yidx[my*ns+b];
+            const double phizy = yw[my*ns+b]*phiz;
+            for (c = 0; c < xcnt[mx]; ++c) {
+              const int ip = xidx[mx*ns+c];
+              const double phi3d = xw[mx*ns+c]*phizy;
+
+              etmp += egrid2[kp][jp][ip] * phi3d;
+
+              if (VFLAG_ATOM) {
+                v0tmp += v0grid2[kp][jp][ip] * phi3d;
+                v1tmp += v1grid2[kp][jp][ip] * phi3d;
+                v2tmp += v2grid2[kp][jp][ip] * phi3d;
+                v3tmp += v3grid2[kp][jp][ip] * phi3d;
+                v4tmp += v4grid2[kp][jp][ip] * phi3d;
+                v5tmp += v5grid2[kp][jp][ip] * phi3d;
+              }
+            }
+          }
+        }
+
+        egrid1[kk][jj][ii] = etmp;
+        if (VFLAG_ATOM) {
+          v0grid1[kk][jj][ii] = v0tmp;
+          v1grid1[kk][jj][ii] = v1tmp;
+          v2grid1[kk][jj][ii] = v2tmp;
+          v3grid1[kk][jj][ii] = v3tmp;
+          v4grid1[kk][jj][ii] = v4tmp;
+          v5grid1[kk][jj][ii] = v5tmp;
+        }
+      }
+    }
+    thr->timer(Timer::KSPACE);
+  } // end of omp parallel region
+
+  delete[] index;
+  delete[] xcnt;
+  delete[] ycnt;
+  delete[] zcnt;
+  delete[] xidx;
+  delete[] yidx;
+  delete[] zidx;
+  delete[] xw;
+  delete[] yw;
+  delete[] zw;
+}
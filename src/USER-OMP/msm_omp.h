@@ -33,10 +33,15 @@ namespace LAMMPS_NS {
  protected:
   virtual void direct(int);
   virtual void compute(int,int);
+  virtual void restriction(int);
+  virtual void prolongation(int);
 
  private:
   template <int, int, int> void direct_eval(int);
   template <int> void direct_peratom(int);
+  template <int> void prolongation_eval(int);
+  void restriction_stencil(int, int, int *, int *, int *, double *);
+  int prolongation_stencil(int, int, int *, int &, int *, int *, double *);
 
 };
 
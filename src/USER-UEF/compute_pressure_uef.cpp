@@ -36,6 +36,7 @@ ComputePressureUef::ComputePressureUef(LAMMPS *lmp, int narg, char **arg) :
   ext_flags[1] = true;
   ext_flags[2] = true;
   in_fix=false;
+  partial_scalar_flag=partial_vector_flag=0;
 }
 
 /* ----------------------------------------------------------------------
@@ -29,6 +29,7 @@ ComputeTempUef::ComputeTempUef(LAMMPS *lmp, int narg, char **arg) :
   ComputeTemp(lmp, narg, arg)
 {
   rot_flag=true;
+  partial_vector_flag=0;
 }
 
 /* ----------------------------------------------------------------------
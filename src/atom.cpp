@@ -1035,58 +1035,10 @@ void Atom::data_atoms(int n, char *buf, tagint id_offset, tagint mol_offset,
   char **values = new char*[nwords];
 
   // set bounds for my proc
-  // if periodic and I am lo/hi proc, adjust bounds by EPSILON
-  // insures all data atoms will be owned even with round-off
 
   int triclinic = domain->triclinic;
-
-  double epsilon[3];
-  if (triclinic) epsilon[0] = epsilon[1] = epsilon[2] = EPSILON;
-  else {
-    epsilon[0] = domain->prd[0] * EPSILON;
-    epsilon[1] = domain->prd[1] * EPSILON;
-    epsilon[2] = domain->prd[2] * EPSILON;
-  }
-
   double sublo[3],subhi[3];
-  if (triclinic == 0) {
-    sublo[0] = domain->sublo[0]; subhi[0] = domain->subhi[0];
-    sublo[1] = domain->sublo[1]; subhi[1] = domain->subhi[1];
-    sublo[2] = domain->sublo[2]; subhi[2] = domain->subhi[2];
-  } else {
-    sublo[0] = domain->sublo_lamda[0]; subhi[0] = domain->subhi_lamda[0];
-    sublo[1] = domain->sublo_lamda[1]; subhi[1] = domain->subhi_lamda[1];
-    sublo[2] = domain->sublo_lamda[2]; subhi[2] = domain->subhi_lamda[2];
-  }
-
-  if (comm->layout != Comm::LAYOUT_TILED) {
-    if (domain->xperiodic) {
-      if (comm->myloc[0] == 0) sublo[0] -= epsilon[0];
-      if (comm->myloc[0] == comm->procgrid[0]-1) subhi[0] += epsilon[0];
-    }
-    if (domain->yperiodic) {
-      if (comm->myloc[1] == 0) sublo[1] -= epsilon[1];
-      if (comm->myloc[1] == comm->procgrid[1]-1) subhi[1] += epsilon[1];
-    }
-    if (domain->zperiodic) {
-      if (comm->myloc[2] == 0) sublo[2] -= epsilon[2];
-      if (comm->myloc[2] == comm->procgrid[2]-1) subhi[2] += epsilon[2];
-    }
-
-  } else {
-    if (domain->xperiodic) {
-      if (comm->mysplit[0][0] == 0.0) sublo[0] -= epsilon[0];
-      if (comm->mysplit[0][1] == 1.0) subhi[0] += epsilon[0];
-    }
-    if (domain->yperiodic) {
-      if (comm->mysplit[1][0] == 0.0) sublo[1] -= epsilon[1];
-      if (comm->mysplit[1][1] == 1.0) subhi[1] += epsilon[1];
-    }
-    if (domain->zperiodic) {
-      if (comm->mysplit[2][0] == 0.0) sublo[2] -= epsilon[2];
-      if (comm->mysplit[2][1] == 1.0) subhi[2] += epsilon[2];
-    }
-  }
+  data_subdomain(sublo,subhi);
 
   // xptr = which word in line starts xyz coords
   // iptr = which word in line starts ix,iy,iz image flags
@@ -1180,6 +1132,65 @@ void Atom::data_atoms(int n, char *buf, tagint id_offset, tagint mol_offset,
   delete [] values;
 }
 
+/* ----------------------------------------------------------------------
+   bounds of my sub-domain for assigning atoms read from data files
+   box coords for orthogonal, lamda coords for triclinic boxes
+   if periodic and I am lo/hi proc, adjust bounds by EPSILON
+   insures all data atoms will be owned even with round-off
+------------------------------------------------------------------------- */
+
+void Atom::data_subdomain(double *sublo, double *subhi)
+{
+  int triclinic = domain->triclinic;
+
+  double epsilon[3];
+  if (triclinic) epsilon[0] = epsilon[1] = epsilon[2] = EPSILON;
+  else {
+    epsilon[0] = domain->prd[0] * EPSILON;
+    epsilon[1] = domain->prd[1] * EPSILON;
+    epsilon[2] = domain->prd[2] * EPSILON;
+  }
+
+  if (triclinic == 0) {
+    sublo[0] = domain->sublo[0]; subhi[0] = domain->subhi[0];
+    sublo[1] = domain->sublo[1]; subhi[1] = domain->subhi[1];
+    sublo[2] = domain->sublo[2]; subhi[2] = domain->subhi[2];
+  } else {
+    sublo[0] = domain->sublo_lamda[0]; subhi[0] = domain->subhi_lamda[0];
+    sublo[1] = domain->sublo_lamda[1]; subhi[1] = domain->subhi_lamda[1];
+    sublo[2] = domain->sublo_lamda[2]; subhi[2] = domain->subhi_lamda[2];
+  }
+
+  if (comm->layout != Comm::LAYOUT_TILED) {
+    if (domain->xperiodic) {
+      if (comm->myloc[0] == 0) sublo[0] -= epsilon[0];
+      if (comm->myloc[0] == comm->procgrid[0]-1) subhi[0] += epsilon[0];
+    }
+    if (domain->yperiodic) {
+      if (comm->myloc[1] == 0) sublo[1] -= epsilon[1];
+      if (comm->myloc[1] == comm->procgrid[1]-1) subhi[1] += epsilon[1];
+    }
+    if (domain->zperiodic) {
+      if (comm->myloc[2] == 0) sublo[2] -= epsilon[2];
+      if (comm->myloc[2] == comm->procgrid[2]-1) subhi[2] += epsilon[2];
+    }
+
+  } else {
+    if (domain->xperiodic) {
+      if (comm->mysplit[0][0] == 0.0) sublo[0] -= epsilon[0];
+      if (comm->mysplit[0][1] == 1.0) subhi[0] += epsilon[0];
+    }
+    if (domain->yperiodic) {
+      if (comm->mysplit[1][0] == 0.0) sublo[1] -= epsilon[1];
+      if (comm->mysplit[1][1] == 1.0) subhi[1] += epsilon[1];
+    }
+    if (domain->zperiodic) {
+      if (comm->mysplit[2][0] == 0.0) sublo[2] -= epsilon[2];
+      if (comm->mysplit[2][1] == 1.0) subhi[2] += epsilon[2];
+    }
+  }
+}
+
 /* ----------------------------------------------------------------------
    unpack N lines from Velocity section of data file
    check that atom IDs are > 0 and <= map_tag_max
@@ -298,6 +298,7 @@ class Atom : protected Pointers {
   void deallocate_topology();
 
   void data_atoms(int, char *, tagint, tagint, int, int, double *);
+  void data_subdomain(double *, double *);
   void data_vels(int, char *, tagint);
   void data_bonds(int, char *, int *, tagint, int);
   void data_angles(int, char *, int *, tagint, int);
@@ -63,6 +63,9 @@ Compute::Compute(LAMMPS *lmp, int narg, char **arg) :
   scalar_flag = vector_flag = array_flag = 0;
   peratom_flag = local_flag = 0;
   size_vector_variable = size_array_rows_variable = 0;
+  partial_scalar_flag = partial_vector_flag = 0;
+  timer_detail = -1;
+  size_partial_scalar = size_partial_vector = 0;
 
   tempflag = pressflag = peflag = 0;
   pressatomflag = peatomflag = 0;
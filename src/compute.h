@@ -62,6 +62,13 @@ class Compute : protected Pointers {
   int *extlist;             // list of 0/1 int/ext for each vec component
   int extarray;             // 0/1 if global array is all intensive/extensive
 
+  int partial_scalar_flag;  // 0/1 if compute_scalar() can be split into
+                            //   partial_scalar() and reduce_scalar()
+  int partial_vector_flag;  // 0/1 if compute_vector() can be split into
+                            //   partial_vector() and reduce_vector()
+  int size_partial_scalar;  // # of per-proc sums for partial_scalar()
+  int size_partial_vector;  // # of per-proc sums for partial_vector()
+
   int tempflag;       // 1 if Compute can be used as temperature
                       // must have both compute_scalar, compute_vector
   int pressflag;      // 1 if Compute can be used as pressure (uses virial)
@@ -82,6 +89,7 @@ class Compute : protected Pointers {
   bigint *tlist;      // list of timesteps the Compute is called on
 
   int invoked_flag;       // non-zero if invoked or accessed this step, 0 if not
+  int timer_detail;       // id of detailed timer, -1 if none
   bigint invoked_scalar;  // last timestep on which compute_scalar() was invoked
   bigint invoked_vector;  // ditto for compute_vector()
   bigint invoked_array;   // ditto for compute_array()
@@ -116,6 +124,14 @@ class Compute : protected Pointers {
   virtual void compute_local() {}
   virtual void set_arrays(int) {}
 
+  // compute_scalar() = partial_scalar(), MPI_SUM of its values,
+  //   then reduce_scalar() on the summed values, same for vectors
+
+  virtual void partial_scalar(double *) {}
+  virtual double reduce_scalar(double *) {return 0.0;}
+  virtual void partial_vector(double *) {}
+  virtual void reduce_vector(double *) {}
+
   virtual int pack_forward_comm(int, int *, double *, int, int *) {return 0;}
   virtual void unpack_forward_comm(int, int, double *) {}
   virtual int pack_reverse_comm(int, int, double *) {return 0;}
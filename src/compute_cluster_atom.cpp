@@ -33,11 +33,13 @@ using namespace LAMMPS_NS;
 
 enum{CLUSTER,MASK,COORDS};
 
+#define BIG 1.0e20
+
 /* ---------------------------------------------------------------------- */
 
 ComputeClusterAtom::ComputeClusterAtom(LAMMPS *lmp, int narg, char **arg) :
   Compute(lmp, narg, arg),
-  clusterID(nullptr)
+  clusterID(nullptr), root(nullptr), rootID(nullptr)
 {
   if (narg != 4) error->all(FLERR,"Illegal compute cluster/atom command");
 
@@ -49,6 +51,7 @@ ComputeClusterAtom::ComputeClusterAtom(LAMMPS *lmp, int narg, char **arg) :
   comm_forward = 3;
 
   nmax = 0;
+  maxroot = 0;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -56,6 +59,8 @@ ComputeClusterAtom::ComputeClusterAtom(LAMMPS *lmp, int narg, char **arg) :
 ComputeClusterAtom::~ComputeClusterAtom()
 {
   memory->destroy(clusterID);
+  memory->destroy(root);
+  memory->destroy(rootID);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -151,52 +156,80 @@ void ComputeClusterAtom::compute_peratom()
     else clusterID[i] = 0;
   }
 
+  // join owned and ghost atoms within cutoff into connected components
+  // done once, since these pairs do not change while clusterIDs propagate
+  // root = union-find forest over atom indices, root[i] = i for a root
+
+  int nall = atom->nlocal + atom->nghost;
+  if (nall > maxroot) {
+    memory->destroy(root);
+    memory->destroy(rootID);
+    maxroot = atom->nmax;
+    memory->create(root,maxroot,"cluster/atom:root");
+    memory->create(rootID,maxroot,"cluster/atom:rootID");
+  }
+  for (i = 0; i < nall; i++) root[i] = i;
+
+  double **x = atom->x;
+
+  for (ii = 0; ii < inum; ii++) {
+    i = ilist[ii];
+    if (!(mask[i] & groupbit)) continue;
+
+    xtmp = x[i][0];
+    ytmp = x[i][1];
+    ztmp = x[i][2];
+    jlist = firstneigh[i];
+    jnum = numneigh[i];
+
+    for (jj = 0; jj < jnum; jj++) {
+      j = jlist[jj];
+      j &= NEIGHMASK;
+      if (!(mask[j] & groupbit)) continue;
+
+      delx = xtmp - x[j][0];
+      dely = ytmp - x[j][1];
+      delz = ztmp - x[j][2];
+      rsq = delx*delx + dely*dely + delz*delz;
+      if (rsq < cutsq) {
+        int iroot = find_root(i);
+        int jroot = find_root(j);
+        if (iroot < jroot) root[jroot] = iroot;
+        else if (jroot < iroot) root[iroot] = jroot;
+      }
+    }
+  }
+
   // loop until no more changes on any proc:
   // acquire clusterIDs of ghost atoms
-  // loop over my atoms, checking distance to neighbors
-  // if both atoms are in cluster, assign lowest clusterID to both
-  // iterate until no changes in my atoms
+  // assign lowest clusterID within each component to its owned atoms,
+  //   which reaches the same result as repeatedly sweeping the neighbor
+  //   pairs, but in a single pass over the atoms
   // then check if any proc made changes
 
   commflag = CLUSTER;
-  double **x = atom->x;
 
-  int change,done,anychange;
+  int change,anychange;
 
   while (1) {
     comm->forward_comm_compute(this);
 
+    for (i = 0; i < nall; i++) rootID[i] = BIG;
+    for (i = 0; i < nall; i++) {
+      if (!(mask[i] & groupbit)) continue;
+      int iroot = find_root(i);
+      rootID[iroot] = MIN(rootID[iroot],clusterID[i]);
+    }
+
     change = 0;
-    while (1) {
-      done = 1;
-      for (ii = 0; ii < inum; ii++) {
-        i = ilist[ii];
-        if (!(mask[i] & groupbit)) continue;
-
-        xtmp = x[i][0];
-        ytmp = x[i][1];
-        ztmp = x[i][2];
-        jlist = firstneigh[i];
-        jnum = numneigh[i];
-
-        for (jj = 0; jj < jnum; jj++) {
-          j = jlist[jj];
-          j &= NEIGHMASK;
-          if (!(mask[j] & groupbit)) continue;
-          if (clusterID[i] == clusterID[j]) continue;
-
-          delx = xtmp - x[j][0];
-          dely = ytmp - x[j][1];
-          delz = ztmp - x[j][2];
-          rsq = delx*delx + dely*dely + delz*delz;
-          if (rsq < cutsq) {
-            clusterID[i] = clusterID[j] = MIN(clusterID[i],clusterID[j]);
-            done = 0;
-          }
-        }
+    for (ii = 0; ii < inum; ii++) {
+      i = ilist[ii];
+      if (!(mask[i] & groupbit)) continue;
+      double newID = rootID[find_root(i)];
+      if (newID != clusterID[i]) {
+        clusterID[i] = newID;
+        change = 1;
       }
-      if (!done) change = 1;
-      if (done) break;
     }
 
     // stop if all procs are done
@@ -206,6 +239,20 @@ void ComputeClusterAtom::compute_peratom()
   }
 }
 
+/* ----------------------------------------------------------------------
+   return root of union-find tree containing atom i
+   halve the path on the way up, to keep the trees flat
+------------------------------------------------------------------------- */
+
+int ComputeClusterAtom::find_root(int i)
+{
+  while (root[i] != i) {
+    root[i] = root[root[i]];
+    i = root[i];
+  }
+  return i;
+}
+
 /* ---------------------------------------------------------------------- */
 
 int ComputeClusterAtom::pack_forward_comm(int n, int *list, double *buf,
@@ -268,5 +315,6 @@ void ComputeClusterAtom::unpack_forward_comm(int n, int first, double *buf)
 double ComputeClusterAtom::memory_usage()
 {
   double bytes = (double)nmax * sizeof(double);
+  bytes += (double)maxroot * (sizeof(int) + sizeof(double));
   return bytes;
 }
@@ -40,6 +40,12 @@ class ComputeClusterAtom : public Compute {
   double cutsq;
   class NeighList *list;
   double *clusterID;
+
+  int maxroot;           // size of root and rootID
+  int *root;             // union-find parent of each owned and ghost atom
+  double *rootID;        // lowest clusterID in the component of a root
+
+  int find_root(int);
 };
 
 }
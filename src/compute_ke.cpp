@@ -29,6 +29,8 @@ ComputeKE::ComputeKE(LAMMPS *lmp, int narg, char **arg) :
 
   scalar_flag = 1;
   extscalar = 1;
+  partial_scalar_flag = 1;
+  size_partial_scalar = 1;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -42,8 +44,17 @@ void ComputeKE::init()
 
 double ComputeKE::compute_scalar()
 {
-  invoked_scalar = update->ntimestep;
+  double ke,keall;
+
+  partial_scalar(&ke);
+  MPI_Allreduce(&ke,&keall,1,MPI_DOUBLE,MPI_SUM,world);
+  return reduce_scalar(&keall);
+}
 
+/* ---------------------------------------------------------------------- */
+
+void ComputeKE::partial_scalar(double *sum)
+{
   double **v = atom->v;
   double *rmass = atom->rmass;
   double *mass = atom->mass;
@@ -64,7 +75,15 @@ double ComputeKE::compute_scalar()
           (v[i][0]*v[i][0] + v[i][1]*v[i][1] + v[i][2]*v[i][2]);
   }
 
-  MPI_Allreduce(&ke,&scalar,1,MPI_DOUBLE,MPI_SUM,world);
-  scalar *= pfactor;
+  sum[0] = ke;
+}
+
+/* ---------------------------------------------------------------------- */
+
+double ComputeKE::reduce_scalar(double *sum)
+{
+  invoked_scalar = update->ntimestep;
+
+  scalar = sum[0] * pfactor;
   return scalar;
 }
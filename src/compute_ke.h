@@ -29,6 +29,8 @@ class ComputeKE : public Compute {
   ComputeKE(class LAMMPS *, int, char **);
   void init();
   double compute_scalar();
+  void partial_scalar(double *);
+  double reduce_scalar(double *);
 
  private:
   double pfactor;
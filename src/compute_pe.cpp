@@ -42,6 +42,8 @@ ComputePE::ComputePE(LAMMPS *lmp, int narg, char **arg) :
   extscalar = 1;
   peflag = 1;
   timeflag = 1;
+  partial_scalar_flag = 1;
+  size_partial_scalar = 1;
 
   if (narg == 3) {
     pairflag = 1;
@@ -75,8 +77,18 @@ ComputePE::ComputePE(LAMMPS *lmp, int narg, char **arg) :
 
 double ComputePE::compute_scalar()
 {
-  invoked_scalar = update->ntimestep;
-  if (update->eflag_global != invoked_scalar)
+  double one,all;
+
+  partial_scalar(&one);
+  MPI_Allreduce(&one,&all,1,MPI_DOUBLE,MPI_SUM,world);
+  return reduce_scalar(&all);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void ComputePE::partial_scalar(double *sum)
+{
+  if (update->eflag_global != update->ntimestep)
     error->all(FLERR,"Energy was not tallied on needed timestep");
 
   double one = 0.0;
@@ -90,8 +102,16 @@ double ComputePE::compute_scalar()
     if (improperflag && force->improper) one += force->improper->energy;
   }
 
-  MPI_Allreduce(&one,&scalar,1,MPI_DOUBLE,MPI_SUM,world);
+  sum[0] = one;
+}
+
+/* ---------------------------------------------------------------------- */
+
+double ComputePE::reduce_scalar(double *sum)
+{
+  invoked_scalar = update->ntimestep;
 
+  scalar = sum[0];
   if (kspaceflag && force->kspace) scalar += force->kspace->energy;
 
   if (pairflag && force->pair && force->pair->tail_flag) {
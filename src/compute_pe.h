@@ -30,6 +30,8 @@ class ComputePE : public Compute {
   ~ComputePE() {}
   void init() {}
   double compute_scalar();
+  void partial_scalar(double *);
+  double reduce_scalar(double *);
 
  private:
   int pairflag,bondflag,angleflag,dihedralflag,improperflag,kspaceflag,fixflag;
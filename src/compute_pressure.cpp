@@ -47,6 +47,9 @@ ComputePressure::ComputePressure(LAMMPS *lmp, int narg, char **arg) :
   extvector = 0;
   pressflag = 1;
   timeflag = 1;
+  partial_scalar_flag = partial_vector_flag = 1;
+  size_partial_scalar = 3;
+  size_partial_vector = 6;
 
   // store temperature ID used by pressure computation
   // insure it is valid for temperature computation
@@ -230,11 +233,48 @@ void ComputePressure::init()
 
 double ComputePressure::compute_scalar()
 {
-  invoked_scalar = update->ntimestep;
-  if (update->vflag_global != invoked_scalar)
+  double v[3],vall[3];
+
+  partial_scalar(v);
+  MPI_Allreduce(v,vall,3,MPI_DOUBLE,MPI_SUM,world);
+  return reduce_scalar(vall);
+}
+
+/* ----------------------------------------------------------------------
+   compute pressure tensor
+   assume KE tensor has already been computed
+------------------------------------------------------------------------- */
+
+void ComputePressure::compute_vector()
+{
+  double v[6],vall[6];
+
+  partial_vector(v);
+  MPI_Allreduce(v,vall,6,MPI_DOUBLE,MPI_SUM,world);
+  reduce_vector(vall);
+}
+
+/* ----------------------------------------------------------------------
+   diagonal of virial on this proc
+------------------------------------------------------------------------- */
+
+void ComputePressure::partial_scalar(double *v)
+{
+  if (update->vflag_global != update->ntimestep)
     error->all(FLERR,"Virial was not tallied on needed timestep");
 
-  // invoke temperature if it hasn't been already
+  v[2] = 0.0;
+  virial_sum(dimension,v);
+}
+
+/* ----------------------------------------------------------------------
+   total pressure from virial summed across procs
+   invoke temperature if it hasn't been already
+------------------------------------------------------------------------- */
+
+double ComputePressure::reduce_scalar(double *vall)
+{
+  invoked_scalar = update->ntimestep;
 
   double t;
   if (keflag) {
@@ -245,7 +285,7 @@ double ComputePressure::compute_scalar()
 
   if (dimension == 3) {
     inv_volume = 1.0 / (domain->xprd * domain->yprd * domain->zprd);
-    virial_compute(3,3);
+    virial_reduce(3,3,vall);
     if (keflag)
       scalar = (temperature->dof * boltz * t +
                 virial[0] + virial[1] + virial[2]) / 3.0 * inv_volume * nktv2p;
@@ -253,7 +293,7 @@ double ComputePressure::compute_scalar()
       scalar = (virial[0] + virial[1] + virial[2]) / 3.0 * inv_volume * nktv2p;
   } else {
     inv_volume = 1.0 / (domain->xprd * domain->yprd);
-    virial_compute(2,2);
+    virial_reduce(2,2,vall);
     if (keflag)
       scalar = (temperature->dof * boltz * t +
                 virial[0] + virial[1]) / 2.0 * inv_volume * nktv2p;
@@ -265,21 +305,31 @@ double ComputePressure::compute_scalar()
 }
 
 /* ----------------------------------------------------------------------
-   compute pressure tensor
-   assume KE tensor has already been computed
+   virial tensor on this proc
 ------------------------------------------------------------------------- */
 
-void ComputePressure::compute_vector()
+void ComputePressure::partial_vector(double *v)
 {
-  invoked_vector = update->ntimestep;
-  if (update->vflag_global != invoked_vector)
+  if (update->vflag_global != update->ntimestep)
     error->all(FLERR,"Virial was not tallied on needed timestep");
 
   if (force->kspace && kspace_virial && force->kspace->scalar_pressure_flag)
     error->all(FLERR,"Must use 'kspace_modify pressure/scalar no' for "
                "tensor components with kspace_style msm");
 
-  // invoke temperature if it hasn't been already
+  v[4] = v[5] = 0.0;
+  if (dimension == 3) virial_sum(6,v);
+  else virial_sum(4,v);
+}
+
+/* ----------------------------------------------------------------------
+   pressure tensor from virial summed across procs
+   invoke temperature if it hasn't been already
+------------------------------------------------------------------------- */
+
+void ComputePressure::reduce_vector(double *vall)
+{
+  invoked_vector = update->ntimestep;
 
   double *ke_tensor;
   if (keflag) {
@@ -290,7 +340,7 @@ void ComputePressure::compute_vector()
 
   if (dimension == 3) {
     inv_volume = 1.0 / (domain->xprd * domain->yprd * domain->zprd);
-    virial_compute(6,3);
+    virial_reduce(6,3,vall);
     if (keflag) {
       for (int i = 0; i < 6; i++)
         vector[i] = (ke_tensor[i] + virial[i]) * inv_volume * nktv2p;
@@ -299,7 +349,7 @@ void ComputePressure::compute_vector()
         vector[i] = virial[i] * inv_volume * nktv2p;
   } else {
     inv_volume = 1.0 / (domain->xprd * domain->yprd);
-    virial_compute(4,2);
+    virial_reduce(4,2,vall);
     if (keflag) {
       vector[0] = (ke_tensor[0] + virial[0]) * inv_volume * nktv2p;
       vector[1] = (ke_tensor[1] + virial[1]) * inv_volume * nktv2p;
@@ -317,22 +367,42 @@ void ComputePressure::compute_vector()
 /* ---------------------------------------------------------------------- */
 
 void ComputePressure::virial_compute(int n, int ndiag)
+{
+  double v[6],vall[6];
+
+  // sum virial across procs
+
+  virial_sum(n,v);
+  MPI_Allreduce(v,vall,n,MPI_DOUBLE,MPI_SUM,world);
+  virial_reduce(n,ndiag,vall);
+}
+
+/* ----------------------------------------------------------------------
+   sum contributions to virial from forces and fixes on this proc
+------------------------------------------------------------------------- */
+
+void ComputePressure::virial_sum(int n, double *v)
 {
   int i,j;
-  double v[6],*vcomponent;
+  double *vcomponent;
 
   for (i = 0; i < n; i++) v[i] = 0.0;
 
-  // sum contributions to virial from forces and fixes
-
   for (j = 0; j < nvirial; j++) {
     vcomponent = vptr[j];
     for (i = 0; i < n; i++) v[i] += vcomponent[i];
   }
+}
 
-  // sum virial across procs
+/* ----------------------------------------------------------------------
+   add contributions not summed across procs to virial summed across procs
+------------------------------------------------------------------------- */
+
+void ComputePressure::virial_reduce(int n, int ndiag, double *vall)
+{
+  int i;
 
-  MPI_Allreduce(v,virial,n,MPI_DOUBLE,MPI_SUM,world);
+  for (i = 0; i < n; i++) virial[i] = vall[i];
 
   // KSpace virial contribution is already summed across procs
 
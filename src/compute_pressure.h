@@ -31,6 +31,10 @@ class ComputePressure : public Compute {
   virtual void init();
   virtual double compute_scalar();
   virtual void compute_vector();
+  virtual void partial_scalar(double *);
+  virtual double reduce_scalar(double *);
+  virtual void partial_vector(double *);
+  virtual void reduce_vector(double *);
   void reset_extra_compute_fix(const char *);
 
  protected:
@@ -47,6 +51,8 @@ class ComputePressure : public Compute {
   int fixflag,kspaceflag;
 
   void virial_compute(int, int);
+  void virial_sum(int, double *);
+  void virial_reduce(int, int, double *);
 
  private:
   char *pstyle;
@@ -266,10 +266,7 @@ void ComputeRDF::init_norm()
 
 void ComputeRDF::compute_array()
 {
-  int i,j,m,ii,jj,inum,jnum,itype,jtype,ipair,jpair,ibin,ihisto;
-  double xtmp,ytmp,ztmp,delx,dely,delz,r;
-  int *ilist,*jlist,*numneigh,**firstneigh;
-  double factor_lj,factor_coul;
+  int m,ibin;
 
   if (natoms_old != atom->natoms) {
     dynamic = 1;
@@ -288,6 +285,76 @@ void ComputeRDF::compute_array()
 
   neighbor->build_one(list);
 
+  // tally the RDF on this proc
+
+  tally_pairs();
+
+  // sum histograms across procs
+
+  MPI_Allreduce(hist[0],histall[0],npairs*nbin,MPI_DOUBLE,MPI_SUM,world);
+
+  // convert counts to g(r) and coord(r) and copy into output array
+  // vfrac = fraction of volume in shell m
+  // npairs = number of pairs, corrected for duplicates
+  // duplicates = pairs in which both atoms are the same
+
+  double constant,vfrac,gr,ncoord,rlower,rupper,normfac;
+
+  if (domain->dimension == 3) {
+    constant = 4.0*MY_PI / (3.0*domain->xprd*domain->yprd*domain->zprd);
+
+    for (m = 0; m < npairs; m++) {
+      normfac = (icount[m] > 0) ? static_cast<double>(jcount[m])
+                - static_cast<double>(duplicates[m])/icount[m] : 0.0;
+      ncoord = 0.0;
+      for (ibin = 0; ibin < nbin; ibin++) {
+        rlower = ibin*delr;
+        rupper = (ibin+1)*delr;
+        vfrac = constant * (rupper*rupper*rupper - rlower*rlower*rlower);
+        if (vfrac * normfac != 0.0)
+          gr = histall[m][ibin] / (vfrac * normfac * icount[m]);
+        else gr = 0.0;
+        if (icount[m] != 0)
+          ncoord += gr * vfrac * normfac;
+        array[ibin][1+2*m] = gr;
+        array[ibin][2+2*m] = ncoord;
+      }
+    }
+
+  } else {
+    constant = MY_PI / (domain->xprd*domain->yprd);
+
+    for (m = 0; m < npairs; m++) {
+      ncoord = 0.0;
+      normfac = (icount[m] > 0) ? static_cast<double>(jcount[m])
+                - static_cast<double>(duplicates[m])/icount[m] : 0.0;
+      for (ibin = 0; ibin < nbin; ibin++) {
+        rlower = ibin*delr;
+        rupper = (ibin+1)*delr;
+        vfrac = constant * (rupper*rupper - rlower*rlower);
+        if (vfrac * normfac != 0.0)
+          gr = histall[m][ibin] / (vfrac * normfac * icount[m]);
+        else gr = 0.0;
+        if (icount[m] != 0)
+          ncoord += gr * vfrac * normfac;
+        array[ibin][1+2*m] = gr;
+        array[ibin][2+2*m] = ncoord;
+      }
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   zero hist and tally pairs of neighbor list into it
+------------------------------------------------------------------------- */
+
+void ComputeRDF::tally_pairs()
+{
+  int i,j,m,ii,jj,inum,jnum,itype,jtype,ipair,jpair,ibin,ihisto;
+  double xtmp,ytmp,ztmp,delx,dely,delz,r;
+  int *ilist,*jlist,*numneigh,**firstneigh;
+  double factor_lj,factor_coul;
+
   inum = list->inum;
   ilist = list->ilist;
   numneigh = list->numneigh;
@@ -361,58 +428,4 @@ void ComputeRDF::compute_array()
       }
     }
   }
-
-  // sum histograms across procs
-
-  MPI_Allreduce(hist[0],histall[0],npairs*nbin,MPI_DOUBLE,MPI_SUM,world);
-
-  // convert counts to g(r) and coord(r) and copy into output array
-  // vfrac = fraction of volume in shell m
-  // npairs = number of pairs, corrected for duplicates
-  // duplicates = pairs in which both atoms are the same
-
-  double constant,vfrac,gr,ncoord,rlower,rupper,normfac;
-
-  if (domain->dimension == 3) {
-    constant = 4.0*MY_PI / (3.0*domain->xprd*domain->yprd*domain->zprd);
-
-    for (m = 0; m < npairs; m++) {
-      normfac = (icount[m] > 0) ? static_cast<double>(jcount[m])
-                - static_cast<double>(duplicates[m])/icount[m] : 0.0;
-      ncoord = 0.0;
-      for (ibin = 0; ibin < nbin; ibin++) {
-        rlower = ibin*delr;
-        rupper = (ibin+1)*delr;
-        vfrac = constant * (rupper*rupper*rupper - rlower*rlower*rlower);
-        if (vfrac * normfac != 0.0)
-          gr = histall[m][ibin] / (vfrac * normfac * icount[m]);
-        else gr = 0.0;
-        if (icount[m] != 0)
-          ncoord += gr * vfrac * normfac;
-        array[ibin][1+2*m] = gr;
-        array[ibin][2+2*m] = ncoord;
-      }
-    }
-
-  } else {
-    constant = MY_PI / (domain->xprd*domain->yprd);
-
-    for (m = 0; m < npairs; m++) {
-      ncoord = 0.0;
-      normfac = (icount[m] > 0) ? static_cast<double>(jcount[m])
-                - static_cast<double>(duplicates[m])/icount[m] : 0.0;
-      for (ibin = 0; ibin < nbin; ibin++) {
-        rlower = ibin*delr;
-        rupper = (ibin+1)*delr;
-        vfrac = constant * (rupper*rupper - rlower*rlower);
-        if (vfrac * normfac != 0.0)
-          gr = histall[m][ibin] / (vfrac * normfac * icount[m]);
-        else gr = 0.0;
-        if (icount[m] != 0)
-          ncoord += gr * vfrac * normfac;
-        array[ibin][1+2*m] = gr;
-        array[ibin][2+2*m] = ncoord;
-      }
-    }
-  }
 }
@@ -32,7 +32,7 @@ class ComputeRDF : public Compute {
   void init_list(int, class NeighList *);
   void compute_array();
 
- private:
+ protected:
   int nbin;              // # of rdf bins
   int cutflag;           // user cutoff flag
   int npairs;            // # of rdf pairs
@@ -51,6 +51,7 @@ class ComputeRDF : public Compute {
 
   class NeighList *list; // half neighbor list
   void init_norm();
+  virtual void tally_pairs();
   bigint natoms_old;
 };
 
@@ -34,6 +34,9 @@ ComputeTemp::ComputeTemp(LAMMPS *lmp, int narg, char **arg) :
   extscalar = 0;
   extvector = 1;
   tempflag = 1;
+  partial_scalar_flag = partial_vector_flag = 1;
+  size_partial_scalar = 1;
+  size_partial_vector = 6;
 
   vector = new double[size_vector];
 }
@@ -71,8 +74,30 @@ void ComputeTemp::dof_compute()
 
 double ComputeTemp::compute_scalar()
 {
-  invoked_scalar = update->ntimestep;
+  double t,tall;
+
+  partial_scalar(&t);
+  MPI_Allreduce(&t,&tall,1,MPI_DOUBLE,MPI_SUM,world);
+  return reduce_scalar(&tall);
+}
+
+/* ---------------------------------------------------------------------- */
 
+void ComputeTemp::compute_vector()
+{
+  double t[6],tall[6];
+
+  partial_vector(t);
+  MPI_Allreduce(t,tall,6,MPI_DOUBLE,MPI_SUM,world);
+  reduce_vector(tall);
+}
+
+/* ----------------------------------------------------------------------
+   sum of m v^2 over my atoms
+------------------------------------------------------------------------- */
+
+void ComputeTemp::partial_scalar(double *sum)
+{
   double **v = atom->v;
   double *mass = atom->mass;
   double *rmass = atom->rmass;
@@ -93,7 +118,16 @@ double ComputeTemp::compute_scalar()
           mass[type[i]];
   }
 
-  MPI_Allreduce(&t,&scalar,1,MPI_DOUBLE,MPI_SUM,world);
+  sum[0] = t;
+}
+
+/* ---------------------------------------------------------------------- */
+
+double ComputeTemp::reduce_scalar(double *sum)
+{
+  invoked_scalar = update->ntimestep;
+
+  scalar = sum[0];
   if (dynamic) dof_compute();
   if (dof < 0.0 && natoms_temp > 0.0)
     error->all(FLERR,"Temperature compute degrees of freedom < 0");
@@ -101,14 +135,14 @@ double ComputeTemp::compute_scalar()
   return scalar;
 }
 
-/* ---------------------------------------------------------------------- */
+/* ----------------------------------------------------------------------
+   sum of m v v tensor over my atoms
+------------------------------------------------------------------------- */
 
-void ComputeTemp::compute_vector()
+void ComputeTemp::partial_vector(double *t)
 {
   int i;
 
-  invoked_vector = update->ntimestep;
-
   double **v = atom->v;
   double *mass = atom->mass;
   double *rmass = atom->rmass;
@@ -116,7 +150,7 @@ void ComputeTemp::compute_vector()
   int *mask = atom->mask;
   int nlocal = atom->nlocal;
 
-  double massone,t[6];
+  double massone;
   for (i = 0; i < 6; i++) t[i] = 0.0;
 
   for (i = 0; i < nlocal; i++)
@@ -130,7 +164,13 @@ void ComputeTemp::compute_vector()
       t[4] += massone * v[i][0]*v[i][2];
       t[5] += massone * v[i][1]*v[i][2];
     }
+}
+
+/* ---------------------------------------------------------------------- */
+
+void ComputeTemp::reduce_vector(double *t)
+{
+  invoked_vector = update->ntimestep;
 
-  MPI_Allreduce(t,vector,6,MPI_DOUBLE,MPI_SUM,world);
-  for (i = 0; i < 6; i++) vector[i] *= force->mvv2e;
+  for (int i = 0; i < 6; i++) vector[i] = t[i] * force->mvv2e;
 }
@@ -32,6 +32,10 @@ class ComputeTemp : public Compute {
   void setup();
   virtual double compute_scalar();
   virtual void compute_vector();
+  virtual void partial_scalar(double *);
+  virtual double reduce_scalar(double *);
+  virtual void partial_vector(double *);
+  virtual void reduce_vector(double *);
 
  protected:
   double tfactor;
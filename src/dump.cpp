@@ -17,6 +17,7 @@
 #include "compute.h"
 #include "domain.h"
 #include "error.h"
+#include "file_writer.h"
 #include "fix.h"
 #include "group.h"
 #include "irregular.h"
@@ -25,6 +26,7 @@
 #include "output.h"
 #include "update.h"
 
+#include <algorithm>
 #include <cstring>
 
 using namespace LAMMPS_NS;
@@ -36,6 +38,7 @@ Dump *Dump::dumpptr;
 
 #define BIG 1.0e20
 #define EPSILON 1.0e-6
+#define NSAMPLE 64
 
 enum{ASCEND,DESCEND};
 
@@ -73,10 +76,13 @@ Dump::Dump(LAMMPS *lmp, int /*narg*/, char **arg) : Pointers(lmp)
   refresh = nullptr;
 
   clearstep = 0;
+  timer_detail = -1;
   sort_flag = 0;
   append_flag = 0;
   buffer_allow = 0;
   buffer_flag = 0;
+  async_allow = 0;
+  async_flag = 0;
   padflag = 0;
   pbcflag = 0;
   time_flag = 0;
@@ -98,6 +104,13 @@ Dump::Dump(LAMMPS *lmp, int /*narg*/, char **arg) : Pointers(lmp)
   maxsbuf = 0;
   sbuf = nullptr;
 
+  async_index = 0;
+  maxasync[0] = maxasync[1] = 0;
+  asyncbuf[0] = asyncbuf[1] = nullptr;
+  asynccount[0] = asynccount[1] = nullptr;
+  async_thread = nullptr;
+  async_active = 0;
+
   maxpbc = 0;
   xpbc = vpbc = nullptr;
   imagepbc = nullptr;
@@ -150,6 +163,8 @@ Dump::Dump(LAMMPS *lmp, int /*narg*/, char **arg) : Pointers(lmp)
 
 Dump::~Dump()
 {
+  async_wait(0);
+
   delete [] id;
   delete [] style;
   delete [] filename;
@@ -176,6 +191,11 @@ Dump::~Dump()
 
   memory->destroy(sbuf);
 
+  for (int i = 0; i < 2; i++) {
+    memory->destroy(asyncbuf[i]);
+    memory->destroy(asynccount[i]);
+  }
+
   if (pbcflag) {
     memory->destroy(xpbc);
     memory->destroy(vpbc);
@@ -208,6 +228,10 @@ Dump::~Dump()
 
 void Dump::init()
 {
+  // styles may re-create format strings used by a pending async write
+
+  async_wait();
+
   init_style();
 
   if (!sort_flag) {
@@ -330,9 +354,20 @@ void Dump::write()
 
   if (delay_flag && update->ntimestep < delaystep) return;
 
+  // async = 1 if the data is written by a background thread
+  // only for dumps in the Output list, which waits for it before deleting,
+  //   not for temporary dumps, e.g. from write_dump
+  // it opens a new file per timestep once the previous snapshot is done
+
+  int async = 0;
+  if (async_flag && filewriter) {
+    int idump = output->find_dump(id);
+    if (idump >= 0 && output->dump[idump] == this) async = 1;
+  }
+
   // if file per timestep, open new file
 
-  if (multifile) openfile();
+  if (multifile && !async) openfile();
 
   // simulation box bounds
 
@@ -377,7 +412,7 @@ void Dump::write()
   if (multiproc)
     MPI_Allreduce(&bnme,&nheader,1,MPI_LMP_BIGINT,MPI_SUM,clustercomm);
 
-  if (filewriter) write_header(nheader);
+  if (filewriter && !async) write_header(nheader);
 
   // insure buf is sized for packing and communicating
   // use nmax to insure filewriter proc can receive info from others
@@ -457,9 +492,13 @@ void Dump::write()
   MPI_Status status;
   MPI_Request request;
 
+  // comm buf or sbuf into snapshot, output by background thread
+
+  if (async) write_async(nheader);
+
   // comm and output buf of doubles
 
-  if (buffer_flag == 0 || binary) {
+  else if (buffer_flag == 0 || binary) {
     if (filewriter) {
       for (int iproc = 0; iproc < nclusterprocs; iproc++) {
         if (iproc) {
@@ -472,7 +511,6 @@ void Dump::write()
 
         write_data(nlines,buf);
       }
-      if (flush_flag && fp) fflush(fp);
 
     } else {
       MPI_Recv(&tmp,0,MPI_INT,fileproc,0,world,MPI_STATUS_IGNORE);
@@ -493,7 +531,6 @@ void Dump::write()
 
         write_data(nchars,(double *) sbuf);
       }
-      if (flush_flag && fp) fflush(fp);
 
     } else {
       MPI_Recv(&tmp,0,MPI_INT,fileproc,0,world,MPI_STATUS_IGNORE);
@@ -514,16 +551,163 @@ void Dump::write()
 
   if (refreshflag) modify->compute[irefresh]->refresh();
 
-  // if file per timestep, close file if I am filewriter
+  // flush file, or close it if file per timestep
 
-  if (multifile) {
-    if (compressed) {
-      if (filewriter && fp != nullptr) pclose(fp);
+  if (!async) closefile();
+}
+
+/* ----------------------------------------------------------------------
+   filewriter gathers the data of all procs in its cluster into a snapshot
+   buffer and hands it to a background thread for formatting and output
+   2 snapshot buffers are used, so the next snapshot can be collected
+     while the previous one is still being written
+------------------------------------------------------------------------- */
+
+void Dump::write_async(bigint nheader)
+{
+  int tmp,nlines,nchars,nsize;
+  bigint need;
+  MPI_Status status;
+  MPI_Request request;
+
+  int ibuf = async_index;
+  memory->grow(asynccount[ibuf],nclusterprocs,"dump:asynccount");
+
+  // nsize = max # of doubles received from one proc
+  // strings are stored in snapshot padded to a multiple of doubles
+
+  int stringflag = buffer_flag && !binary;
+  if (stringflag) nsize = (maxsbuf + sizeof(double) - 1) / sizeof(double);
+  else nsize = maxbuf*size_one;
+
+  bigint offset = 0;
+  for (int iproc = 0; iproc < nclusterprocs; iproc++) {
+    need = offset + nsize;
+    if (need > maxasync[ibuf]) {
+      maxasync[ibuf] = MAX(need,maxasync[ibuf] + maxasync[ibuf]/2);
+      memory->grow(asyncbuf[ibuf],maxasync[ibuf],"dump:asyncbuf");
+    }
+    double *ptr = &asyncbuf[ibuf][offset];
+
+    if (stringflag) {
+      if (iproc) {
+        MPI_Irecv(ptr,maxsbuf,MPI_CHAR,me+iproc,0,world,&request);
+        MPI_Send(&tmp,0,MPI_INT,me+iproc,0,world);
+        MPI_Wait(&request,&status);
+        MPI_Get_count(&status,MPI_CHAR,&nchars);
+      } else {
+        nchars = nsme;
+        if (nchars) memcpy(ptr,sbuf,nchars);
+      }
+      asynccount[ibuf][iproc] = nchars;
+      offset += (nchars + sizeof(double) - 1) / sizeof(double);
     } else {
-      if (filewriter && fp != nullptr) fclose(fp);
+      if (iproc) {
+        MPI_Irecv(ptr,nsize,MPI_DOUBLE,me+iproc,0,world,&request);
+        MPI_Send(&tmp,0,MPI_INT,me+iproc,0,world);
+        MPI_Wait(&request,&status);
+        MPI_Get_count(&status,MPI_DOUBLE,&nlines);
+        nlines /= size_one;
+      } else {
+        nlines = nme;
+        if (nlines) memcpy(ptr,buf,sizeof(double)*nlines*size_one);
+      }
+      asynccount[ibuf][iproc] = nlines;
+      offset += (bigint) nlines*size_one;
     }
-    fp = nullptr;
   }
+
+  // header is written here since it uses current timestep and box
+  // only after the previous snapshot is complete
+
+  async_wait();
+  if (multifile) openfile();
+  write_header(nheader);
+
+  async_thread = new std::thread(&Dump::write_snapshot,this,ibuf);
+  async_index = 1 - ibuf;
+}
+
+/* ----------------------------------------------------------------------
+   write the data of one snapshot buffer to file, then flush or close it
+   runs in the background thread, so it must not use MPI
+------------------------------------------------------------------------- */
+
+void Dump::write_snapshot(int ibuf)
+{
+  int n;
+
+  // errors cannot be raised here, since error->one() and exceptions
+  //   must not leave the background thread
+  // store the message instead, async_wait() reports it
+
+  async_active = 1;
+  try {
+    int stringflag = buffer_flag && !binary;
+    bigint offset = 0;
+
+    for (int iproc = 0; iproc < nclusterprocs; iproc++) {
+      n = asynccount[ibuf][iproc];
+      write_data(n,&asyncbuf[ibuf][offset]);
+      if (stringflag) offset += (n + sizeof(double) - 1) / sizeof(double);
+      else offset += (bigint) n*size_one;
+    }
+
+    closefile();
+  } catch (std::exception &e) {
+    async_error = e.what();
+  }
+  async_active = 0;
+}
+
+/* ----------------------------------------------------------------------
+   wait until the background thread has written the previous snapshot
+   must be called before anything it uses is changed or deleted
+   errflag = 1: raise an error stored by the thread
+   errflag = 0: only warn, e.g. when called from a destructor
+------------------------------------------------------------------------- */
+
+void Dump::async_wait(int errflag)
+{
+  if (async_thread == nullptr) return;
+
+  async_thread->join();
+  delete async_thread;
+  async_thread = nullptr;
+
+  if (async_error.empty()) return;
+  std::string mesg = async_error;
+  async_error.clear();
+  if (errflag) error->one(FLERR,"Asynchronous dump output failed: {}",mesg);
+  else error->warning(FLERR,"Asynchronous dump output failed: {}",mesg);
+}
+
+/* ----------------------------------------------------------------------
+   report an error while writing data to file
+   inside the background thread, unwind to write_snapshot() instead
+------------------------------------------------------------------------- */
+
+void Dump::write_error(const std::string &file, int line,
+                       const std::string &mesg)
+{
+  if (async_active) throw FileWriterException(mesg);
+  error->one(file,line,mesg);
+}
+
+/* ----------------------------------------------------------------------
+   called by filewriter after each snapshot
+   flush the file, or close it if one file per timestep
+------------------------------------------------------------------------- */
+
+void Dump::closefile()
+{
+  if (multifile) {
+    if (fp != nullptr) {
+      if (compressed) pclose(fp);
+      else fclose(fp);
+    }
+    fp = nullptr;
+  } else if (flush_flag && fp) fflush(fp);
 }
 
 /* ----------------------------------------------------------------------
@@ -652,8 +836,11 @@ void Dump::sort()
     }
 
     // proclist[i] = which proc Ith datum will be sent to
+    // if reordering by IDs, use linear ID ranges consistent with init()
+    // else use splitters from a sample of all values,
+    //   so each proc receives a similar # of datums for any distribution
 
-    if (sortcol == 0) {
+    if (sortcol == 0 && reorderflag) {
       tagint min = MAXTAGINT;
       tagint max = 0;
       for (i = 0; i < nme; i++) {
@@ -674,28 +861,22 @@ void Dump::sort()
         proclist[i] = iproc;
       }
 
+    } else if (sortcol == 0) {
+      std::vector<SortSample<tagint>> keys(nme);
+      for (i = 0; i < nme; i++) keys[i] = {ids[i],me,i};
+      sample_sort_procs(keys,proclist);
+
     } else {
-      double min = BIG;
-      double max = -BIG;
-      for (i = 0; i < nme; i++) {
-        value = buf[i*size_one + sortcolm1];
-        min = MIN(min,value);
-        max = MAX(max,value);
-      }
-      double minall,maxall;
-      MPI_Allreduce(&min,&minall,1,MPI_DOUBLE,MPI_MIN,world);
-      MPI_Allreduce(&max,&maxall,1,MPI_DOUBLE,MPI_MAX,world);
-      double range = maxall-minall + EPSILON*(maxall-minall);
-      if (range == 0.0) range = EPSILON;
 
-      // proc assignment is inverted if sortorder = DESCEND
+      // negated values for DESCEND, so procs are in ascending key order
 
+      std::vector<SortSample<double>> keys(nme);
       for (i = 0; i < nme; i++) {
         value = buf[i*size_one + sortcolm1];
-        iproc = static_cast<int> ((value-minall)/range * nprocs);
-        if (sortorder == DESCEND) iproc = nprocs-1 - iproc;
-        proclist[i] = iproc;
+        if (sortorder == DESCEND) value = -value;
+        keys[i] = {value,me,i};
       }
+      sample_sort_procs(keys,proclist);
     }
 
     // create comm plan, grow recv bufs if necessary,
@@ -776,6 +957,63 @@ void Dump::sort()
     memcpy(&buf[i*size_one],&bufsort[index[i]*size_one],nbytes);
 }
 
+/* ----------------------------------------------------------------------
+   assign each key to a proc for a parallel sample sort
+   every proc contributes up to NSAMPLE evenly spaced keys
+   proc 0 sorts the samples and picks nprocs-1 splitters
+   keys carry their proc and index, so duplicate values are also split
+   proclist[i] = proc which receives Ith key
+------------------------------------------------------------------------- */
+
+template <typename T>
+void Dump::sample_sort_procs(std::vector<SortSample<T>> &keys, int *proclist)
+{
+  int i;
+  int n = keys.size();
+
+  int nsample = MIN(n,NSAMPLE);
+  std::vector<SortSample<T>> sample(nsample);
+  for (i = 0; i < nsample; i++)
+    sample[i] = keys[static_cast<bigint>(i)*n/nsample];
+
+  int nbytes = nsample*sizeof(SortSample<T>);
+  std::vector<int> recvcounts,displs;
+  std::vector<SortSample<T>> allsample;
+  if (me == 0) {
+    recvcounts.resize(nprocs);
+    displs.resize(nprocs);
+  }
+  MPI_Gather(&nbytes,1,MPI_INT,recvcounts.data(),1,MPI_INT,0,world);
+
+  if (me == 0) {
+    int ntotal = 0;
+    for (i = 0; i < nprocs; i++) {
+      displs[i] = ntotal;
+      ntotal += recvcounts[i];
+    }
+    allsample.resize(ntotal/sizeof(SortSample<T>));
+  }
+  MPI_Gatherv(sample.data(),nbytes,MPI_BYTE,allsample.data(),
+              recvcounts.data(),displs.data(),MPI_BYTE,0,world);
+
+  // splitter[k] = smallest key sent to proc k+1
+
+  std::vector<SortSample<T>> splitter(nprocs-1);
+  if (me == 0) {
+    std::sort(allsample.begin(),allsample.end());
+    bigint ntotal = allsample.size();
+    for (i = 1; i < nprocs; i++) {
+      if (ntotal) splitter[i-1] = allsample[MIN(i*ntotal/nprocs,ntotal-1)];
+      else splitter[i-1] = SortSample<T>();
+    }
+  }
+  MPI_Bcast(splitter.data(),(nprocs-1)*sizeof(SortSample<T>),MPI_BYTE,0,world);
+
+  for (i = 0; i < n; i++)
+    proclist[i] = std::upper_bound(splitter.begin(),splitter.end(),keys[i]) -
+      splitter.begin();
+}
+
 #if defined(LMP_QSORT)
 
 /* ----------------------------------------------------------------------
@@ -906,6 +1144,10 @@ void Dump::modify_params(int narg, char **arg)
 {
   if (narg == 0) error->all(FLERR,"Illegal dump_modify command");
 
+  // settings may be used by a pending async write
+
+  async_wait();
+
   int iarg = 0;
   while (iarg < narg) {
     if (strcmp(arg[iarg],"append") == 0) {
@@ -915,6 +1157,15 @@ void Dump::modify_params(int narg, char **arg)
       else error->all(FLERR,"Illegal dump_modify command");
       iarg += 2;
 
+    } else if (strcmp(arg[iarg],"async") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal dump_modify command");
+      if (strcmp(arg[iarg+1],"yes") == 0) async_flag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) async_flag = 0;
+      else error->all(FLERR,"Illegal dump_modify command");
+      if (async_flag && async_allow == 0)
+        error->all(FLERR,"Dump_modify async not allowed for this style");
+      iarg += 2;
+
     } else if (strcmp(arg[iarg],"buffer") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal dump_modify command");
       if (strcmp(arg[iarg+1],"yes") == 0) buffer_flag = 1;
@@ -16,6 +16,10 @@
 
 #include "pointers.h"  // IWYU pragma: export
 
+#include <string>
+#include <thread>
+#include <vector>
+
 namespace LAMMPS_NS {
 
 class Dump : protected Pointers {
@@ -27,6 +31,7 @@ class Dump : protected Pointers {
 
   int first_flag;            // 0 if no initial dump, 1 if yes initial dump
   int clearstep;             // 1 if dump invokes computes, 0 if not
+  int timer_detail;          // id of detailed timer, -1 if none
 
   int comm_forward;          // size of forward communication (0 if none)
   int comm_reverse;          // size of reverse communication (0 if none)
@@ -40,6 +45,7 @@ class Dump : protected Pointers {
   virtual ~Dump();
   void init();
   virtual void write();
+  void async_wait(int errflag = 1);
 
   virtual int pack_forward_comm(int, int *, double *, int, int *) {return 0;}
   virtual void unpack_forward_comm(int, int, double *) {}
@@ -69,6 +75,8 @@ class Dump : protected Pointers {
   int append_flag;           // 1 if open file in append mode, 0 if not
   int buffer_allow;          // 1 if style allows for buffer_flag, 0 if not
   int buffer_flag;           // 1 if buffer output as one big string, 0 if not
+  int async_allow;           // 1 if style allows for async_flag, 0 if not
+  int async_flag;            // 1 if file is written by a background thread
   int padflag;               // timestep padding in filename
   int pbcflag;               // 1 if remap dumped atoms via PBC, 0 if not
   int singlefile_opened;     // 1 = one big file, already opened, else 0
@@ -131,6 +139,14 @@ class Dump : protected Pointers {
   tagint *idsort;
   int *index,*proclist;
 
+  int async_index;            // which snapshot buffer to fill next
+  bigint maxasync[2];         // size of snapshot buffers in doubles
+  double *asyncbuf[2];        // snapshots of data from all procs in cluster
+  int *asynccount[2];         // # of lines or chars from each proc
+  std::thread *async_thread;  // thread writing previous snapshot, if any
+  int async_active;           // 1 while inside the background thread
+  std::string async_error;    // error message from the background thread
+
   double **xpbc,**vpbc;
   imageint *imagepbc;
   int maxpbc;
@@ -145,10 +161,29 @@ class Dump : protected Pointers {
   virtual void pack(tagint *) = 0;
   virtual int convert_string(int, double *) {return 0;}
   virtual void write_data(int, double *) = 0;
+  virtual void closefile();
   void pbc_allocate();
   double compute_time();
 
   void sort();
+
+  // key of one datum for the parallel sample sort in sort()
+  // proc and index break ties between equal values
+
+  template <typename T> struct SortSample {
+    T value;
+    int proc,index;
+    bool operator<(const SortSample &other) const {
+      if (value != other.value) return value < other.value;
+      if (proc != other.proc) return proc < other.proc;
+      return index < other.index;
+    }
+  };
+  template <typename T>
+  void sample_sort_procs(std::vector<SortSample<T>> &, int *);
+  void write_async(bigint);
+  void write_snapshot(int);
+  [[ noreturn ]] void write_error(const std::string &, int, const std::string &);
 #if defined(LMP_QSORT)
   static int idcompare(const void *, const void *);
   static int bufcompare(const void *, const void *);
@@ -221,6 +256,17 @@ E: Dump_modify buffer yes not allowed for this style
 
 Self-explanatory.
 
+E: Asynchronous dump output failed: %s
+
+The background thread writing a dump snapshot encountered an error.
+The error is reported at the next output of that dump or at the end
+of the run.
+
+E: Dump_modify async not allowed for this style
+
+This dump style does not write its file through the generic dump
+output path and thus cannot write it from a background thread.
+
 E: Cannot use dump_modify fileper without % in dump file name
 
 Self-explanatory.
@@ -17,6 +17,7 @@
 #include "atom.h"
 #include "atom_vec.h"
 #include "comm.h"
+#include "dump.h"
 #include "error.h"
 #include "force.h"
 #include "kspace.h"
@@ -26,9 +27,11 @@
 #include "neigh_list.h"
 #include "neigh_request.h"
 #include "neighbor.h"           // IWYU pragma: keep
+#include "output.h"
 #include "timer.h"              // IWYU pragma: keep
 #include "universe.h"
 #include "update.h"
+#include "write_restart.h"
 
 #include <cmath>
 #include <cstring>
@@ -73,6 +76,16 @@ void Finish::end(int flag)
 
   const int nthreads = comm->nthreads;
 
+  // complete dump snapshots and restart files still being written by
+  // background threads, so that the files are complete at the end of a run
+
+  for (i = 0; i < output->ndump; i++) output->dump[i]->async_wait();
+  if (output->restart) output->restart->async_wait();
+
+  // timeline of this run
+
+  if (timer->has_trace()) timer->write_trace();
+
   // recompute natoms in case atoms have been lost
 
   bigint nblocal = atom->nlocal;
@@ -395,6 +408,13 @@ void Finish::end(int flag)
   }
 #endif
 
+  // detailed timers of fixes, computes, dumps, and sub-styles
+
+  if (timeflag && timer->has_detail()) {
+    std::string mesg = timer->detail_summary(time_loop);
+    if (me == 0 && !mesg.empty()) utils::logmesg(lmp,mesg);
+  }
+
   if ((comm->me == 0) && lmp->kokkos && (lmp->kokkos->ngpus > 0))
     if (const char* env_clb = getenv("CUDA_LAUNCH_BLOCKING"))
       if (!(strcmp(env_clb,"1") == 0)) {
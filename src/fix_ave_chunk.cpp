@@ -393,13 +393,11 @@ FixAveChunk::FixAveChunk(LAMMPS *lmp, int narg, char **arg) :
   allocate();
 
   // nvalid = next step on which end_of_step does something
-  // add nvalid to all computes that store invocation times
-  // since don't know a priori which are invoked by this fix
+  // init() adds nvalid to computes this fix may invoke
   // once in end_of_step() can set timestep for ones actually invoked
 
   nvalid_last = -1;
   nvalid = nextvalid();
-  modify->addstep_compute_all(nvalid);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -517,8 +515,11 @@ void FixAveChunk::init()
   if (nvalid < update->ntimestep) {
     irepeat = 0;
     nvalid = nextvalid();
-    modify->addstep_compute_all(nvalid);
   }
+
+  // add nvalid to computes this fix may invoke, found by Modify::init()
+
+  modify->addstep_compute(nvalid,std::string("fix ") + id);
 }
 
 /* ----------------------------------------------------------------------
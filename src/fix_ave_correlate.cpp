@@ -295,8 +295,7 @@ FixAveCorrelate::FixAveCorrelate(LAMMPS * lmp, int narg, char **arg):
   extarray = 0;
 
   // nvalid = next step on which end_of_step does something
-  // add nvalid to all computes that store invocation times
-  // since don't know a priori which are invoked by this fix
+  // init() adds nvalid to computes this fix may invoke
   // once in end_of_step() can set timestep for ones actually invoked
 
   lastindex = -1;
@@ -304,7 +303,6 @@ FixAveCorrelate::FixAveCorrelate(LAMMPS * lmp, int narg, char **arg):
   nsample = 0;
   nvalid_last = -1;
   nvalid = nextvalid();
-  modify->addstep_compute_all(nvalid);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -369,8 +367,11 @@ void FixAveCorrelate::init()
     firstindex = 0;
     nsample = 0;
     nvalid = nextvalid();
-    modify->addstep_compute_all(nvalid);
   }
+
+  // add nvalid to computes this fix may invoke, found by Modify::init()
+
+  modify->addstep_compute(nvalid,std::string("fix ") + id);
 }
 
 /* ----------------------------------------------------------------------
@@ -488,13 +488,11 @@ FixAveHisto::FixAveHisto(LAMMPS *lmp, int narg, char **arg) :
   for (int i = 0; i < nbins; i++) bin_total[i] = 0.0;
 
   // nvalid = next step on which end_of_step does something
-  // add nvalid to all computes that store invocation times
-  // since don't know a priori which are invoked by this fix
+  // init() adds nvalid to computes this fix may invoke
   // once in end_of_step() can set timestep for ones actually invoked
 
   nvalid_last = -1;
   nvalid = nextvalid();
-  modify->addstep_compute_all(nvalid);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -559,8 +557,11 @@ void FixAveHisto::init()
   if (nvalid < update->ntimestep) {
     irepeat = 0;
     nvalid = nextvalid();
-    modify->addstep_compute_all(nvalid);
   }
+
+  // add nvalid to computes this fix may invoke, found by Modify::init()
+
+  modify->addstep_compute(nvalid,std::string("fix ") + id);
 }
 
 /* ----------------------------------------------------------------------
@@ -23,11 +23,13 @@
 #include "input.h"
 #include "memory.h"
 #include "modify.h"
+#include "timer.h"
 #include "update.h"
 #include "variable.h"
 
 #include <cstring>
 #include <unistd.h>
+#include <vector>
 
 using namespace LAMMPS_NS;
 using namespace FixConst;
@@ -417,13 +419,11 @@ FixAveTime::FixAveTime(LAMMPS *lmp, int narg, char **arg) :
     for (int i = 0; i < nvalues; i++) vector_total[i] = 0.0;
 
   // nvalid = next step on which end_of_step does something
-  // add nvalid to all computes that store invocation times
-  // since don't know a priori which are invoked by this fix
+  // init() adds nvalid to computes this fix may invoke
   // once in end_of_step() can set timestep for ones actually invoked
 
   nvalid_last = -1;
   nvalid = nextvalid();
-  modify->addstep_compute_all(nvalid);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -507,8 +507,11 @@ void FixAveTime::init()
   if (nvalid < update->ntimestep) {
     irepeat = 0;
     nvalid = nextvalid();
-    modify->addstep_compute_all(nvalid);
   }
+
+  // add nvalid to computes this fix may invoke, found by Modify::init()
+
+  modify->addstep_compute(nvalid,std::string("fix ") + id);
 }
 
 /* ----------------------------------------------------------------------
@@ -563,6 +566,8 @@ void FixAveTime::invoke_scalar(bigint ntimestep)
 
   modify->clearstep_compute();
 
+  invoke_partial(Compute::INVOKED_SCALAR);
+
   for (i = 0; i < nvalues; i++) {
     m = value2index[i];
 
@@ -574,13 +579,17 @@ void FixAveTime::invoke_scalar(bigint ntimestep)
 
       if (argindex[i] == 0) {
         if (!(compute->invoked_flag & Compute::INVOKED_SCALAR)) {
+          timer->detail_start(compute->timer_detail);
           compute->compute_scalar();
+          timer->detail_stop(compute->timer_detail);
           compute->invoked_flag |= Compute::INVOKED_SCALAR;
         }
         scalar = compute->scalar;
       } else {
         if (!(compute->invoked_flag & Compute::INVOKED_VECTOR)) {
+          timer->detail_start(compute->timer_detail);
           compute->compute_vector();
+          timer->detail_stop(compute->timer_detail);
           compute->invoked_flag |= Compute::INVOKED_VECTOR;
         }
         if (varlen[i] && compute->size_vector < argindex[i]) scalar = 0.0;
@@ -747,6 +756,8 @@ void FixAveTime::invoke_vector(bigint ntimestep)
 
   modify->clearstep_compute();
 
+  invoke_partial(Compute::INVOKED_VECTOR);
+
   for (j = 0; j < nvalues; j++) {
     m = value2index[j];
 
@@ -757,7 +768,9 @@ void FixAveTime::invoke_vector(bigint ntimestep)
 
       if (argindex[j] == 0) {
         if (!(compute->invoked_flag & Compute::INVOKED_VECTOR)) {
+          timer->detail_start(compute->timer_detail);
           compute->compute_vector();
+          timer->detail_stop(compute->timer_detail);
           compute->invoked_flag |= Compute::INVOKED_VECTOR;
         }
         double *cvector = compute->vector;
@@ -766,7 +779,9 @@ void FixAveTime::invoke_vector(bigint ntimestep)
 
       } else {
         if (!(compute->invoked_flag & Compute::INVOKED_ARRAY)) {
+          timer->detail_start(compute->timer_detail);
           compute->compute_array();
+          timer->detail_stop(compute->timer_detail);
           compute->invoked_flag |= Compute::INVOKED_ARRAY;
         }
         double **carray = compute->array;
@@ -900,6 +915,27 @@ void FixAveTime::invoke_vector(bigint ntimestep)
   }
 }
 
+/* ----------------------------------------------------------------------
+   invoke computes with a single reduction where they allow it
+   FLAG = Compute::INVOKED_SCALAR if values are global scalars,
+          Compute::INVOKED_VECTOR if values are global vectors
+   a value with an index uses one more dimension
+------------------------------------------------------------------------- */
+
+void FixAveTime::invoke_partial(int flag)
+{
+  std::vector<Compute *> list;
+  std::vector<int> flags;
+
+  for (int i = 0; i < nvalues; i++) {
+    if (which[i] != ArgInfo::COMPUTE) continue;
+    list.push_back(modify->compute[value2index[i]]);
+    flags.push_back(argindex[i] ? flag << 1 : flag);
+  }
+
+  modify->invoke_partial(list.size(),list.data(),flags.data());
+}
+
 /* ----------------------------------------------------------------------
    return scalar value
 ------------------------------------------------------------------------- */
@@ -68,6 +68,7 @@ class FixAveTime : public Fix {
   int column_length(int);
   void invoke_scalar(bigint);
   void invoke_vector(bigint);
+  void invoke_partial(int);
   void options(int, int, char **);
   void allocate_arrays();
   bigint nextvalid();
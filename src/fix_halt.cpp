@@ -121,15 +121,6 @@ FixHalt::FixHalt(LAMMPS *lmp, int narg, char **arg) :
       ++iarg;
     } else error->all(FLERR,"Illegal fix halt command");
   }
-
-  // add nfirst to all computes that store invocation times
-  // since don't know a priori which are invoked via variables by this fix
-  // once in end_of_step() can set timestep for ones actually invoked
-
-  if (attribute == VARIABLE) {
-    const bigint nfirst = (update->ntimestep/nevery)*nevery + nevery;
-    modify->addstep_compute_all(nfirst);
-  }
 }
 
 /* ---------------------------------------------------------------------- */
@@ -170,6 +161,12 @@ void FixHalt::init()
   thisstep = -1;
   tratio = 0.5;
 
+  // add nextstep to computes the variable may invoke, found by Modify::init()
+  // once in end_of_step() can set timestep for ones actually invoked
+
+  if (attribute == VARIABLE)
+    modify->addstep_compute(nextstep,std::string("fix ") + id);
+
   // check if disk limit is supported
 
   if (attribute == DISKFREE) {
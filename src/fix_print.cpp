@@ -132,11 +132,11 @@ void FixPrint::init()
       next_print = update->ntimestep;
   }
 
-  // add next_print to all computes that store invocation times
-  // since don't know a priori which are invoked via variables by this fix
+  // add next_print to computes this fix may invoke via variables,
+  //   found by Modify::init()
   // once in end_of_step() can set timestep for ones actually invoked
 
-  modify->addstep_compute_all(next_print);
+  modify->addstep_compute(next_print,std::string("fix ") + id);
 }
 
 /* ---------------------------------------------------------------------- */
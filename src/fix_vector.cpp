@@ -145,13 +145,11 @@ FixVector::FixVector(LAMMPS *lmp, int narg, char **arg) :
   else size_array_rows = 0;
 
   // nextstep = next step on which end_of_step does something
-  // add nextstep to all computes that store invocation times
-  // since don't know a priori which are invoked by this fix
+  // init() adds nextstep to computes this fix may invoke
   // once in end_of_step() can set timestep for ones actually invoked
 
   nextstep = (update->ntimestep/nevery)*nevery;
   if (nextstep < update->ntimestep) nextstep += nevery;
-  modify->addstep_compute_all(nextstep);
 
   // initialstep = first step the vector/array will store values for
 
@@ -208,6 +206,10 @@ void FixVector::init()
     }
   }
 
+  // add nextstep to computes this fix may invoke, found by Modify::init()
+
+  modify->addstep_compute(nextstep,std::string("fix ") + id);
+
   // reallocate vector or array for accumulated size at end of run
   // use endstep to allow for subsequent runs with "pre no"
   // nsize = # of entries from initialstep to finalstep
@@ -569,6 +569,9 @@ void Info::command(int narg, char **arg)
                  std::string(compute[i]->style)+',',
                  names[compute[i]->igroup]);
     }
+    modify->depend_init();
+    fputs("\nCompute dependencies of fixes and dumps:\n",out);
+    fputs(modify->depend_report().c_str(),out);
   }
 
   if (flags & DUMPS) {
@@ -43,6 +43,7 @@ KSpace::KSpace(LAMMPS *lmp) : Pointers(lmp)
     dipoleflag = spinflag = 0;
   compute_flag = 1;
   group_group_enable = 0;
+  mc_delta_enable = 0;
   stagger_flag = 0;
 
   order = 5;
@@ -60,6 +61,9 @@ KSpace::KSpace(LAMMPS *lmp) : Pointers(lmp)
   collective_flag = 0;
 #endif
 
+  fft_plan = 0;
+  fft_wisdom = nullptr;
+
   kewaldflag = 0;
 
   order_6 = 5;
@@ -155,6 +159,7 @@ KSpace::~KSpace()
   memory->destroy(vatom);
   memory->destroy(gcons);
   memory->destroy(dgcons);
+  delete [] fft_wisdom;
 }
 
 /* ----------------------------------------------------------------------
@@ -550,6 +555,20 @@ void KSpace::modify_params(int narg, char **arg)
       else if (strcmp(arg[iarg+1],"no") == 0) collective_flag = 0;
       else error->all(FLERR,"Illegal kspace_modify command");
       iarg += 2;
+    } else if (strcmp(arg[iarg],"fft/plan") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
+      if (strcmp(arg[iarg+1],"estimate") == 0) fft_plan = 0;
+      else if (strcmp(arg[iarg+1],"measure") == 0) fft_plan = 1;
+      else if (strcmp(arg[iarg+1],"patient") == 0) fft_plan = 2;
+      else if (strcmp(arg[iarg+1],"exhaustive") == 0) fft_plan = 3;
+      else error->all(FLERR,"Illegal kspace_modify command");
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"fft/wisdom") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
+      delete [] fft_wisdom;
+      if (strcmp(arg[iarg+1],"none") == 0) fft_wisdom = nullptr;
+      else fft_wisdom = utils::strdup(arg[iarg+1]);
+      iarg += 2;
     } else if (strcmp(arg[iarg],"diff") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
       if (strcmp(arg[iarg+1],"ad") == 0) differentiation_flag = 1;
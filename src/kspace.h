@@ -79,6 +79,7 @@ class KSpace : protected Pointers {
   int nx_msm_max,ny_msm_max,nz_msm_max;
 
   int group_group_enable;         // 1 if style supports group/group calculation
+  int mc_delta_enable;            // 1 if style supports energy_delta()
 
   int centroidstressflag;        // centroid stress compared to two-body stress
                                  // CENTROID_SAME = same as two-body stress
@@ -94,6 +95,8 @@ class KSpace : protected Pointers {
   int compute_flag;               // 0 if skip compute()
   int fftbench;                   // 0 if skip FFT timing
   int collective_flag;            // 1 if use MPI collectives for FFT/remap
+  int fft_plan;                   // planner effort for FFTW3 1d FFTs
+  char *fft_wisdom;               // file for FFTW3 wisdom, nullptr if none
   int stagger_flag;               // 1 if using staggered PPPM grids
 
   double splittol;                // tolerance for when to truncate splitting
@@ -126,6 +129,11 @@ class KSpace : protected Pointers {
   virtual void compute(int, int) = 0;
   virtual void compute_group_group(int, int, int) {};
 
+  // energy change when a few atoms are modified, e.g. in Monte Carlo moves
+
+  virtual double energy_delta(int, int *, double **, double *) {return 0.0;}
+  virtual void accept_delta(int) {};
+
   virtual void pack_forward_grid(int, void *, int, int *) {};
   virtual void unpack_forward_grid(int, void *, int, int *) {};
   virtual void pack_reverse_grid(int, void *, int, int *) {};
@@ -19,15 +19,20 @@
 #include "comm.h"
 #include "compute.h"
 #include "domain.h"
+#include "dump.h"
 #include "error.h"
 #include "fix.h"
 #include "group.h"
 #include "input.h"
 #include "memory.h"
+#include "output.h"
 #include "region.h"
+#include "thermo.h"
+#include "timer.h"
 #include "update.h"
 #include "variable.h"
 
+#include <cctype>
 #include <cstring>
 #include <vector>
 
@@ -38,6 +43,22 @@ using namespace FixConst;
 #define BIG 1.0e20
 #define NEXCEPT 7       // change when add to exceptions in add_fix()
 
+// thermo keywords that invoke the thermo temperature, pressure, pe computes
+//   when used in a variable formula, see Thermo::evaluate_keyword()
+
+enum{THERMO_TEMP=1,THERMO_PRESS=2,THERMO_PE=4};
+
+static const std::map<std::string,int> thermo_depend = {
+  {"temp",THERMO_TEMP}, {"ke",THERMO_TEMP}, {"press",THERMO_PRESS},
+  {"pxx",THERMO_PRESS}, {"pyy",THERMO_PRESS}, {"pzz",THERMO_PRESS},
+  {"pxy",THERMO_PRESS}, {"pxz",THERMO_PRESS}, {"pyz",THERMO_PRESS},
+  {"pe",THERMO_PE}, {"evdwl",THERMO_PE}, {"ecoul",THERMO_PE},
+  {"epair",THERMO_PE}, {"ebond",THERMO_PE}, {"eangle",THERMO_PE},
+  {"edihed",THERMO_PE}, {"eimp",THERMO_PE}, {"emol",THERMO_PE},
+  {"elong",THERMO_PE}, {"etotal",THERMO_TEMP|THERMO_PE},
+  {"econserve",THERMO_TEMP|THERMO_PE},
+  {"enthalpy",THERMO_TEMP|THERMO_PRESS|THERMO_PE}};
+
 /* ---------------------------------------------------------------------- */
 
 Modify::Modify(LAMMPS *lmp) : Pointers(lmp)
@@ -191,6 +212,11 @@ void Modify::init()
   }
   addstep_compute_all(update->ntimestep);
 
+  // computes each fix and dump may invoke
+  // used by their init() and Output::setup() to schedule only those computes
+
+  depend_init();
+
   // init each fix
   // should not need to come before compute init
   //   used to b/c temperature computes called fix->dof() in their init,
@@ -246,6 +272,10 @@ void Modify::init()
 
   list_init_compute();
 
+  // detailed timers of fixes and computes
+
+  detail_init();
+
   // error if any fix or compute is using a dynamic group when not allowed
 
   for (i = 0; i < nfix; i++)
@@ -392,8 +422,11 @@ void Modify::setup_pre_reverse(int eflag, int vflag)
 
 void Modify::initial_integrate(int vflag)
 {
-  for (int i = 0; i < n_initial_integrate; i++)
+  for (int i = 0; i < n_initial_integrate; i++) {
+    timer->detail_start(detail_fix[DETAIL_INITIAL_INTEGRATE][i]);
     fix[list_initial_integrate[i]]->initial_integrate(vflag);
+    timer->detail_stop(detail_fix[DETAIL_INITIAL_INTEGRATE][i]);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -402,8 +435,11 @@ void Modify::initial_integrate(int vflag)
 
 void Modify::post_integrate()
 {
-  for (int i = 0; i < n_post_integrate; i++)
+  for (int i = 0; i < n_post_integrate; i++) {
+    timer->detail_start(detail_fix[DETAIL_POST_INTEGRATE][i]);
     fix[list_post_integrate[i]]->post_integrate();
+    timer->detail_stop(detail_fix[DETAIL_POST_INTEGRATE][i]);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -412,8 +448,11 @@ void Modify::post_integrate()
 
 void Modify::pre_exchange()
 {
-  for (int i = 0; i < n_pre_exchange; i++)
+  for (int i = 0; i < n_pre_exchange; i++) {
+    timer->detail_start(detail_fix[DETAIL_PRE_EXCHANGE][i]);
     fix[list_pre_exchange[i]]->pre_exchange();
+    timer->detail_stop(detail_fix[DETAIL_PRE_EXCHANGE][i]);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -422,8 +461,11 @@ void Modify::pre_exchange()
 
 void Modify::pre_neighbor()
 {
-  for (int i = 0; i < n_pre_neighbor; i++)
+  for (int i = 0; i < n_pre_neighbor; i++) {
+    timer->detail_start(detail_fix[DETAIL_PRE_NEIGHBOR][i]);
     fix[list_pre_neighbor[i]]->pre_neighbor();
+    timer->detail_stop(detail_fix[DETAIL_PRE_NEIGHBOR][i]);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -432,8 +474,11 @@ void Modify::pre_neighbor()
 
 void Modify::post_neighbor()
 {
-  for (int i = 0; i < n_post_neighbor; i++)
+  for (int i = 0; i < n_post_neighbor; i++) {
+    timer->detail_start(detail_fix[DETAIL_POST_NEIGHBOR][i]);
     fix[list_post_neighbor[i]]->post_neighbor();
+    timer->detail_stop(detail_fix[DETAIL_POST_NEIGHBOR][i]);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -442,8 +487,11 @@ void Modify::post_neighbor()
 
 void Modify::pre_force(int vflag)
 {
-  for (int i = 0; i < n_pre_force; i++)
+  for (int i = 0; i < n_pre_force; i++) {
+    timer->detail_start(detail_fix[DETAIL_PRE_FORCE][i]);
     fix[list_pre_force[i]]->pre_force(vflag);
+    timer->detail_stop(detail_fix[DETAIL_PRE_FORCE][i]);
+  }
 }
 /* ----------------------------------------------------------------------
    pre_reverse call, only for relevant fixes
@@ -451,8 +499,11 @@ void Modify::pre_force(int vflag)
 
 void Modify::pre_reverse(int eflag, int vflag)
 {
-  for (int i = 0; i < n_pre_reverse; i++)
+  for (int i = 0; i < n_pre_reverse; i++) {
+    timer->detail_start(detail_fix[DETAIL_PRE_REVERSE][i]);
     fix[list_pre_reverse[i]]->pre_reverse(eflag,vflag);
+    timer->detail_stop(detail_fix[DETAIL_PRE_REVERSE][i]);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -461,8 +512,11 @@ void Modify::pre_reverse(int eflag, int vflag)
 
 void Modify::post_force(int vflag)
 {
-  for (int i = 0; i < n_post_force; i++)
+  for (int i = 0; i < n_post_force; i++) {
+    timer->detail_start(detail_fix[DETAIL_POST_FORCE][i]);
     fix[list_post_force[i]]->post_force(vflag);
+    timer->detail_stop(detail_fix[DETAIL_POST_FORCE][i]);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -471,8 +525,11 @@ void Modify::post_force(int vflag)
 
 void Modify::final_integrate()
 {
-  for (int i = 0; i < n_final_integrate; i++)
+  for (int i = 0; i < n_final_integrate; i++) {
+    timer->detail_start(detail_fix[DETAIL_FINAL_INTEGRATE][i]);
     fix[list_final_integrate[i]]->final_integrate();
+    timer->detail_stop(detail_fix[DETAIL_FINAL_INTEGRATE][i]);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -483,8 +540,11 @@ void Modify::final_integrate()
 void Modify::end_of_step()
 {
   for (int i = 0; i < n_end_of_step; i++)
-    if (update->ntimestep % end_of_step_every[i] == 0)
+    if (update->ntimestep % end_of_step_every[i] == 0) {
+      timer->detail_start(detail_fix[DETAIL_END_OF_STEP][i]);
       fix[list_end_of_step[i]]->end_of_step();
+      timer->detail_stop(detail_fix[DETAIL_END_OF_STEP][i]);
+    }
 }
 
 /* ----------------------------------------------------------------------
@@ -954,6 +1014,7 @@ void Modify::add_fix(int narg, char **arg, int trysuffix)
 
   if (newflag) nfix++;
   fmask[ifix] = fix[ifix]->setmask();
+  record_command("fix",narg,arg);
   fix[ifix]->post_constructor();
 }
 
@@ -1002,6 +1063,7 @@ void Modify::replace_fix(const char *replaceID,
 
   delete [] fix[ifix]->style;
   fix[ifix]->style = utils::strdup(arg[2]);
+  forget_command(std::string("fix ") + replaceID);
 
   // invoke add_fix
   // it will find and overwrite the replaceID fix
@@ -1052,6 +1114,7 @@ void Modify::modify_fix(int narg, char **arg)
   if (ifix == nfix) error->all(FLERR,"Could not find fix_modify ID");
 
   fix[ifix]->modify_params(narg-1,&arg[1]);
+  record_command("fix",narg,arg,1);
 }
 
 /* ----------------------------------------------------------------------
@@ -1072,6 +1135,7 @@ void Modify::delete_fix(int ifix)
 
   // delete instance and move other Fixes and fmask down in list one slot
 
+  forget_command(std::string("fix ") + fix[ifix]->id);
   delete fix[ifix];
   atom->update_callback(ifix);
 
@@ -1269,6 +1333,7 @@ void Modify::add_compute(int narg, char **arg, int trysuffix)
     error->all(FLERR,utils::check_packages_for_style("compute",arg[2],lmp));
 
   ncompute++;
+  record_command("compute",narg,arg);
 }
 
 /* ----------------------------------------------------------------------
@@ -1315,6 +1380,7 @@ void Modify::modify_compute(int narg, char **arg)
     error->all(FLERR,"Could not find compute_modify ID");
 
   compute[icompute]->modify_params(narg-1,&arg[1]);
+  record_command("compute",narg,arg,1);
 }
 
 /* ----------------------------------------------------------------------
@@ -1334,6 +1400,7 @@ void Modify::delete_compute(int icompute)
 
   // delete and move other Computes down in list one slot
 
+  forget_command(std::string("compute ") + compute[icompute]->id);
   delete compute[icompute];
   for (int i = icompute+1; i < ncompute; i++) compute[i-1] = compute[i];
   ncompute--;
@@ -1411,6 +1478,307 @@ void Modify::addstep_compute_all(bigint newstep)
     if (compute[icompute]->timeflag) compute[icompute]->addstep(newstep);
 }
 
+/* ----------------------------------------------------------------------
+   schedule next invocation of computes that fix or dump KEY may invoke
+   KEY = "fix ID" or "dump ID"
+   use addstep_compute_all() if they are not known,
+     e.g. KEY was created or modified after last init()
+------------------------------------------------------------------------- */
+
+void Modify::addstep_compute(bigint newstep, const std::string &key)
+{
+  auto it = depend.find(key);
+  if (it == depend.end() ||
+      (it->second.size() == 1 && it->second[0] < 0)) {
+    addstep_compute_all(newstep);
+    return;
+  }
+
+  for (auto icompute : it->second)
+    if (compute[icompute]->timeflag) compute[icompute]->addstep(newstep);
+}
+
+/* ----------------------------------------------------------------------
+   invoke global scalars or vectors of N computes with a single reduction
+   WHICH[i] = Compute::INVOKED_SCALAR or INVOKED_VECTOR for LIST[i]
+   skip computes already invoked or that cannot split their reduction,
+     caller invokes those as usual
+   temperatures are finished first, since pressures may use them
+------------------------------------------------------------------------- */
+
+void Modify::invoke_partial(int n, Compute **list, int *which)
+{
+  std::vector<int> batch,offset;
+  int nsum = 0;
+
+  for (int i = 0; i < n; i++) {
+    Compute *c = list[i];
+    if (c->invoked_flag & which[i]) continue;
+    int size = 0;
+    if (which[i] == Compute::INVOKED_SCALAR && c->partial_scalar_flag)
+      size = c->size_partial_scalar;
+    else if (which[i] == Compute::INVOKED_VECTOR && c->partial_vector_flag)
+      size = c->size_partial_vector;
+    if (size == 0) continue;
+    c->invoked_flag |= which[i];
+    batch.push_back(i);
+    offset.push_back(nsum);
+    nsum += size;
+  }
+  if (batch.empty()) return;
+
+  std::vector<double> sum(nsum),sumall(nsum);
+  for (std::size_t m = 0; m < batch.size(); m++) {
+    Compute *c = list[batch[m]];
+    timer->detail_start(c->timer_detail);
+    if (which[batch[m]] == Compute::INVOKED_SCALAR)
+      c->partial_scalar(&sum[offset[m]]);
+    else c->partial_vector(&sum[offset[m]]);
+    timer->detail_stop(c->timer_detail,0);
+  }
+
+  MPI_Allreduce(sum.data(),sumall.data(),nsum,MPI_DOUBLE,MPI_SUM,world);
+
+  for (int pass = 0; pass < 2; pass++)
+    for (std::size_t m = 0; m < batch.size(); m++) {
+      Compute *c = list[batch[m]];
+      if ((c->tempflag != 0) != (pass == 0)) continue;
+      timer->detail_start(c->timer_detail);
+      if (which[batch[m]] == Compute::INVOKED_SCALAR)
+        c->reduce_scalar(&sumall[offset[m]]);
+      else c->reduce_vector(&sumall[offset[m]]);
+      timer->detail_stop(c->timer_detail);
+    }
+}
+
+/* ----------------------------------------------------------------------
+   store args of a fix, compute, dump command or append its _modify args
+   KIND = "fix", "compute", "dump", arg[0] = ID
+   invalidates dependencies until next init()
+------------------------------------------------------------------------- */
+
+void Modify::record_command(const std::string &kind, int narg, char **arg,
+                            int append)
+{
+  std::string key = kind + " " + arg[0];
+  std::string &text = command_text[key];
+  if (!append) text.clear();
+  for (int i = 1; i < narg; i++) {
+    text += " ";
+    text += arg[i];
+  }
+  depend.clear();
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Modify::forget_command(const std::string &key)
+{
+  command_text.erase(key);
+  depend.clear();
+}
+
+/* ----------------------------------------------------------------------
+   build list of computes that each fix and dump may invoke
+   follows c_ID, f_ID, v_name references through computes, fixes and
+     variable formulas, so only computes actually needed by a fix ave/time
+     or dump trigger energy/virial tallies on its first output step
+------------------------------------------------------------------------- */
+
+void Modify::depend_init()
+{
+  depend.clear();
+
+  std::vector<std::string> keys;
+  for (int i = 0; i < nfix; i++) keys.push_back(std::string("fix ") + fix[i]->id);
+  for (int i = 0; output && i < output->ndump; i++)
+    keys.push_back(std::string("dump ") + output->dump[i]->id);
+
+  for (const auto &key : keys) {
+    std::set<int> list;
+    std::set<std::string> visited;
+    visited.insert(key);
+    auto it = command_text.find(key);
+    if (it == command_text.end() || depend_scan(it->second,0,list,visited))
+      depend[key] = std::vector<int>(1,-1);
+    else depend[key] = std::vector<int>(list.begin(),list.end());
+  }
+}
+
+/* ----------------------------------------------------------------------
+   add computes that TEXT of a command or a variable formula may invoke
+   c_ID, f_ID, v_name, $x, ${name}, $(formula) are followed
+   bare words that match a compute ID are computes, e.g. a temp-ID arg,
+     in commands also bare words that match a variable name
+   if FORMULA is set, thermo keywords add the thermo computes they invoke
+   return 1 if the computes cannot be determined
+------------------------------------------------------------------------- */
+
+int Modify::depend_scan(const std::string &text, int formula,
+                        std::set<int> &list, std::set<std::string> &visited)
+{
+  const std::size_t n = text.size();
+  std::size_t i = 0;
+
+  while (i < n) {
+
+    // immediate variables and formulas
+
+    if (text[i] == '$' && i+1 < n) {
+      if (text[i+1] == '{') {
+        std::size_t j = text.find('}',i+2);
+        if (j == std::string::npos) j = n;
+        if (depend_variable(text.substr(i+2,j-i-2),list,visited)) return 1;
+        i = j+1;
+      } else if (text[i+1] == '(') {
+        int level = 0;
+        std::size_t j;
+        for (j = i+1; j < n; j++) {
+          if (text[j] == '(') level++;
+          else if (text[j] == ')' && --level == 0) break;
+        }
+        if (depend_scan(text.substr(i+2,j-i-2),1,list,visited)) return 1;
+        i = j+1;
+      } else {
+        if (depend_variable(text.substr(i+1,1),list,visited)) return 1;
+        i += 2;
+      }
+      continue;
+    }
+
+    if (!isalnum(text[i]) && text[i] != '_') {
+      i++;
+      continue;
+    }
+
+    std::size_t j = i;
+    while (j < n && (isalnum(text[j]) || text[j] == '_')) j++;
+    std::string word = text.substr(i,j-i);
+    i = j;
+
+    if (utils::strmatch(word,"^c_")) {
+      int icompute = find_compute(word.substr(2));
+      if (icompute >= 0 && depend_compute(icompute,list,visited)) return 1;
+    } else if (utils::strmatch(word,"^f_")) {
+      int ifix = find_fix(word.substr(2));
+      if (ifix >= 0 && depend_fix(ifix,list,visited)) return 1;
+    } else if (utils::strmatch(word,"^v_")) {
+      if (depend_variable(word.substr(2),list,visited)) return 1;
+    } else {
+      int icompute = find_compute(word);
+      if (icompute >= 0 && depend_compute(icompute,list,visited)) return 1;
+      if (!formula && input->variable->find(word.c_str()) >= 0 &&
+          depend_variable(word,list,visited)) return 1;
+
+      // a thermo keyword in a formula, unless it is a function name
+
+      auto it = thermo_depend.find(word);
+      if (formula && it != thermo_depend.end() && (j == n || text[j] != '(')) {
+        Thermo *thermo = output->thermo;
+        if (!thermo) return 1;
+        const char *ids[3] = {thermo->id_temp,thermo->id_press,thermo->id_pe};
+        for (int m = 0; m < 3; m++) {
+          if (!(it->second & (1 << m))) continue;
+          icompute = ids[m] ? find_compute(ids[m]) : -1;
+          if (icompute >= 0 && depend_compute(icompute,list,visited)) return 1;
+        }
+      }
+    }
+  }
+
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   add compute and computes it references to list
+------------------------------------------------------------------------- */
+
+int Modify::depend_compute(int icompute, std::set<int> &list,
+                           std::set<std::string> &visited)
+{
+  std::string key = std::string("compute ") + compute[icompute]->id;
+  if (!visited.insert(key).second) return 0;
+  list.insert(icompute);
+
+  auto it = command_text.find(key);
+  if (it == command_text.end()) return 0;
+  return depend_scan(it->second,0,list,visited);
+}
+
+/* ----------------------------------------------------------------------
+   add computes a fix may invoke when its output is accessed
+   fix styles that only store values computed earlier invoke none
+   others may invoke computes in their args or computes they created,
+     which by convention have an ID starting with the fix ID + "_"
+------------------------------------------------------------------------- */
+
+int Modify::depend_fix(int ifix, std::set<int> &list,
+                       std::set<std::string> &visited)
+{
+  std::string key = std::string("fix ") + fix[ifix]->id;
+  if (!visited.insert(key).second) return 0;
+
+  const char *style = fix[ifix]->style;
+  if (utils::strmatch(style,"^ave/") || utils::strmatch(style,"^store") ||
+      strcmp(style,"vector") == 0) return 0;
+
+  std::string prefix = std::string(fix[ifix]->id) + "_";
+  for (int icompute = 0; icompute < ncompute; icompute++)
+    if (strncmp(compute[icompute]->id,prefix.c_str(),prefix.size()) == 0)
+      if (depend_compute(icompute,list,visited)) return 1;
+
+  auto it = command_text.find(key);
+  if (it == command_text.end()) return 1;
+  return depend_scan(it->second,0,list,visited);
+}
+
+/* ----------------------------------------------------------------------
+   add computes that evaluating variable NAME may invoke
+------------------------------------------------------------------------- */
+
+int Modify::depend_variable(const std::string &name, std::set<int> &list,
+                            std::set<std::string> &visited)
+{
+  std::string key = "variable " + name;
+  if (!visited.insert(key).second) return 0;
+
+  int ivar = input->variable->find(name.c_str());
+  if (ivar < 0) return 0;
+  std::string text;
+  if (input->variable->depend_text(ivar,text)) return 1;
+  return depend_scan(text,1,list,visited);
+}
+
+/* ----------------------------------------------------------------------
+   return computes each fix and dump may invoke, as set by last init()
+   and the computes that require energy or virial tallies
+------------------------------------------------------------------------- */
+
+std::string Modify::depend_report()
+{
+  std::string mesg;
+
+  for (const auto &entry : depend) {
+    mesg += fmt::format("{:>24} :",entry.first);
+    if (entry.second.size() == 1 && entry.second[0] < 0)
+      mesg += " all computes";
+    else if (entry.second.empty()) mesg += " none";
+    for (auto icompute : entry.second)
+      if (icompute >= 0) mesg += std::string(" ") + compute[icompute]->id;
+    mesg += "\n";
+  }
+
+  std::string tally;
+  for (int i = 0; i < ncompute; i++) {
+    if (compute[i]->peflag || compute[i]->peatomflag)
+      tally += fmt::format(" {}(energy)",compute[i]->id);
+    if (compute[i]->pressflag || compute[i]->pressatomflag)
+      tally += fmt::format(" {}(virial)",compute[i]->id);
+  }
+  if (!tally.empty()) mesg += "Computes that require tallies:" + tally + "\n";
+  return mesg;
+}
+
 /* ----------------------------------------------------------------------
    write to restart file for all Fixes with restart info
    (1) fixes that have global state
@@ -1735,6 +2103,38 @@ void Modify::list_init_compute()
     if (compute[i]->timeflag) list_timeflag[n_timeflag++] = i;
 }
 
+/* ----------------------------------------------------------------------
+   create detailed timers of fix callbacks during a run and of computes
+   ids are -1 if detailed timing is off
+------------------------------------------------------------------------- */
+
+void Modify::detail_init()
+{
+  const char *names[NUM_DETAIL] =
+    {"initial_integrate","post_integrate","pre_exchange","pre_neighbor",
+     "post_neighbor","pre_force","pre_reverse","post_force",
+     "final_integrate","end_of_step"};
+  int *lists[NUM_DETAIL] =
+    {list_initial_integrate,list_post_integrate,list_pre_exchange,
+     list_pre_neighbor,list_post_neighbor,list_pre_force,list_pre_reverse,
+     list_post_force,list_final_integrate,list_end_of_step};
+  int nlists[NUM_DETAIL] =
+    {n_initial_integrate,n_post_integrate,n_pre_exchange,n_pre_neighbor,
+     n_post_neighbor,n_pre_force,n_pre_reverse,n_post_force,
+     n_final_integrate,n_end_of_step};
+
+  for (int m = 0; m < NUM_DETAIL; m++) {
+    detail_fix[m].resize(nlists[m]);
+    for (int i = 0; i < nlists[m]; i++)
+      detail_fix[m][i] = timer->detail_id(fmt::format("fix {} {}",
+                                          fix[lists[m][i]]->id,names[m]));
+  }
+
+  for (int i = 0; i < ncompute; i++)
+    compute[i]->timer_detail =
+      timer->detail_id(fmt::format("compute {}",compute[i]->id));
+}
+
 /* ----------------------------------------------------------------------
    return # of bytes of allocated memory from all fixes
 ------------------------------------------------------------------------- */
@@ -17,6 +17,9 @@
 #include "pointers.h"
 
 #include <map>
+#include <set>
+#include <string>
+#include <vector>
 
 namespace LAMMPS_NS {
 
@@ -121,6 +124,13 @@ class Modify : protected Pointers {
   void clearstep_compute();
   void addstep_compute(bigint);
   void addstep_compute_all(bigint);
+  void addstep_compute(bigint, const std::string &);
+  void invoke_partial(int, class Compute **, int *);
+
+  void record_command(const std::string &, int, char **, int append=0);
+  void forget_command(const std::string &);
+  void depend_init();
+  std::string depend_report();
 
   int check_package(const char *);
   int check_rigid_group_overlap(int);
@@ -151,9 +161,27 @@ class Modify : protected Pointers {
 
   int *end_of_step_every;
 
+  // ids of detailed timers of the fixes in the lists above, -1 if none
+
+  enum {DETAIL_INITIAL_INTEGRATE,DETAIL_POST_INTEGRATE,DETAIL_PRE_EXCHANGE,
+        DETAIL_PRE_NEIGHBOR,DETAIL_POST_NEIGHBOR,DETAIL_PRE_FORCE,
+        DETAIL_PRE_REVERSE,DETAIL_POST_FORCE,DETAIL_FINAL_INTEGRATE,
+        DETAIL_END_OF_STEP,NUM_DETAIL};
+  std::vector<int> detail_fix[NUM_DETAIL];
+
   int n_timeflag;            // list of computes that store time invocation
   int *list_timeflag;
 
+  // args of fix, compute, dump commands and their _modify commands
+  // key is "fix ID", "compute ID", "dump ID"
+
+  std::map<std::string,std::string> command_text;
+
+  // computes each fix or dump may invoke, set by depend_init()
+  // a single -1 means the computes cannot be determined
+
+  std::map<std::string,std::vector<int>> depend;
+
   char **id_restart_global;           // stored fix global info
   char **style_restart_global;        // from read-in restart file
   char **state_restart_global;
@@ -173,6 +201,14 @@ class Modify : protected Pointers {
   void list_init_energy_atom(int &, int *&);
   void list_init_dofflag(int &, int *&);
   void list_init_compute();
+  void detail_init();
+
+  int depend_scan(const std::string &, int, std::set<int> &,
+                  std::set<std::string> &);
+  int depend_compute(int, std::set<int> &, std::set<std::string> &);
+  int depend_fix(int, std::set<int> &, std::set<std::string> &);
+  int depend_variable(const std::string &, std::set<int> &,
+                      std::set<std::string> &);
 
  public:
   typedef Compute *(*ComputeCreator)(LAMMPS *, int, char **);
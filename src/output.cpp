@@ -24,6 +24,7 @@
 #include "memory.h"
 #include "modify.h"
 #include "thermo.h"
+#include "timer.h"
 #include "update.h"
 #include "variable.h"
 #include "write_restart.h"
@@ -97,7 +98,10 @@ Output::~Output()
   for (int i = 0; i < ndump; i++) delete [] var_dump[i];
   memory->sfree(var_dump);
   memory->destroy(ivar_dump);
-  for (int i = 0; i < ndump; i++) delete dump[i];
+  for (int i = 0; i < ndump; i++) {
+    dump[i]->async_wait(0);
+    delete dump[i];
+  }
   memory->sfree(dump);
 
   delete [] restart1;
@@ -123,7 +127,11 @@ void Output::init()
       error->all(FLERR,"Variable for thermo every is invalid style");
   }
 
-  for (int i = 0; i < ndump; i++) dump[i]->init();
+  for (int i = 0; i < ndump; i++) {
+    dump[i]->init();
+    dump[i]->timer_detail = timer->detail_id(fmt::format("dump {}",
+                                                         dump[i]->id));
+  }
   for (int i = 0; i < ndump; i++)
     if (every_dump[i] == 0) {
       ivar_dump[i] = input->variable->find(var_dump[i]);
@@ -167,8 +175,8 @@ void Output::setup(int memflag)
   // set next_dump to multiple of every or variable value
   // set next_dump_any to smallest next_dump
   // wrap dumps that invoke computes and variable eval with clear/add
-  // if dump not written now, use addstep_compute_all() since don't know
-  //   what computes the dump write would invoke
+  // if dump not written now, add next_dump to computes the dump may invoke
+  //   as found by Modify::depend_init()
   // if no dumps, set next_dump_any to last+1 so will not influence next
 
   int writeflag;
@@ -198,7 +206,8 @@ void Output::setup(int memflag)
       }
       if (dump[idump]->clearstep || every_dump[idump] == 0) {
         if (writeflag) modify->addstep_compute(next_dump[idump]);
-        else modify->addstep_compute_all(next_dump[idump]);
+        else modify->addstep_compute(next_dump[idump],
+                                     std::string("dump ") + dump[idump]->id);
       }
       if (idump) next_dump_any = MIN(next_dump_any,next_dump[idump]);
       else next_dump_any = next_dump[0];
@@ -289,7 +298,9 @@ void Output::write(bigint ntimestep)
         if (dump[idump]->clearstep || every_dump[idump] == 0)
           modify->clearstep_compute();
         if (last_dump[idump] != ntimestep) {
+          timer->detail_start(dump[idump]->timer_detail);
           dump[idump]->write();
+          timer->detail_stop(dump[idump]->timer_detail);
           last_dump[idump] = ntimestep;
         }
         if (every_dump[idump]) next_dump[idump] += every_dump[idump];
@@ -573,6 +584,7 @@ void Output::add_dump(int narg, char **arg)
   last_dump[ndump] = -1;
   var_dump[ndump] = nullptr;
   ndump++;
+  modify->record_command("dump",narg,arg);
 }
 
 /* ----------------------------------------------------------------------
@@ -601,6 +613,7 @@ void Output::modify_dump(int narg, char **arg)
   if (idump == ndump) error->all(FLERR,"Cound not find dump_modify ID");
 
   dump[idump]->modify_params(narg-1,&arg[1]);
+  modify->record_command("dump",narg,arg,1);
 }
 
 /* ----------------------------------------------------------------------
@@ -616,6 +629,8 @@ void Output::delete_dump(char *id)
     if (strcmp(id,dump[idump]->id) == 0) break;
   if (idump == ndump) error->all(FLERR,"Could not find undump ID");
 
+  dump[idump]->async_wait();
+  modify->forget_command(std::string("dump ") + id);
   delete dump[idump];
   delete [] var_dump[idump];
 
@@ -24,6 +24,7 @@
 #include "pair.h"
 #include "respa.h"
 #include "suffix.h"
+#include "timer.h"
 #include "update.h"
 
 #include <cstring>
@@ -34,7 +35,8 @@ using namespace LAMMPS_NS;
 
 PairHybrid::PairHybrid(LAMMPS *lmp) : Pair(lmp),
   styles(nullptr), keywords(nullptr), multiple(nullptr), nmap(nullptr),
-  map(nullptr), special_lj(nullptr), special_coul(nullptr), compute_tally(nullptr)
+  map(nullptr), special_lj(nullptr), special_coul(nullptr), compute_tally(nullptr),
+  timer_detail(nullptr)
 {
   nstyles = 0;
 
@@ -61,6 +63,7 @@ PairHybrid::~PairHybrid()
   delete [] special_lj;
   delete [] special_coul;
   delete [] compute_tally;
+  delete [] timer_detail;
 
   delete [] svector;
 
@@ -128,9 +131,11 @@ void PairHybrid::compute(int eflag, int vflag)
       // outerflag is set and sub-style has a compute_outer() method
 
       if (styles[m]->compute_flag == 0) continue;
+      timer->detail_start(timer_detail[m]);
       if (outerflag && styles[m]->respa_enable)
         styles[m]->compute_outer(eflag,vflag_substyle);
       else styles[m]->compute(eflag,vflag_substyle);
+      timer->detail_stop(timer_detail[m]);
     }
 
     restore_special(saved_special);
@@ -584,6 +589,16 @@ void PairHybrid::init_style()
 
   for (istyle = 0; istyle < nstyles; istyle++) styles[istyle]->init_style();
 
+  // detailed timers of sub-styles
+
+  delete [] timer_detail;
+  timer_detail = new int[nstyles];
+  for (istyle = 0; istyle < nstyles; istyle++) {
+    std::string name = fmt::format("pair {}",keywords[istyle]);
+    if (multiple[istyle]) name += fmt::format(" {}",multiple[istyle]);
+    timer_detail[istyle] = timer->detail_id(name);
+  }
+
   // create skip lists inside each pair neigh request
   // any kind of list can have its skip flag set in this loop
 
@@ -78,6 +78,7 @@ class PairHybrid : public Pair {
   double **special_lj;          // list of per style LJ exclusion factors
   double **special_coul;        // list of per style Coulomb exclusion factors
   int *compute_tally;           // list of on/off flags for tally computes
+  int *timer_detail;            // ids of detailed timers of each sub-style
 
   void allocate();
   void flags();
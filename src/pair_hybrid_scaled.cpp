@@ -22,6 +22,7 @@
 #include "memory.h"
 #include "respa.h"
 #include "suffix.h"
+#include "timer.h"
 #include "update.h"
 #include "variable.h"
 
@@ -150,9 +151,11 @@ void PairHybridScaled::compute(int eflag, int vflag)
       // outerflag is set and sub-style has a compute_outer() method
 
       if (styles[m]->compute_flag == 0) continue;
+      timer->detail_start(timer_detail[m]);
       if (outerflag && styles[m]->respa_enable)
         styles[m]->compute_outer(eflag,vflag_substyle);
       else styles[m]->compute(eflag,vflag_substyle);
+      timer->detail_stop(timer_detail[m]);
     }
 
     // add scaled forces to global sum
@@ -33,6 +33,7 @@
 #include "modify.h"
 #include "molecule.h"
 #include "pair.h"
+#include "read_data_binary.h"
 #include "special.h"
 #include "update.h"
 
@@ -311,6 +312,16 @@ void ReadData::command(int narg, char **arg)
     error->all(FLERR,fmt::format("Cannot open file {}: {}",
                                  arg[0], utils::getsyserror()));
 
+  // binary data files have no header or sections to add to
+
+  int binaryflag = 0;
+  if (me == 0) binaryflag = ReadDataBinary::is_binary(arg[0]);
+  MPI_Bcast(&binaryflag,1,MPI_INT,0,world);
+
+  if (binaryflag && (addflag != NONE || offsetflag || shiftflag || nfix))
+    error->all(FLERR,"Read_data add, offset, shift, or fix keyword "
+               "cannot be used with a binary data file");
+
   // first time system initialization
 
   if (addflag == NONE) {
@@ -318,6 +329,24 @@ void ReadData::command(int narg, char **arg)
     update->ntimestep = 0;
   }
 
+  // each proc reads its atoms from a binary data file directly
+
+  if (binaryflag) {
+    atom->ntypes = extra_atom_types;
+    atom->nbondtypes = extra_bond_types;
+    atom->nangletypes = extra_angle_types;
+    atom->ndihedraltypes = extra_dihedral_types;
+    atom->nimpropertypes = extra_improper_types;
+
+    ReadDataBinary reader(lmp);
+    reader.command(arg[0],groupbit);
+
+    MPI_Barrier(world);
+    if (me == 0)
+      utils::logmesg(lmp,"  read_data CPU = {:.3f} seconds\n",MPI_Wtime()-time1);
+    return;
+  }
+
   // compute atomID and optionally moleculeID offset for addflag = APPEND
 
   if (addflag == APPEND) {
@@ -123,6 +123,10 @@ Self-explanatory.  Check the input script syntax and compare to the
 documentation for the command.  You can use -echo screen as a
 command-line option when running LAMMPS to see the offending line.
 
+E: Read_data add, offset, shift, or fix keyword cannot be used with a binary data file
+
+Binary data files can only be read to create a new system.
+
 E: Read data add atomID offset is too big
 
 UNDOCUMENTED
@@ -0,0 +1,644 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://lammps.sandia.gov/, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "read_data_binary.h"
+
+#include "atom.h"
+#include "atom_vec.h"
+#include "comm.h"
+#include "domain.h"
+#include "error.h"
+#include "force.h"
+#include "group.h"
+#include "irregular.h"
+#include "memory.h"
+#include "special.h"
+
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace LAMMPS_NS;
+
+static constexpr double LB_FACTOR = 1.1;
+static constexpr char MAGIC[] = "LMPBDATA";
+static constexpr int REVISION = 1;
+static constexpr int ENDIAN = 0x01020304;
+
+enum{BOND,ANGLE,DIHEDRAL,IMPROPER};
+static const char *topo_names[] = {"bonds","angles","dihedrals","impropers"};
+static const int topo_nper[] = {2,3,4,4};
+
+// the file layout must not depend on the compiler
+
+static_assert(sizeof(BinaryDataHeader) == 176,"unexpected binary data header size");
+static_assert(sizeof(BinaryDataAtom) == 88,"unexpected binary data atom size");
+static_assert(sizeof(BinaryDataTopo) == 40,"unexpected binary data topology size");
+
+/* ---------------------------------------------------------------------- */
+
+ReadDataBinary::ReadDataBinary(LAMMPS *lmp) : Pointers(lmp)
+{
+  MPI_Comm_rank(world,&me);
+  fd = -1;
+  base = nullptr;
+  fp = nullptr;
+  filesize = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+ReadDataBinary::~ReadDataBinary()
+{
+  close();
+}
+
+/* ----------------------------------------------------------------------
+   return 1 if file starts with the magic string of binary data files
+------------------------------------------------------------------------- */
+
+int ReadDataBinary::is_binary(const char *file)
+{
+  char magic[8];
+  FILE *fptr = fopen(file,"rb");
+  if (fptr == nullptr) return 0;
+  size_t n = fread(magic,1,8,fptr);
+  fclose(fptr);
+  return (n == 8 && memcmp(magic,MAGIC,8) == 0) ? 1 : 0;
+}
+
+/* ----------------------------------------------------------------------
+   clear header and set the values identifying the file format
+------------------------------------------------------------------------- */
+
+void ReadDataBinary::init_header(BinaryDataHeader &header)
+{
+  memset(&header,0,sizeof(BinaryDataHeader));
+  memcpy(header.magic,MAGIC,8);
+  header.revision = REVISION;
+  header.endian = ENDIAN;
+}
+
+/* ----------------------------------------------------------------------
+   index of the cell containing a point with lamda coords
+   points outside the box are assigned to the nearest cell
+------------------------------------------------------------------------- */
+
+bigint ReadDataBinary::cell(const BinaryDataHeader &header, const double *lamda)
+{
+  bigint ix = cell1d(lamda[0],header.ncell[0]);
+  bigint iy = cell1d(lamda[1],header.ncell[1]);
+  bigint iz = cell1d(lamda[2],header.ncell[2]);
+  return (iz*header.ncell[1] + iy)*header.ncell[0] + ix;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int ReadDataBinary::cell1d(double lamda, int n)
+{
+  if (!(lamda > 0.0)) return 0;
+  double s = lamda*n;
+  if (s >= n) return n-1;
+  return static_cast<int> (s);
+}
+
+/* ----------------------------------------------------------------------
+   read a binary data file, called by all procs
+   each proc maps the file and reads only the cells overlapping its
+     sub-domain, so no data is communicated
+------------------------------------------------------------------------- */
+
+void ReadDataBinary::command(const char *file, int groupbit)
+{
+  if (me == 0) utils::logmesg(lmp,"Reading binary data file ...\n");
+
+  open(file);
+  memcpy(&hdr,fetch(0,sizeof(BinaryDataHeader)),sizeof(BinaryDataHeader));
+  offset = sizeof(BinaryDataHeader);
+
+  if (hdr.revision != REVISION || hdr.endian != ENDIAN)
+    error->all(FLERR,"Binary data file has an unknown revision or byte order");
+  if (hdr.ncell[0] < 1 || hdr.ncell[1] < 1 || hdr.ncell[2] < 1)
+    error->all(FLERR,"Binary data file has an invalid cell index");
+  ncell = (bigint) hdr.ncell[0] * hdr.ncell[1] * hdr.ncell[2];
+
+  if (atom->ellipsoid_flag || atom->line_flag || atom->tri_flag ||
+      atom->body_flag || atom->molecular == Atom::TEMPLATE)
+    error->all(FLERR,"Binary data files are not supported by this atom style");
+
+  // global counts, the "extra" types were already set by ReadData
+
+  atom->natoms = hdr.natoms;
+  atom->nbonds = hdr.nbonds;
+  atom->nangles = hdr.nangles;
+  atom->ndihedrals = hdr.ndihedrals;
+  atom->nimpropers = hdr.nimpropers;
+  atom->ntypes += hdr.ntypes;
+  atom->nbondtypes += hdr.nbondtypes;
+  atom->nangletypes += hdr.nangletypes;
+  atom->ndihedraltypes += hdr.ndihedraltypes;
+  atom->nimpropertypes += hdr.nimpropertypes;
+
+  if (atom->natoms < 0 || atom->natoms >= MAXBIGINT ||
+      atom->nbonds < 0 || atom->nangles < 0 ||
+      atom->ndihedrals < 0 || atom->nimpropers < 0)
+    error->all(FLERR,"System in data file is too big");
+  if ((atom->nbonds || atom->nbondtypes) && atom->avec->bonds_allow == 0)
+    error->all(FLERR,"No bonds allowed with this atom style");
+  if ((atom->nangles || atom->nangletypes) && atom->avec->angles_allow == 0)
+    error->all(FLERR,"No angles allowed with this atom style");
+  if ((atom->ndihedrals || atom->ndihedraltypes) &&
+      atom->avec->dihedrals_allow == 0)
+    error->all(FLERR,"No dihedrals allowed with this atom style");
+  if ((atom->nimpropers || atom->nimpropertypes) &&
+      atom->avec->impropers_allow == 0)
+    error->all(FLERR,"No impropers allowed with this atom style");
+
+  if (me == 0)
+    utils::logmesg(lmp,"  {} by {} by {} cell index\n",
+                   hdr.ncell[0],hdr.ncell[1],hdr.ncell[2]);
+
+  // problem setup as in ReadData for the first data file
+
+  atom->bond_per_atom = atom->extra_bond_per_atom;
+  atom->angle_per_atom = atom->extra_angle_per_atom;
+  atom->dihedral_per_atom = atom->extra_dihedral_per_atom;
+  atom->improper_per_atom = atom->extra_improper_per_atom;
+
+  int n;
+  if (comm->nprocs == 1) n = static_cast<int> (atom->natoms);
+  else n = static_cast<int> (LB_FACTOR * atom->natoms / comm->nprocs);
+
+  atom->allocate_type_arrays();
+  atom->deallocate_topology();
+
+  bigint nbig = n;
+  nbig = atom->avec->roundup(nbig);
+  n = static_cast<int> (nbig);
+  atom->avec->grow(n);
+
+  for (int i = 0; i < 3; i++) {
+    domain->boxlo[i] = hdr.boxlo[i];
+    domain->boxhi[i] = hdr.boxhi[i];
+  }
+  if (hdr.triclinic) {
+    domain->triclinic = 1;
+    domain->xy = hdr.xy; domain->xz = hdr.xz; domain->yz = hdr.yz;
+  }
+
+  domain->print_box("  ");
+  domain->set_initial_box();
+  domain->set_global_box();
+  comm->set_proc_grid();
+  domain->set_local_box();
+
+  // masses
+
+  std::vector<double> mass(hdr.ntypes);
+  if (hdr.ntypes)
+    memcpy(mass.data(),fetch(offset,hdr.ntypes*sizeof(double)),
+           hdr.ntypes*sizeof(double));
+  offset += hdr.ntypes*sizeof(double);
+
+  if (atom->mass)
+    for (int i = 0; i < hdr.ntypes; i++)
+      if (mass[i] > 0.0) atom->set_mass(FLERR,i+1,mass[i]);
+
+  // atoms
+
+  atoms();
+
+  // two passes over the topology sections of my cells
+  // 1st pass counts topology per atom, 2nd pass stores it
+
+  bigint ntopo[4] = {hdr.nbonds,hdr.nangles,hdr.ndihedrals,hdr.nimpropers};
+  bigint topo_offset = offset;
+
+  int *count;
+  memory->create(count,MAX(1,atom->nlocal),"read_data:count");
+
+  for (int which = BOND; which <= IMPROPER; which++) {
+    if (ntopo[which] == 0) continue;
+    if (me == 0) utils::logmesg(lmp,"  scanning {} ...\n",topo_names[which]);
+    memset(count,0,atom->nlocal*sizeof(int));
+    topology(which,count);
+
+    int max = 0;
+    for (int i = 0; i < atom->nlocal; i++) max = MAX(max,count[i]);
+    int maxall;
+    MPI_Allreduce(&max,&maxall,1,MPI_INT,MPI_MAX,world);
+
+    if (which == BOND) {
+      maxall += atom->extra_bond_per_atom;
+      atom->bond_per_atom = maxall;
+    } else if (which == ANGLE) {
+      maxall += atom->extra_angle_per_atom;
+      atom->angle_per_atom = maxall;
+    } else if (which == DIHEDRAL) {
+      maxall += atom->extra_dihedral_per_atom;
+      atom->dihedral_per_atom = maxall;
+    } else {
+      maxall += atom->extra_improper_per_atom;
+      atom->improper_per_atom = maxall;
+    }
+
+    if (me == 0)
+      utils::logmesg(lmp,"  {} = max {}/atom\n",maxall,topo_names[which]);
+  }
+
+  memory->destroy(count);
+
+  if (hdr.nbonds || hdr.nangles || hdr.ndihedrals || hdr.nimpropers) {
+    atom->deallocate_topology();
+    atom->avec->grow(atom->nmax);
+
+    offset = topo_offset;
+    for (int which = BOND; which <= IMPROPER; which++) {
+      if (ntopo[which] == 0) continue;
+      if (me == 0) utils::logmesg(lmp,"  reading {} ...\n",topo_names[which]);
+      topology(which,nullptr);
+      check_topology(which);
+    }
+  }
+
+  close();
+
+  // init per-atom fix/compute/variable values for created atoms
+
+  atom->data_fix_compute_variable(0,atom->nlocal);
+
+  // assign atoms to specified group
+
+  if (groupbit) {
+    int *mask = atom->mask;
+    int nlocal = atom->nlocal;
+    for (int i = 0; i < nlocal; i++)
+      mask[i] |= groupbit;
+  }
+
+  // create special bond lists for molecular systems
+
+  if (atom->molecular == Atom::MOLECULAR) {
+    Special special(lmp);
+    special.build();
+  }
+
+  // shrink-wrap the box if necessary and move atoms to new procs
+
+  if (domain->nonperiodic == 2) {
+    if (domain->triclinic) domain->x2lamda(atom->nlocal);
+    domain->reset_box();
+    Irregular *irregular = new Irregular(lmp);
+    irregular->migrate_atoms(1);
+    delete irregular;
+    if (domain->triclinic) domain->lamda2x(atom->nlocal);
+
+    bigint natoms;
+    bigint nblocal = atom->nlocal;
+    MPI_Allreduce(&nblocal,&natoms,1,MPI_LMP_BIGINT,MPI_SUM,world);
+    if (natoms != atom->natoms)
+      error->all(FLERR,
+                 "Read_data shrink wrap did not assign all atoms correctly");
+  }
+}
+
+/* ----------------------------------------------------------------------
+   create the atoms in my sub-domain
+   only the cells overlapping my sub-domain are read
+------------------------------------------------------------------------- */
+
+void ReadDataBinary::atoms()
+{
+  if (me == 0) utils::logmesg(lmp,"  reading atoms ...\n");
+
+  // bounds of my sub-domain in lamda coords and the cells they overlap
+
+  int triclinic = domain->triclinic;
+  double sublo[3],subhi[3];
+  atom->data_subdomain(sublo,subhi);
+
+  for (int i = 0; i < 3; i++) {
+    double lo = sublo[i];
+    double hi = subhi[i];
+    if (!triclinic) {
+      lo = domain->h_inv[i] * (lo - domain->boxlo[i]);
+      hi = domain->h_inv[i] * (hi - domain->boxlo[i]);
+    }
+    clo[i] = cell1d(lo,hdr.ncell[i]);
+    chi[i] = cell1d(hi,hdr.ncell[i]);
+  }
+
+  read_index();
+  if (index[ncell] != hdr.natoms)
+    error->all(FLERR,"Binary data file has an invalid cell index");
+
+  AtomVec *avec = atom->avec;
+  int ntypes = atom->ntypes;
+  int dimension = domain->dimension;
+  int flagx = 0, flagy = 0, flagz = 0;
+  double xdata[3],lamda[3];
+  double *coord;
+
+  for (int iz = clo[2]; iz <= chi[2]; iz++)
+    for (int iy = clo[1]; iy <= chi[1]; iy++)
+      for (int ix = clo[0]; ix <= chi[0]; ix++) {
+        bigint icell = ((bigint) iz*hdr.ncell[1] + iy)*hdr.ncell[0] + ix;
+        bigint n = index[icell+1] - index[icell];
+        if (n == 0) continue;
+        const BinaryDataAtom *rec = (const BinaryDataAtom *)
+          fetch(offset + index[icell]*sizeof(BinaryDataAtom),
+                n*sizeof(BinaryDataAtom));
+
+        for (bigint i = 0; i < n; i++) {
+          const BinaryDataAtom &one = rec[i];
+          xdata[0] = one.x[0];
+          xdata[1] = one.x[1];
+          xdata[2] = one.x[2];
+          if (triclinic) {
+            domain->x2lamda(xdata,lamda);
+            coord = lamda;
+          } else coord = xdata;
+
+          if (coord[0] < sublo[0] || coord[0] >= subhi[0] ||
+              coord[1] < sublo[1] || coord[1] >= subhi[1] ||
+              coord[2] < sublo[2] || coord[2] >= subhi[2]) continue;
+
+          if (one.id <= 0 || one.id > MAXTAGINT)
+            error->one(FLERR,"Invalid atom ID in binary data file");
+          if (one.type <= 0 || one.type > ntypes)
+            error->one(FLERR,"Invalid atom type in binary data file");
+
+          int imx = one.image[0], imy = one.image[1], imz = one.image[2];
+          if ((dimension == 2) && (imz != 0))
+            error->one(FLERR,"Z-direction image flag must be 0 for 2d-systems");
+          if ((!domain->xperiodic) && (imx != 0)) { flagx = 1; imx = 0; }
+          if ((!domain->yperiodic) && (imy != 0)) { flagy = 1; imy = 0; }
+          if ((!domain->zperiodic) && (imz != 0)) { flagz = 1; imz = 0; }
+
+          int m = atom->nlocal;
+          avec->create_atom(one.type,xdata);
+          atom->tag[m] = one.id;
+          atom->image[m] = ((imageint) (imx + IMGMAX) & IMGMASK) |
+            (((imageint) (imy + IMGMAX) & IMGMASK) << IMGBITS) |
+            (((imageint) (imz + IMGMAX) & IMGMASK) << IMG2BITS);
+          if (hdr.velflag) {
+            atom->v[m][0] = one.v[0];
+            atom->v[m][1] = one.v[1];
+            atom->v[m][2] = one.v[2];
+          }
+          if (hdr.molflag && atom->molecule_flag)
+            atom->molecule[m] = one.molecule;
+          if (hdr.qflag && atom->q_flag) atom->q[m] = one.q;
+        }
+      }
+
+  offset += hdr.natoms*sizeof(BinaryDataAtom);
+
+  int flags[3] = {flagx,flagy,flagz}, flagsall[3];
+  MPI_Allreduce(flags,flagsall,3,MPI_INT,MPI_MAX,world);
+  if (me == 0) {
+    if (flagsall[0])
+      error->warning(FLERR,"Non-zero imageflag(s) in x direction for "
+                           "non-periodic boundary reset to zero");
+    if (flagsall[1])
+      error->warning(FLERR,"Non-zero imageflag(s) in y direction for "
+                           "non-periodic boundary reset to zero");
+    if (flagsall[2])
+      error->warning(FLERR,"Non-zero imageflag(s) in z direction for "
+                           "non-periodic boundary reset to zero");
+  }
+
+  // check that all atoms were assigned correctly
+
+  bigint nblocal = atom->nlocal;
+  bigint sum;
+  MPI_Allreduce(&nblocal,&sum,1,MPI_LMP_BIGINT,MPI_SUM,world);
+
+  if (me == 0) utils::logmesg(lmp,"  {} atoms\n",sum);
+
+  if (sum != atom->natoms)
+    error->all(FLERR,"Did not assign all atoms correctly");
+
+  atom->tag_check();
+
+  if (atom->map_style != Atom::MAP_NONE) {
+    atom->map_init();
+    atom->map_set();
+  }
+}
+
+/* ----------------------------------------------------------------------
+   read one topology section for the cells overlapping my sub-domain
+   if count is non-nullptr, just count topology per atom
+------------------------------------------------------------------------- */
+
+void ReadDataBinary::topology(int which, int *count)
+{
+  read_index();
+
+  for (int iz = clo[2]; iz <= chi[2]; iz++)
+    for (int iy = clo[1]; iy <= chi[1]; iy++)
+      for (int ix = clo[0]; ix <= chi[0]; ix++) {
+        bigint icell = ((bigint) iz*hdr.ncell[1] + iy)*hdr.ncell[0] + ix;
+        bigint n = index[icell+1] - index[icell];
+        if (n == 0) continue;
+        const BinaryDataTopo *rec = (const BinaryDataTopo *)
+          fetch(offset + index[icell]*sizeof(BinaryDataTopo),
+                n*sizeof(BinaryDataTopo));
+        for (bigint i = 0; i < n; i++) store(which,rec[i],count);
+      }
+
+  offset += index[ncell]*sizeof(BinaryDataTopo);
+}
+
+/* ----------------------------------------------------------------------
+   count or store one bond, angle, dihedral, or improper with my atoms
+   with newton_bond set, only the atom that owns it in Atom::data_bonds()
+     etc stores it, else all of its atoms
+------------------------------------------------------------------------- */
+
+void ReadDataBinary::store(int which, const BinaryDataTopo &one, int *count)
+{
+  const int nper = topo_nper[which];
+  const int owner = (which == BOND) ? 0 : 1;
+  const int newton_bond = force->newton_bond;
+  int ntypes;
+  if (which == BOND) ntypes = atom->nbondtypes;
+  else if (which == ANGLE) ntypes = atom->nangletypes;
+  else if (which == DIHEDRAL) ntypes = atom->ndihedraltypes;
+  else ntypes = atom->nimpropertypes;
+
+  if (one.type <= 0 || one.type > ntypes)
+    error->one(FLERR,"Invalid topology type in binary data file");
+  for (int k = 0; k < nper; k++) {
+    if (one.atom[k] <= 0 || one.atom[k] > atom->map_tag_max)
+      error->one(FLERR,"Invalid atom ID in binary data file");
+    for (int l = 0; l < k; l++)
+      if (one.atom[k] == one.atom[l])
+        error->one(FLERR,"Invalid atom ID in binary data file");
+  }
+
+  for (int k = 0; k < nper; k++) {
+    if (!(one.mask & (1 << k))) continue;
+    if (newton_bond && k != owner) continue;
+    int m = atom->map(one.atom[k]);
+    if (m < 0) continue;
+    if (count) {
+      count[m]++;
+      continue;
+    }
+
+    if (which == BOND) {
+      int j = atom->num_bond[m]++;
+      atom->bond_type[m][j] = one.type;
+      atom->bond_atom[m][j] = one.atom[1-k];
+    } else if (which == ANGLE) {
+      int j = atom->num_angle[m]++;
+      atom->angle_type[m][j] = one.type;
+      atom->angle_atom1[m][j] = one.atom[0];
+      atom->angle_atom2[m][j] = one.atom[1];
+      atom->angle_atom3[m][j] = one.atom[2];
+    } else if (which == DIHEDRAL) {
+      int j = atom->num_dihedral[m]++;
+      atom->dihedral_type[m][j] = one.type;
+      atom->dihedral_atom1[m][j] = one.atom[0];
+      atom->dihedral_atom2[m][j] = one.atom[1];
+      atom->dihedral_atom3[m][j] = one.atom[2];
+      atom->dihedral_atom4[m][j] = one.atom[3];
+    } else {
+      int j = atom->num_improper[m]++;
+      atom->improper_type[m][j] = one.type;
+      atom->improper_atom1[m][j] = one.atom[0];
+      atom->improper_atom2[m][j] = one.atom[1];
+      atom->improper_atom3[m][j] = one.atom[2];
+      atom->improper_atom4[m][j] = one.atom[3];
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   check that a topology section was assigned correctly
+------------------------------------------------------------------------- */
+
+void ReadDataBinary::check_topology(int which)
+{
+  int nlocal = atom->nlocal;
+  int *num;
+  bigint ntotal;
+  if (which == BOND) { num = atom->num_bond; ntotal = atom->nbonds; }
+  else if (which == ANGLE) { num = atom->num_angle; ntotal = atom->nangles; }
+  else if (which == DIHEDRAL) {
+    num = atom->num_dihedral;
+    ntotal = atom->ndihedrals;
+  } else { num = atom->num_improper; ntotal = atom->nimpropers; }
+
+  bigint n = 0;
+  for (int i = 0; i < nlocal; i++) n += num[i];
+  bigint sum;
+  MPI_Allreduce(&n,&sum,1,MPI_LMP_BIGINT,MPI_SUM,world);
+  int factor = 1;
+  if (!force->newton_bond) factor = topo_nper[which];
+
+  if (me == 0) utils::logmesg(lmp,"  {} {}\n",sum/factor,topo_names[which]);
+
+  if (sum != factor*ntotal) {
+    if (which == BOND) error->all(FLERR,"Bonds assigned incorrectly");
+    else if (which == ANGLE) error->all(FLERR,"Angles assigned incorrectly");
+    else if (which == DIHEDRAL)
+      error->all(FLERR,"Dihedrals assigned incorrectly");
+    else error->all(FLERR,"Impropers assigned incorrectly");
+  }
+}
+
+/* ----------------------------------------------------------------------
+   read the cell index at the start of the current section
+   advance offset to the first record of the section
+------------------------------------------------------------------------- */
+
+void ReadDataBinary::read_index()
+{
+  index.resize(ncell+1);
+  memcpy(index.data(),fetch(offset,(ncell+1)*sizeof(int64_t)),
+         (ncell+1)*sizeof(int64_t));
+  offset += (ncell+1)*sizeof(int64_t);
+
+  if (index[0] != 0) error->all(FLERR,"Binary data file has an invalid cell index");
+  for (bigint i = 0; i < ncell; i++)
+    if (index[i+1] < index[i])
+      error->all(FLERR,"Binary data file has an invalid cell index");
+}
+
+/* ----------------------------------------------------------------------
+   map file into memory, read by all procs
+------------------------------------------------------------------------- */
+
+void ReadDataBinary::open(const char *file)
+{
+#if defined(_WIN32)
+  fp = fopen(file,"rb");
+  if (fp == nullptr)
+    error->one(FLERR,"Cannot open file {}: {}",file,utils::getsyserror());
+  fseek(fp,0,SEEK_END);
+  filesize = ftell(fp);
+#else
+  fd = ::open(file,O_RDONLY);
+  if (fd < 0)
+    error->one(FLERR,"Cannot open file {}: {}",file,utils::getsyserror());
+  struct stat st;
+  if (fstat(fd,&st) < 0)
+    error->one(FLERR,"Cannot open file {}: {}",file,utils::getsyserror());
+  filesize = st.st_size;
+  void *ptr = mmap(nullptr,filesize,PROT_READ,MAP_SHARED,fd,0);
+  if (ptr == MAP_FAILED)
+    error->one(FLERR,"Cannot open file {}: {}",file,utils::getsyserror());
+  base = (char *) ptr;
+#endif
+}
+
+/* ---------------------------------------------------------------------- */
+
+void ReadDataBinary::close()
+{
+#if !defined(_WIN32)
+  if (base) munmap(base,filesize);
+  if (fd >= 0) ::close(fd);
+#endif
+  if (fp) fclose(fp);
+  base = nullptr;
+  fd = -1;
+  fp = nullptr;
+}
+
+/* ----------------------------------------------------------------------
+   return pointer to nbytes of the file starting at start
+   without mmap(), the bytes are read into a buffer which is valid
+     until the next call
+------------------------------------------------------------------------- */
+
+const char *ReadDataBinary::fetch(bigint start, bigint nbytes)
+{
+  if (start < 0 || nbytes < 0 || start + nbytes > filesize)
+    error->one(FLERR,"Binary data file is truncated");
+  if (base) return base + start;
+
+  buffer.resize(MAX(nbytes,1));
+  fseek(fp,start,SEEK_SET);
+  if ((bigint) fread(buffer.data(),1,nbytes,fp) != nbytes)
+    error->one(FLERR,"Binary data file is truncated");
+  return buffer.data();
+}
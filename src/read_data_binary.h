@@ -0,0 +1,192 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://lammps.sandia.gov/, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifndef LMP_READ_DATA_BINARY_H
+#define LMP_READ_DATA_BINARY_H
+
+#include "pointers.h"
+
+#include <vector>
+
+namespace LAMMPS_NS {
+
+// layout of binary data files, in the byte order of the writing machine:
+//   header
+//   ntypes masses, 0.0 if not set
+//   ncell+1 index of first atom record of each cell of a coarse grid
+//   natoms atom records, sorted by cell
+//   for bonds, angles, dihedrals, impropers if their count is > 0:
+//     ncell+1 index of first record of each cell
+//     topology records, sorted by cell
+
+struct BinaryDataHeader {
+  char magic[8];
+  int revision;
+  int endian;                       // detects a different byte order
+  int64_t natoms,nbonds,nangles,ndihedrals,nimpropers;
+  int ntypes,nbondtypes,nangletypes,ndihedraltypes,nimpropertypes;
+  int triclinic;
+  int velflag,molflag,qflag;        // 1 if atom records have these values
+  int ncell[3];                     // grid over the box in lamda coords
+  double boxlo[3],boxhi[3];
+  double xy,xz,yz;
+};
+
+struct BinaryDataAtom {
+  int64_t id,molecule;
+  int type;
+  int image[3];
+  double x[3],v[3];
+  double q;
+};
+
+// a bond, angle, etc is stored once in each cell that contains one
+// of its atoms, bit I of mask is set if atom[I] is in that cell
+
+struct BinaryDataTopo {
+  int64_t atom[4];                  // unused atoms are 0
+  int type;
+  int mask;
+};
+
+class ReadDataBinary : protected Pointers {
+ public:
+  ReadDataBinary(class LAMMPS *);
+  ~ReadDataBinary();
+
+  static int is_binary(const char *);
+  static void init_header(BinaryDataHeader &);
+  static bigint cell(const BinaryDataHeader &, const double *);
+  static int cell1d(double, int);
+
+  void command(const char *, int);
+
+ private:
+  int me;
+  BinaryDataHeader hdr;
+  bigint ncell;
+  std::vector<int64_t> index;       // cell index of current section
+  bigint offset;                    // file offset of current section
+  int clo[3],chi[3];                // range of cells overlapping my sub-domain
+
+  int fd;                           // file descriptor of mapped file
+  char *base;                       // start of mapped file
+  bigint filesize;
+  FILE *fp;                         // used where mmap() is not available
+  std::vector<char> buffer;
+
+  void open(const char *);
+  void close();
+  const char *fetch(bigint, bigint);
+  void read_index();
+
+  void atoms();
+  void topology(int, int *);
+  void store(int, const BinaryDataTopo &, int *);
+  void check_topology(int);
+};
+
+}
+
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Cannot open file %s: %s
+
+The binary data file could not be opened or mapped into memory.
+
+E: Binary data file is truncated
+
+A section of the file extends beyond its end.
+
+E: Binary data file has an unknown revision or byte order
+
+The file was written by an incompatible version of LAMMPS or on a
+machine with a different byte order.
+
+E: Binary data file has an invalid cell index
+
+The spatial index of the file is inconsistent.
+
+E: Binary data files are not supported by this atom style
+
+Atom styles with bonus data and atom style template cannot be read
+from binary data files.
+
+E: No bonds allowed with this atom style
+
+Self-explanatory.
+
+E: No angles allowed with this atom style
+
+Self-explanatory.
+
+E: No dihedrals allowed with this atom style
+
+Self-explanatory.
+
+E: No impropers allowed with this atom style
+
+Self-explanatory.
+
+E: Invalid atom ID in binary data file
+
+Atom IDs must be positive and no larger than the largest atom ID.
+
+E: Invalid atom type in binary data file
+
+Atom types must be between 1 and the number of atom types.
+
+E: Invalid topology type in binary data file
+
+Bond, angle, dihedral, and improper types must be between 1 and the
+number of types of their kind.
+
+E: Did not assign all atoms correctly
+
+Atoms read from the data file were not assigned correctly to
+processors.  The coordinates of all atoms must be inside the box.
+
+E: Bonds assigned incorrectly
+
+Bonds read in from the data file were not assigned correctly to atoms.
+This means there is something invalid about the topology definitions.
+
+E: Angles assigned incorrectly
+
+Angles read in from the data file were not assigned correctly to
+atoms.  This means there is something invalid about the topology
+definitions.
+
+E: Dihedrals assigned incorrectly
+
+Dihedrals read in from the data file were not assigned correctly to
+atoms.  This means there is something invalid about the topology
+definitions.
+
+E: Impropers assigned incorrectly
+
+Impropers read in from the data file were not assigned correctly to
+atoms.  This means there is something invalid about the topology
+definitions.
+
+E: Read_data shrink wrap did not assign all atoms correctly
+
+This is typically because the box-size specified in the data file is
+large compared to the actual extent of atoms in a shrink-wrapped
+dimension.  When LAMMPS shrink-wraps the box atoms will be lost if the
+processor they are re-assigned to is too far away.  Choose a box
+size closer to the actual extent of the atoms.
+
+*/
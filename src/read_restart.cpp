@@ -179,25 +179,7 @@ void ReadRestart::command(int narg, char **arg)
 
   // MPI-IO input from single file
 
-  if (mpiioflag) {
-    mpiio->openForRead(file);
-    memory->create(buf,assignedChunkSize,"read_restart:buf");
-    mpiio->read((headerOffset+assignedChunkOffset),assignedChunkSize,buf);
-    mpiio->close();
-
-    // can calculate number of atoms from assignedChunkSize
-
-    if (!nextra) {
-      atom->nlocal = 1; // temporarily claim there is one atom...
-      int perAtomSize = avec->size_restart(); // ...so we can get its size
-      atom->nlocal = 0; // restore nlocal to zero atoms
-      int atomCt = (int) (assignedChunkSize / perAtomSize);
-      if (atomCt > atom->nmax) avec->grow(atomCt);
-    }
-
-    m = 0;
-    while (m < assignedChunkSize) m += avec->unpack_restart(&buf[m]);
-  }
+  if (mpiioflag) read_mpiio(file);
 
   // input of single native file
   // nprocs_file = # of chunks in file
@@ -1003,6 +985,112 @@ void ReadRestart::force_fields()
   }
 }
 
+/* ----------------------------------------------------------------------
+   collective read of per-atom info from an MPI-IO restart file
+   each proc reads a balanced range lo:hi of the per-atom data (in doubles)
+   each proc unpacks the records that start within its range,
+     including their tails beyond hi, which higher procs send to it
+   record starts are passed up the chain of procs, a proc that knows
+     one in its range (a written chunk) forwards its end before it waits
+   atoms are migrated to their owning procs afterwards
+------------------------------------------------------------------------- */
+
+void ReadRestart::read_mpiio(const char *file)
+{
+  bigint lo = mpiio_total*me/nprocs;
+  bigint hi = mpiio_total*(me+1)/nprocs;
+  bigint n = hi - lo;
+
+  double *buf;
+  memory->create(buf,n,"read_restart:buf");
+  mpiio->openForRead(file);
+  mpiio->read(headerOffset+lo*sizeof(double),n,buf);
+  mpiio->close();
+
+  // recvinfo = 1st record start >= lo and
+  //   proc that unpacks the record ending there, from proc me-1
+  // sendinfo = same for proc me+1
+  // a proc with no record start in its range passes on the owner it got
+
+  bigint recvinfo[2],sendinfo[2];
+  MPI_Request request;
+
+  recvinfo[0] = recvinfo[1] = 0;
+  if (me) MPI_Irecv(recvinfo,2,MPI_LMP_BIGINT,me-1,0,world,&request);
+
+  int known = (me && chunk_start >= 0);
+  if (known) {
+    sendinfo[0] = end_of_records(buf,lo,hi,chunk_start);
+    sendinfo[1] = me;
+    if (me < nprocs-1) MPI_Send(sendinfo,2,MPI_LMP_BIGINT,me+1,0,world);
+  }
+  if (me) MPI_Wait(&request,MPI_STATUS_IGNORE);
+  bigint first = recvinfo[0];
+  int owner = recvinfo[1];
+  if (!known) {
+    if (first < hi) {
+      sendinfo[0] = end_of_records(buf,lo,hi,first);
+      sendinfo[1] = me;
+    } else {
+      sendinfo[0] = first;
+      sendinfo[1] = owner;
+    }
+    if (me < nprocs-1) MPI_Send(sendinfo,2,MPI_LMP_BIGINT,me+1,0,world);
+  }
+  bigint last = sendinfo[0];
+
+  // send head of my range that precedes 1st record start to its owner
+  // owners only ever send to lower procs, so this cannot deadlock
+
+  if (first > lo) {
+    int nsend = static_cast<int> ((first < hi ? first : hi) - lo);
+    MPI_Send(buf,nsend,MPI_DOUBLE,owner,1,world);
+  }
+
+  // receive tail of my last record from higher procs
+  // each message is placed by the range offset of the proc that sent it
+
+  if (first < hi && last > hi) {
+    memory->grow(buf,last-lo,"read_restart:buf");
+    MPI_Status status;
+    int count;
+    bigint nrecv = 0;
+    while (nrecv < last-hi) {
+      MPI_Probe(MPI_ANY_SOURCE,1,world,&status);
+      MPI_Get_count(&status,MPI_DOUBLE,&count);
+      bigint offset = mpiio_total*status.MPI_SOURCE/nprocs - lo;
+      MPI_Recv(&buf[offset],count,MPI_DOUBLE,status.MPI_SOURCE,1,world,
+               MPI_STATUS_IGNORE);
+      nrecv += count;
+    }
+  }
+
+  if (first < hi) {
+    AtomVec *avec = atom->avec;
+    bigint m = first - lo;
+    while (m < last-lo) m += avec->unpack_restart(&buf[m]);
+  }
+
+  memory->destroy(buf);
+}
+
+/* ----------------------------------------------------------------------
+   walk the records in buf from start, which holds data lo:hi
+   return start of the 1st record at or beyond hi
+------------------------------------------------------------------------- */
+
+bigint ReadRestart::end_of_records(double *buf, bigint lo, bigint hi,
+                                   bigint start)
+{
+  bigint m = start;
+  while (m < hi) {
+    bigint size = static_cast<bigint> (buf[m-lo]);
+    if (size <= 0) error->one(FLERR,"Invalid atom record in restart file");
+    m += size;
+  }
+  return m;
+}
+
 /* ---------------------------------------------------------------------- */
 
 void ReadRestart::file_layout()
@@ -1024,99 +1112,47 @@ void ReadRestart::file_layout()
       if (mpiioflag && mpiioflag_file == 0)
         error->all(FLERR,"Restart file is not a MPI-IO file");
 
+      // on rank 0 read in the chunk sizes that were written out
+      // each proc reads a balanced range of the per-atom data,
+      //   independent of the # of procs that wrote the file
+      // ranges ignore record boundaries, read_mpiio() finds them,
+      //   starting from the first written chunk within each range,
+      //   since every chunk begins with a complete atom record
+      // chunk_start = that chunk's offset in doubles, -1 if none
+
       if (mpiioflag) {
-        bigint *nproc_chunk_offsets;
-        memory->create(nproc_chunk_offsets,nprocs,
-                       "write_restart:nproc_chunk_offsets");
-        bigint *nproc_chunk_sizes;
-        memory->create(nproc_chunk_sizes,nprocs,
-                       "write_restart:nproc_chunk_sizes");
-
-        // on rank 0 read in the chunk sizes that were written out
-        // then consolidate them and compute offsets relative to the
-        // end of the header info to fit the current partition size
-        // if the number of ranks that did the writing is different
+        bigint *proc_chunk_start;
+        memory->create(proc_chunk_start,nprocs,
+                       "read_restart:proc_chunk_start");
 
         if (me == 0) {
-          int ndx;
           int *all_written_send_sizes;
           memory->create(all_written_send_sizes,nprocs_file,
-                         "write_restart:all_written_send_sizes");
-          int *nproc_chunk_number;
-          memory->create(nproc_chunk_number,nprocs,
-                         "write_restart:nproc_chunk_number");
-
-          utils::sfread(FLERR,all_written_send_sizes,sizeof(int),nprocs_file,fp,nullptr,error);
-
-          if ((nprocs != nprocs_file) && !(atom->nextra_store)) {
-            // nprocs differ, but atom sizes are fixed length, yeah!
-            atom->nlocal = 1; // temporarily claim there is one atom...
-            int perAtomSize = atom->avec->size_restart(); // ...so we can get its size
-            atom->nlocal = 0; // restore nlocal to zero atoms
-
-            bigint total_size = 0;
-            for (int i = 0; i < nprocs_file; ++i) {
-              total_size += all_written_send_sizes[i];
-            }
-            bigint total_ct = total_size / perAtomSize;
-
-            bigint base_ct = total_ct / nprocs;
-            bigint leftover_ct = total_ct  - (base_ct * nprocs);
-            bigint current_ByteOffset = 0;
-            base_ct += 1;
-            bigint base_ByteOffset = base_ct * (perAtomSize * sizeof(double));
-            for (ndx = 0; ndx < leftover_ct; ++ndx) {
-              nproc_chunk_offsets[ndx] = current_ByteOffset;
-              nproc_chunk_sizes[ndx] = base_ct * perAtomSize;
-              current_ByteOffset += base_ByteOffset;
-            }
-            base_ct -= 1;
-            base_ByteOffset -= (perAtomSize * sizeof(double));
-            for (; ndx < nprocs; ++ndx) {
-              nproc_chunk_offsets[ndx] = current_ByteOffset;
-              nproc_chunk_sizes[ndx] = base_ct * perAtomSize;
-              current_ByteOffset += base_ByteOffset;
-            }
-          } else { // we have to read in based on how it was written
-            int init_chunk_number = nprocs_file/nprocs;
-            int num_extra_chunks = nprocs_file - (nprocs*init_chunk_number);
-
-            for (int i = 0; i < nprocs; i++) {
-              if (i < num_extra_chunks)
-                nproc_chunk_number[i] = init_chunk_number+1;
-              else
-                nproc_chunk_number[i] = init_chunk_number;
-            }
-
-            int all_written_send_sizes_index = 0;
-            bigint current_offset = 0;
-            for (int i=0;i<nprocs;i++) {
-              nproc_chunk_offsets[i] = current_offset;
-              nproc_chunk_sizes[i] = 0;
-              for (int j=0;j<nproc_chunk_number[i];j++) {
-                nproc_chunk_sizes[i] +=
-                  all_written_send_sizes[all_written_send_sizes_index];
-                current_offset +=
-                  (all_written_send_sizes[all_written_send_sizes_index] *
-                   sizeof(double));
-                all_written_send_sizes_index++;
-              }
-
-            }
+                         "read_restart:all_written_send_sizes");
+          utils::sfread(FLERR,all_written_send_sizes,sizeof(int),nprocs_file,
+                        fp,nullptr,error);
+
+          mpiio_total = 0;
+          for (int i = 0; i < nprocs_file; i++)
+            mpiio_total += all_written_send_sizes[i];
+
+          int ichunk = 0;
+          bigint offset = 0;
+          for (int iproc = 0; iproc < nprocs; iproc++) {
+            bigint lo = mpiio_total*iproc/nprocs;
+            bigint hi = mpiio_total*(iproc+1)/nprocs;
+            while (ichunk < nprocs_file && offset < lo)
+              offset += all_written_send_sizes[ichunk++];
+            if (offset < hi) proc_chunk_start[iproc] = offset;
+            else proc_chunk_start[iproc] = -1;
           }
           memory->destroy(all_written_send_sizes);
-          memory->destroy(nproc_chunk_number);
         }
 
-        // scatter chunk sizes and offsets to all procs
-
-        MPI_Scatter(nproc_chunk_sizes, 1, MPI_LMP_BIGINT,
-                    &assignedChunkSize , 1, MPI_LMP_BIGINT, 0,world);
-        MPI_Scatter(nproc_chunk_offsets, 1, MPI_LMP_BIGINT,
-                    &assignedChunkOffset , 1, MPI_LMP_BIGINT, 0,world);
-
-        memory->destroy(nproc_chunk_sizes);
-        memory->destroy(nproc_chunk_offsets);
+        MPI_Bcast(&mpiio_total,1,MPI_LMP_BIGINT,0,world);
+        MPI_Scatter(proc_chunk_start,1,MPI_LMP_BIGINT,
+                    &chunk_start,1,MPI_LMP_BIGINT,0,world);
+        memory->destroy(proc_chunk_start);
       }
     }
 
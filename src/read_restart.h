@@ -43,8 +43,9 @@ class ReadRestart : public Command {
 
   int mpiioflag;               // 1 for MPIIO output, else 0
   class RestartMPIIO *mpiio;   // MPIIO for restart file input
-  bigint assignedChunkSize;
-  MPI_Offset assignedChunkOffset,headerOffset;
+  bigint mpiio_total;          // # of per-atom doubles in file
+  bigint chunk_start;          // offset of 1st written chunk in my range
+  MPI_Offset headerOffset;
 
   void file_search(char *, char *);
   void header();
@@ -56,6 +57,8 @@ class ReadRestart : public Command {
   void format_revision();
   void check_eof_magic();
   void file_layout();
+  void read_mpiio(const char *);
+  bigint end_of_records(double *, bigint, bigint, bigint);
 
   int read_int();
   bigint read_bigint();
@@ -96,6 +99,11 @@ E: Cannot open restart file %s
 
 Self-explanatory.
 
+E: Invalid atom record in restart file
+
+A per-atom record of an MPI-IO restart file has a non-positive size.
+The file is corrupted.
+
 E: Invalid flag in peratom section of restart file
 
 The format of this section of the file is not correct.
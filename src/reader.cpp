@@ -15,20 +15,56 @@
 
 #include "error.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#if defined(LAMMPS_ZLIB)
+#include <zlib.h>
+#endif
+
+#if defined(LAMMPS_ZSTD)
+#include <zstd.h>
+#endif
+
 using namespace LAMMPS_NS;
 
 // only proc 0 calls methods of this class, except for constructor/destructor
 
+enum{GZ,ZSTD};
+
+#define CHUNK 262144          // bytes read from compressed file at a time
+#define MAXDECOMPRESS 8       // max # of threads for parallel gzip members
+
 /* ---------------------------------------------------------------------- */
 
 Reader::Reader(LAMMPS *lmp) : Pointers(lmp)
 {
   fp = nullptr;
+  compressed = 0;
+  decompress_thread = nullptr;
+  decompress_stop = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+Reader::~Reader()
+{
+  // no error can be raised here
+
+  close_decompress(0);
 }
 
 /* ----------------------------------------------------------------------
    try to open given file
    generic version for ASCII files that may be compressed
+   compressed files are decompressed in-process if the compression
+     libraries are available, else via a pipe from an external program
 ------------------------------------------------------------------------- */
 
 void Reader::open_file(const char *file)
@@ -36,9 +72,11 @@ void Reader::open_file(const char *file)
   if (fp != nullptr) close_file();
 
   if (utils::strmatch(file,"\\.gz$")) {
-    compressed = 1;
 
-#ifdef LAMMPS_GZIP
+#if defined(LAMMPS_ZLIB) && !defined(_WIN32)
+    open_decompress(file,GZ);
+#elif defined(LAMMPS_GZIP)
+    compressed = 1;
     auto gunzip = fmt::format("gzip -c -d {}",file);
 
 #ifdef _WIN32
@@ -50,6 +88,25 @@ void Reader::open_file(const char *file)
 #else
     error->one(FLERR,"Cannot open gzipped file without gzip support");
 #endif
+
+  } else if (utils::strmatch(file,"\\.zst$")) {
+
+#if defined(LAMMPS_ZSTD) && !defined(_WIN32)
+    open_decompress(file,ZSTD);
+#elif defined(LAMMPS_GZIP)
+    compressed = 1;
+    auto unzstd = fmt::format("zstd -c -d {}",file);
+
+#ifdef _WIN32
+    fp = _popen(unzstd.c_str(),"rb");
+#else
+    fp = popen(unzstd.c_str(),"r");
+#endif
+
+#else
+    error->one(FLERR,"Cannot open zstd compressed file without zstd support");
+#endif
+
   } else {
     compressed = 0;
     fp = fopen(file,"r");
@@ -68,7 +125,8 @@ void Reader::open_file(const char *file)
 void Reader::close_file()
 {
   if (fp == nullptr) return;
-  if (compressed) pclose(fp);
+  if (compressed == 2) close_decompress(1);
+  else if (compressed) pclose(fp);
   else fclose(fp);
   fp = nullptr;
 }
@@ -82,3 +140,275 @@ void Reader::settings(int narg, char** /*args*/)
   if (narg > 0)
     error->all(FLERR,"Illegal read_dump command");
 }
+
+/* ----------------------------------------------------------------------
+   in-process decompression
+   a background thread reads and decompresses the file and writes the
+     data into a pipe, fp is the read end of the pipe
+   so the parsing of the derived readers is unchanged and overlaps
+     with the decompression
+------------------------------------------------------------------------- */
+
+#if !defined(_WIN32) && (defined(LAMMPS_ZLIB) || defined(LAMMPS_ZSTD))
+
+namespace {
+
+  // write all data to the pipe, return false on error or early stop
+
+  bool write_pipe(int fd, const char *buf, size_t n, std::atomic<int> &stop)
+  {
+    while (n > 0) {
+      if (stop) return false;
+      ssize_t m = write(fd,buf,n);
+      if (m < 0) {
+        if (errno == EINTR) continue;
+        return false;
+      }
+      buf += m;
+      n -= m;
+    }
+    return true;
+  }
+
+#if defined(LAMMPS_ZLIB)
+
+  // return size of a gzip member written by GzFileWriter in block mode,
+  //   from the "LM" subfield of its header, else 0
+
+  size_t gz_member_size(const unsigned char *h)
+  {
+    if (h[0] != 0x1f || h[1] != 0x8b || h[2] != Z_DEFLATED) return 0;
+    if (!(h[3] & 0x04) || h[10] + 256*h[11] < 8) return 0;
+    if (h[12] != 'L' || h[13] != 'M' || h[14] != 4 || h[15] != 0) return 0;
+    return (size_t) h[16] | ((size_t) h[17] << 8) |
+      ((size_t) h[18] << 16) | ((size_t) h[19] << 24);
+  }
+
+  // inflate one complete gzip member into out, return false on error
+
+  bool gz_inflate_member(const std::string &in, std::string &out)
+  {
+    size_t n = in.size();
+    size_t isize = (size_t) (unsigned char) in[n-4] |
+      ((size_t) (unsigned char) in[n-3] << 8) |
+      ((size_t) (unsigned char) in[n-2] << 16) |
+      ((size_t) (unsigned char) in[n-1] << 24);
+    out.resize(isize);
+
+    z_stream strm;
+    memset(&strm,0,sizeof(strm));
+    if (inflateInit2(&strm,16+MAX_WBITS) != Z_OK) return false;
+    strm.next_in = (Bytef *) in.data();
+    strm.avail_in = n;
+    strm.next_out = (Bytef *) &out[0];
+    strm.avail_out = isize;
+    int rv = inflate(&strm,Z_FINISH);
+    bool ok = (rv == Z_STREAM_END) && (strm.total_out == isize);
+    inflateEnd(&strm);
+    return ok;
+  }
+
+  // inflate a gzip stream of any # of members from the current position
+
+  std::string gz_inflate_stream(FILE *in, int fd, std::atomic<int> &stop)
+  {
+    std::vector<char> inbuf(CHUNK), outbuf(CHUNK);
+    z_stream strm;
+    memset(&strm,0,sizeof(strm));
+    if (inflateInit2(&strm,16+MAX_WBITS) != Z_OK)
+      return "Could not initialize zlib";
+
+    std::string mesg;
+    int rv = Z_OK;
+    while (mesg.empty()) {
+      if (strm.avail_in == 0) {
+        strm.avail_in = fread(inbuf.data(),1,CHUNK,in);
+        strm.next_in = (Bytef *) inbuf.data();
+        if (strm.avail_in == 0) {
+          if (rv != Z_STREAM_END) mesg = "Unexpected end of gzip data";
+          break;
+        }
+      }
+
+      // a new member follows the end of the previous one
+
+      if (rv == Z_STREAM_END) inflateReset(&strm);
+
+      strm.next_out = (Bytef *) outbuf.data();
+      strm.avail_out = CHUNK;
+      rv = inflate(&strm,Z_NO_FLUSH);
+      if (rv != Z_OK && rv != Z_STREAM_END && rv != Z_BUF_ERROR)
+        mesg = strm.msg ? strm.msg : "Invalid gzip data";
+      else if (!write_pipe(fd,outbuf.data(),CHUNK-strm.avail_out,stop)) break;
+    }
+    inflateEnd(&strm);
+    return mesg;
+  }
+
+  // inflate gzip data, members written in block mode by GzFileWriter
+  //   are inflated concurrently by nthreads threads
+  // fall back to streaming at the first member without "LM" subfield
+
+  std::string gz_inflate(FILE *in, int fd, std::atomic<int> &stop, int nthreads)
+  {
+    unsigned char header[20];
+    std::vector<std::string> members(nthreads), outbuf(nthreads);
+
+    while (!stop) {
+      int nmember = 0;
+      while (nmember < nthreads) {
+        long pos = ftell(in);
+        size_t nheader = fread(header,1,20,in);
+        if (nheader == 0) break;
+        size_t size = (nheader == 20) ? gz_member_size(header) : 0;
+        if (size <= 20) {
+          fseek(in,pos,SEEK_SET);
+          break;
+        }
+        std::string &member = members[nmember++];
+        member.assign((char *) header,20);
+        member.resize(size);
+        if (fread(&member[20],1,size-20,in) != size-20)
+          return "Unexpected end of gzip data";
+      }
+
+      if (nmember == 0) {
+        if (feof(in) || stop) return "";
+        return gz_inflate_stream(in,fd,stop);
+      }
+
+      std::vector<int> ok(nmember);
+      auto inflate_range = [&](int first) {
+        for (int i = first; i < nmember; i += nthreads)
+          ok[i] = gz_inflate_member(members[i],outbuf[i]);
+      };
+      std::vector<std::thread> workers;
+      for (int i = 1; i < std::min(nthreads,nmember); i++)
+        workers.emplace_back(inflate_range,i);
+      inflate_range(0);
+      for (auto &w : workers) w.join();
+
+      for (int i = 0; i < nmember; i++) {
+        if (!ok[i]) return "Invalid gzip member";
+        if (!write_pipe(fd,outbuf[i].data(),outbuf[i].size(),stop)) return "";
+      }
+    }
+    return "";
+  }
+
+#endif
+
+#if defined(LAMMPS_ZSTD)
+
+  // decompress a zstd stream of any # of frames, skippable frames
+  //   like the seek table are ignored by the library
+
+  std::string zstd_decompress(FILE *in, int fd, std::atomic<int> &stop)
+  {
+    size_t ninbuf = ZSTD_DStreamInSize();
+    size_t noutbuf = ZSTD_DStreamOutSize();
+    std::vector<char> inbuf(ninbuf), outbuf(noutbuf);
+
+    ZSTD_DCtx *dctx = ZSTD_createDCtx();
+    if (!dctx) return "Could not create Zstd context";
+
+    std::string mesg;
+    size_t rv = 0;
+    size_t nread;
+    while (mesg.empty() && (nread = fread(inbuf.data(),1,ninbuf,in)) > 0) {
+      ZSTD_inBuffer input = { inbuf.data(), nread, 0 };
+      while (input.pos < input.size) {
+        ZSTD_outBuffer output = { outbuf.data(), noutbuf, 0 };
+        rv = ZSTD_decompressStream(dctx,&output,&input);
+        if (ZSTD_isError(rv)) {
+          mesg = ZSTD_getErrorName(rv);
+          break;
+        }
+        if (!write_pipe(fd,outbuf.data(),output.pos,stop)) {
+          ZSTD_freeDCtx(dctx);
+          return "";
+        }
+      }
+    }
+    if (mesg.empty() && rv != 0) mesg = "Unexpected end of zstd data";
+    ZSTD_freeDCtx(dctx);
+    return mesg;
+  }
+
+#endif
+}
+
+#endif
+
+/* ----------------------------------------------------------------------
+   open compressed file for in-process decompression
+------------------------------------------------------------------------- */
+
+void Reader::open_decompress(const char *file, int style)
+{
+#if !defined(_WIN32) && (defined(LAMMPS_ZLIB) || defined(LAMMPS_ZSTD))
+  compressed = 2;
+
+  FILE *in = fopen(file,"rb");
+  if (in == nullptr) return;
+
+  int fds[2];
+  if (pipe(fds) != 0) {
+    fclose(in);
+    error->one(FLERR,"Cannot open compressed file {}: {}",
+               file,utils::getsyserror());
+  }
+  fp = fdopen(fds[0],"r");
+
+  // proc 0 reads while other procs wait, so it can use a few threads
+
+  int nthreads = std::thread::hardware_concurrency();
+  nthreads = MAX(1,MIN(nthreads,MAXDECOMPRESS));
+
+  decompress_stop = 0;
+  decompress_error.clear();
+  int fd = fds[1];
+  decompress_thread = new std::thread([this,in,fd,style,nthreads]() {
+    std::string mesg;
+#if defined(LAMMPS_ZLIB)
+    if (style == GZ) mesg = gz_inflate(in,fd,decompress_stop,nthreads);
+#endif
+#if defined(LAMMPS_ZSTD)
+    if (style == ZSTD) mesg = zstd_decompress(in,fd,decompress_stop);
+#endif
+    decompress_error = mesg;
+    fclose(in);
+    close(fd);
+  });
+#else
+  (void) file;
+  (void) style;
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   close pipe of in-process decompression
+   a thread that has not reached the end of the file is told to stop
+     and the pipe is drained so it cannot block in write()
+   errflag = 1 to report an error of the thread
+------------------------------------------------------------------------- */
+
+void Reader::close_decompress(int errflag)
+{
+  if (decompress_thread == nullptr) return;
+
+  decompress_stop = 1;
+  if (fp) {
+    char buf[BUFSIZ];
+    while (fread(buf,1,BUFSIZ,fp) > 0) continue;
+    fclose(fp);
+    fp = nullptr;
+  }
+  decompress_thread->join();
+  delete decompress_thread;
+  decompress_thread = nullptr;
+
+  if (errflag && !decompress_error.empty())
+    error->one(FLERR,"Error while decompressing file: {}",decompress_error);
+  decompress_error.clear();
+}
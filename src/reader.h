@@ -18,12 +18,16 @@
 
 #include "pointers.h"
 
+#include <atomic>
+#include <string>
+#include <thread>
+
 namespace LAMMPS_NS {
 
 class Reader : protected Pointers {
  public:
   Reader(class LAMMPS *);
-  virtual ~Reader() {}
+  virtual ~Reader();
 
   virtual void settings(int, char**);
 
@@ -39,6 +43,15 @@ class Reader : protected Pointers {
  protected:
   FILE *fp;                // pointer to opened file or pipe
   int compressed;          // flag for dump file compression
+                           // 0 = none, 1 = external program, 2 = in-process
+
+ private:
+  std::thread *decompress_thread;   // thread decompressing into a pipe
+  std::atomic<int> decompress_stop; // 1 if thread should stop early
+  std::string decompress_error;     // error message from the thread
+
+  void open_decompress(const char *, int);
+  void close_decompress(int);
 };
 
 }
@@ -52,6 +65,20 @@ E: Cannot open gzipped file
 LAMMPS was compiled without support for reading and writing gzipped
 files through a pipeline to the gzip program with -DLAMMPS_GZIP.
 
+E: Cannot open compressed file %s: %s
+
+The pipe or the background thread for in-process decompression of the
+file could not be created.
+
+E: Error while decompressing file: %s
+
+The compressed file is corrupt or truncated.
+
+E: Cannot open zstd compressed file without zstd support
+
+LAMMPS was compiled without the Zstd library and without -DLAMMPS_GZIP
+support for reading through a pipeline to the zstd program.
+
 E: Cannot open file %s
 
 The specified file cannot be opened.  Check that the path and name are
@@ -173,6 +173,23 @@ bigint ReaderNative::read_header(double box[3][3], int &boxinfo, int &triclinic,
     return 1;
   }
 
+  fieldflag = match_fields(labels,nfield,fieldtype,fieldlabel,
+                           scaleflag,wrapflag,xflag,yflag,zflag);
+
+  return natoms;
+}
+
+/* ----------------------------------------------------------------------
+   match Nfield fields to column labels of per-atom data in dump file
+   allocate and set fieldindex = which column each field maps to
+   set xyz flags, return fieldflag
+------------------------------------------------------------------------- */
+
+int ReaderNative::match_fields(const std::map<std::string, int> &labels,
+                               int nfield, int *fieldtype, char **fieldlabel,
+                               int scaleflag, int wrapflag,
+                               int &xflag, int &yflag, int &zflag)
+{
   // match each field with a column of per-atom data
   // if fieldlabel set, match with explicit column
   // else infer one or more column matches from fieldtype
@@ -292,13 +309,12 @@ bigint ReaderNative::read_header(double box[3][3], int &boxinfo, int &triclinic,
       fieldindex[i] = find_label("iz", labels);
   }
 
-  // set fieldflag = -1 if any unfound fields
+  // return -1 if any unfound fields
 
-  fieldflag = 0;
+  int fieldflag = 0;
   for (int i = 0; i < nfield; i++)
     if (fieldindex[i] < 0) fieldflag = -1;
-
-  return natoms;
+  return fieldflag;
 }
 
 /* ----------------------------------------------------------------------
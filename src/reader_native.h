@@ -39,13 +39,15 @@ class ReaderNative : public Reader {
                      int, int, int &, int &, int &, int &);
   void read_atoms(int, int, double **);
 
-private:
+protected:
   char *line;              // line read from dump file
 
   int nwords;              // # of per-atom columns in dump file
-  int *fieldindex;         //
+  int *fieldindex;         // column of per-atom data for each field
 
   int find_label(const std::string &label, const std::map<std::string, int> & labels);
+  int match_fields(const std::map<std::string, int> &, int, int *, char **,
+                   int, int, int &, int &, int &);
   void read_lines(int);
 };
 
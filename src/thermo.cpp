@@ -47,6 +47,7 @@
 
 #include <cmath>
 #include <cstring>
+#include <vector>
 
 using namespace LAMMPS_NS;
 using namespace MathConst;
@@ -333,24 +334,24 @@ void Thermo::compute(int flag)
   else normflag = normvalue;
 
   // invoke Compute methods needed for thermo keywords
+  // first sum per-proc values of all computes that allow it at once
 
+  std::vector<int> flags(ncompute);
   for (i = 0; i < ncompute; i++)
-    if (compute_which[i] == SCALAR) {
-      if (!(computes[i]->invoked_flag & Compute::INVOKED_SCALAR)) {
-        computes[i]->compute_scalar();
-        computes[i]->invoked_flag |= Compute::INVOKED_SCALAR;
-      }
-    } else if (compute_which[i] == VECTOR) {
-      if (!(computes[i]->invoked_flag & Compute::INVOKED_VECTOR)) {
-        computes[i]->compute_vector();
-        computes[i]->invoked_flag |= Compute::INVOKED_VECTOR;
-      }
-    } else if (compute_which[i] == ARRAY) {
-      if (!(computes[i]->invoked_flag & Compute::INVOKED_ARRAY)) {
-        computes[i]->compute_array();
-        computes[i]->invoked_flag |= Compute::INVOKED_ARRAY;
-      }
-    }
+    if (compute_which[i] == SCALAR) flags[i] = Compute::INVOKED_SCALAR;
+    else if (compute_which[i] == VECTOR) flags[i] = Compute::INVOKED_VECTOR;
+    else flags[i] = Compute::INVOKED_ARRAY;
+  modify->invoke_partial(ncompute,computes,flags.data());
+
+  for (i = 0; i < ncompute; i++) {
+    if (computes[i]->invoked_flag & flags[i]) continue;
+    timer->detail_start(computes[i]->timer_detail);
+    if (compute_which[i] == SCALAR) computes[i]->compute_scalar();
+    else if (compute_which[i] == VECTOR) computes[i]->compute_vector();
+    else if (compute_which[i] == ARRAY) computes[i]->compute_array();
+    computes[i]->invoked_flag |= flags[i];
+    timer->detail_stop(computes[i]->timer_detail);
+  }
 
   // if lineflag = MULTILINE, prepend step/cpu header line
 
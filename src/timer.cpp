@@ -17,6 +17,7 @@
 #include "error.h"
 #include "fmt/chrono.h"
 
+#include <cmath>
 #include <cstring>
 
 #ifdef _WIN32
@@ -27,6 +28,13 @@
 #include <sys/resource.h>
 #endif
 
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 using namespace LAMMPS_NS;
 
 
@@ -70,17 +78,39 @@ Timer::Timer(LAMMPS *lmp) : Pointers(lmp)
   _s_timeout = -1;
   _checkfreq = 10;
   _nextcheck = -1;
+  _detail = 0;
+  _counters = 0;
+  _trace = 0;
+  trace_max = 100000;
+  ntrace = 0;
+  trace_start = 0.0;
+  for (int i = 0; i < NUM_COUNTER; i++) counter_fd[i] = -1;
   this->_stamp(RESET);
 }
 
 /* ---------------------------------------------------------------------- */
 
+Timer::~Timer()
+{
+  close_counters();
+}
+
+/* ---------------------------------------------------------------------- */
+
 void Timer::init()
 {
   for (int i = 0; i < NUM_TIMER; i++) {
     cpu_array[i] = 0.0;
     wall_array[i] = 0.0;
   }
+
+  ntrace = 0;
+
+  for (auto &d : details) {
+    d.calls = 0;
+    d.wall = 0.0;
+    for (int i = 0; i < NUM_COUNTER; i++) d.count[i] = 0.0;
+  }
 }
 
 /* ---------------------------------------------------------------------- */
@@ -100,6 +130,7 @@ void Timer::_stamp(enum ttype which)
     wall_array[which] += delta_wall;
     cpu_array[ALL]    += delta_cpu;
     wall_array[ALL]   += delta_wall;
+    if (_trace) trace_event(which,previous_wall,current_wall);
   }
 
   previous_cpu  = current_cpu;
@@ -118,6 +149,7 @@ void Timer::_stamp(enum ttype which)
 
     cpu_array[SYNC]  += current_cpu - previous_cpu;
     wall_array[SYNC] += current_wall - previous_wall;
+    if (_trace) trace_event(SYNC,previous_wall,current_wall);
     previous_cpu  = current_cpu;
     previous_wall = current_wall;
   }
@@ -130,6 +162,7 @@ void Timer::barrier_start()
   double current_cpu=0.0, current_wall=0.0;
 
   MPI_Barrier(world);
+  trace_start = MPI_Wtime();
 
   if (_level < LOOP) return;
 
@@ -243,11 +276,299 @@ double Timer::get_timeout_remain()
   return (_timeout < 0.0) ? 0.0 : _timeout + timeout_start - MPI_Wtime();
 }
 
+/* ----------------------------------------------------------------------
+   return id of detailed timer NAME, create it if needed
+   called during init() of fixes, computes, dumps, and styles
+   all MPI ranks must create the same timers in the same order
+   return -1 if detailed timing is off
+------------------------------------------------------------------------- */
+
+int Timer::detail_id(const std::string &name)
+{
+  if (!_detail && !_trace) return -1;
+
+  const int n = details.size();
+  for (int i = 0; i < n; i++)
+    if (details[i].name == name) return i;
+
+  Detail d;
+  d.name = name;
+  d.calls = 0;
+  d.wall = d.wall_start = 0.0;
+  for (int i = 0; i < NUM_COUNTER; i++) d.count[i] = d.count_start[i] = 0.0;
+  details.push_back(d);
+  return n;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Timer::_detail_start(int id)
+{
+  if (id >= (int) details.size()) return;
+  Detail &d = details[id];
+  if (_counters) read_counters(d.count_start);
+  d.wall_start = MPI_Wtime();
+}
+
+/* ----------------------------------------------------------------------
+   NCALL = 0 if call continues in a later start/stop pair
+------------------------------------------------------------------------- */
+
+void Timer::_detail_stop(int id, int ncall)
+{
+  if (id >= (int) details.size()) return;
+  Detail &d = details[id];
+  const double now = MPI_Wtime();
+  d.wall += now - d.wall_start;
+  d.calls += ncall;
+  if (_trace) trace_event(NUM_TIMER+id,d.wall_start,now);
+  if (_counters) {
+    double count[NUM_COUNTER];
+    read_counters(count);
+    for (int i = 0; i < NUM_COUNTER; i++)
+      d.count[i] += count[i] - d.count_start[i];
+  }
+}
+
+/* ----------------------------------------------------------------------
+   open hardware counters of this process with the Linux perf_event API
+   one group of counters, so they are read with a single system call
+   turn counters off on all procs if any proc cannot open them
+------------------------------------------------------------------------- */
+
+void Timer::open_counters()
+{
+  if (counter_fd[0] >= 0) return;
+
+  std::string mesg;
+
+#if defined(__linux__)
+  static const uint64_t config[NUM_COUNTER] =
+    {PERF_COUNT_HW_CPU_CYCLES,PERF_COUNT_HW_INSTRUCTIONS,
+     PERF_COUNT_HW_CACHE_MISSES};
+
+  for (int i = 0; i < NUM_COUNTER; i++) {
+    struct perf_event_attr attr;
+    memset(&attr,0,sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config[i];
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    counter_fd[i] = syscall(__NR_perf_event_open,&attr,0,-1,
+                            (i == 0) ? -1 : counter_fd[0],0);
+    if (counter_fd[i] < 0) {
+      mesg = strerror(errno);
+      break;
+    }
+  }
+#else
+  mesg = "not supported on this platform";
+#endif
+
+  int flag = mesg.empty() ? 1 : 0;
+  int flagall;
+  MPI_Allreduce(&flag,&flagall,1,MPI_INT,MPI_MIN,world);
+  if (flagall) return;
+
+  close_counters();
+  _counters = 0;
+  if (mesg.empty()) mesg = "failed on some MPI ranks";
+  if (comm->me == 0)
+    error->warning(FLERR,"Hardware counters are not available: {}",mesg);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Timer::close_counters()
+{
+  for (int i = NUM_COUNTER-1; i >= 0; i--) {
+#if defined(__linux__)
+    if (counter_fd[i] >= 0) ::close(counter_fd[i]);
+#endif
+    counter_fd[i] = -1;
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
+void Timer::read_counters(double *count)
+{
+#if defined(__linux__)
+  uint64_t buf[1+NUM_COUNTER];
+  if (read(counter_fd[0],buf,sizeof(buf)) == sizeof(buf)) {
+    for (int i = 0; i < NUM_COUNTER; i++) count[i] = buf[1+i];
+    return;
+  }
+#endif
+  for (int i = 0; i < NUM_COUNTER; i++) count[i] = 0.0;
+}
+
+/* ----------------------------------------------------------------------
+   min/avg/max of detailed timers across procs, one line per timer
+   TIME_LOOP = total loop time for percentages
+   called by all procs, returned text is only set on proc 0
+------------------------------------------------------------------------- */
+
+std::string Timer::detail_summary(double time_loop)
+{
+  int n = details.size();
+  int nmin,nmax;
+  MPI_Allreduce(&n,&nmin,1,MPI_INT,MPI_MIN,world);
+  MPI_Allreduce(&n,&nmax,1,MPI_INT,MPI_MAX,world);
+  if (nmin != nmax) {
+    if (comm->me == 0)
+      error->warning(FLERR,"Detailed timers differ between MPI ranks");
+    return "";
+  }
+  if (n == 0) return "";
+
+  // per timer: wall time, its square, # of calls, counters
+
+  const int nvalue = 3 + NUM_COUNTER;
+  std::vector<double> one(n*nvalue),all(n*nvalue);
+  std::vector<double> wall(n),wall_min(n),wall_max(n);
+
+  for (int i = 0; i < n; i++) {
+    const Detail &d = details[i];
+    wall[i] = d.wall;
+    one[i*nvalue] = d.wall;
+    one[i*nvalue+1] = d.wall*d.wall;
+    one[i*nvalue+2] = d.calls;
+    for (int k = 0; k < NUM_COUNTER; k++) one[i*nvalue+3+k] = d.count[k];
+  }
+
+  MPI_Allreduce(one.data(),all.data(),n*nvalue,MPI_DOUBLE,MPI_SUM,world);
+  MPI_Allreduce(wall.data(),wall_min.data(),n,MPI_DOUBLE,MPI_MIN,world);
+  MPI_Allreduce(wall.data(),wall_max.data(),n,MPI_DOUBLE,MPI_MAX,world);
+
+  if (comm->me) return "";
+
+  const double nprocs = comm->nprocs;
+  std::size_t width = 8;
+  for (int i = 0; i < n; i++)
+    if (all[i*nvalue+2] > 0.0) width = MAX(width,details[i].name.size()+1);
+
+  std::string header = fmt::format("{:<{}}|  min time  |  avg time  |  max time"
+                                   "  |%varavg| %total |   calls  ","Section",
+                                   width);
+  if (_counters) header += "| Mcycles  |  Minstr  | Mmisses  ";
+  std::string mesg = "\nDetailed timing breakdown:\n" + header + "\n" +
+    std::string(header.size(),'-') + "\n";
+
+  for (int i = 0; i < n; i++) {
+    const double *v = &all[i*nvalue];
+    if (v[2] == 0.0) continue;
+
+    double time = v[0]/nprocs;
+    double time_sq = v[1]/nprocs;
+    if ((time > 0.001) && ((time_sq/time - time) > 1.0e-10))
+      time_sq = sqrt(time_sq/time - time)*100.0;
+    else time_sq = 0.0;
+    double pct = (time_loop > 0.0) ? time/time_loop*100.0 : 0.0;
+
+    mesg += fmt::format("{:<{}}| {:<10.5g} | {:<10.5g} | {:<10.5g} |{:6.1f} |"
+                        "{:6.2f} | {:<8.6g} ",details[i].name,width,
+                        wall_min[i],time,wall_max[i],time_sq,pct,v[2]/nprocs);
+    if (_counters)
+      mesg += fmt::format("| {:<8.6g} | {:<8.6g} | {:<8.6g} ",
+                          v[3]/nprocs*1.0e-6,v[4]/nprocs*1.0e-6,
+                          v[5]/nprocs*1.0e-6);
+    mesg += "\n";
+  }
+  return mesg;
+}
+
+/* ----------------------------------------------------------------------
+   write recorded events of all procs to trace file in Chrome trace format
+   each proc is a process of the trace, times are relative to start of run
+   procs send their events to proc 0 one at a time
+------------------------------------------------------------------------- */
+
+static const char *section_name[] =
+  {"Total","Pair","Bond","Kspace","Neigh","Comm","Modify","Output","Sync",
+   "All","Dephase","Dynamics","Quench","NEB","Repcomm","Repout"};
+
+void Timer::write_trace()
+{
+  const int me = comm->me;
+  const int nprocs = comm->nprocs;
+
+  // pack my events oldest first, as 3 doubles each
+
+  const int n = MIN(ntrace,(bigint) trace_max);
+  std::vector<double> buf(3*n);
+  bigint first = ntrace - n;
+  for (int i = 0; i < n; i++) {
+    const TraceEvent &e = trace[(first+i) % trace_max];
+    buf[3*i] = e.which;
+    buf[3*i+1] = (e.start - trace_start) * 1.0e6;
+    buf[3*i+2] = (e.stop - e.start) * 1.0e6;
+  }
+
+  bigint ndrop = ntrace - n;
+  bigint ndropall;
+  MPI_Allreduce(&ndrop,&ndropall,1,MPI_LMP_BIGINT,MPI_MAX,world);
+  if (ndropall && me == 0)
+    error->warning(FLERR,"Trace buffer overflow, only the last {} events "
+                   "of each MPI rank are written",trace_max);
+
+  if (me) {
+    int tmp;
+    MPI_Recv(&tmp,0,MPI_INT,0,0,world,MPI_STATUS_IGNORE);
+    MPI_Send(&n,1,MPI_INT,0,0,world);
+    MPI_Send(buf.data(),3*n,MPI_DOUBLE,0,0,world);
+    return;
+  }
+
+  FILE *fp = fopen(trace_file.c_str(),"w");
+  int flag = fp ? 0 : 1;
+  std::string mesg = fp ? "" : utils::getsyserror();
+
+  for (int iproc = 0; iproc < nprocs; iproc++) {
+    int nrecv = n;
+    if (iproc) {
+      int tmp = 0;
+      MPI_Send(&tmp,0,MPI_INT,iproc,0,world);
+      MPI_Recv(&nrecv,1,MPI_INT,iproc,0,world,MPI_STATUS_IGNORE);
+      buf.resize(3*nrecv);
+      MPI_Recv(buf.data(),3*nrecv,MPI_DOUBLE,iproc,0,world,MPI_STATUS_IGNORE);
+    }
+    if (flag) continue;
+
+    if (iproc == 0) fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n",fp);
+    else fputs(",\n",fp);
+    fmt::print(fp,"{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":{},"
+               "\"args\":{{\"name\":\"MPI rank {}\"}}}}",iproc,iproc);
+
+    for (int i = 0; i < nrecv; i++) {
+      const int which = static_cast<int> (buf[3*i]);
+      const char *name,*cat;
+      if (which < NUM_TIMER) {
+        name = section_name[which];
+        cat = "section";
+      } else {
+        name = details[which-NUM_TIMER].name.c_str();
+        cat = "detail";
+      }
+      fmt::print(fp,",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\","
+                 "\"pid\":{},\"tid\":0,\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                 name,cat,iproc,buf[3*i+1],buf[3*i+2]);
+    }
+  }
+
+  if (flag) error->one(FLERR,"Cannot open trace file {}: {}",trace_file,mesg);
+  fputs("\n]}\n",fp);
+  fclose(fp);
+}
+
 /* ----------------------------------------------------------------------
    modify parameters of the Timer class
 ------------------------------------------------------------------------- */
 static const char *timer_style[] = { "off", "loop", "normal", "full" };
 static const char *timer_mode[]  = { "nosync", "(dummy)", "sync" };
+static const char *timer_detail[] = { "off", "on", "counters" };
 
 void Timer::modify_params(int narg, char **arg)
 {
@@ -265,6 +586,30 @@ void Timer::modify_params(int narg, char **arg)
       _sync  = OFF;
     } else if (strcmp(arg[iarg],timer_mode[NORMAL])  == 0) {
       _sync  = NORMAL;
+    } else if (strcmp(arg[iarg],"detail") == 0) {
+      _detail = 1;
+      _counters = 0;
+    } else if (strcmp(arg[iarg],"counters") == 0) {
+      _detail = 1;
+      _counters = 1;
+    } else if (strcmp(arg[iarg],"nodetail") == 0) {
+      _detail = 0;
+      _counters = 0;
+    } else if (strcmp(arg[iarg],"trace") == 0) {
+      ++iarg;
+      if (iarg < narg) {
+        _trace = 1;
+        trace_file = arg[iarg];
+      } else error->all(FLERR,"Illegal timer command");
+    } else if (strcmp(arg[iarg],"notrace") == 0) {
+      _trace = 0;
+    } else if (strcmp(arg[iarg],"tracemax") == 0) {
+      ++iarg;
+      if (iarg < narg) {
+        trace_max = utils::inumeric(FLERR,arg[iarg],false,lmp);
+        if (trace_max <= 0)
+          error->all(FLERR,"Illegal timer command");
+      } else error->all(FLERR,"Illegal timer command");
     } else if (strcmp(arg[iarg],"timeout") == 0) {
       ++iarg;
       if (iarg < narg) {
@@ -281,6 +626,16 @@ void Timer::modify_params(int narg, char **arg)
     ++iarg;
   }
 
+  // new detailed timers are created by the next init()
+
+  details.clear();
+  if (_counters) open_counters();
+  else close_counters();
+
+  ntrace = 0;
+  if (_trace) trace.resize(trace_max);
+  else trace.clear();
+
   timeout_start = MPI_Wtime();
   if (comm->me == 0) {
 
@@ -291,7 +646,9 @@ void Timer::modify_params(int narg, char **arg)
       timeout = fmt::format("{:%H:%M:%S}", fmt::gmtime(tv));
     }
 
-    utils::logmesg(lmp,"New timer settings: style={}  mode={}  timeout={}\n",
-                   timer_style[_level],timer_mode[_sync],timeout);
+    utils::logmesg(lmp,"New timer settings: style={}  mode={}  timeout={}  "
+                   "detail={}  trace={}\n",timer_style[_level],
+                   timer_mode[_sync],timeout,timer_detail[_detail+_counters],
+                   _trace ? trace_file : std::string("off"));
   }
 }
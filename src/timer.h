@@ -16,6 +16,8 @@
 
 #include "pointers.h"
 
+#include <string>
+#include <vector>
 
 namespace LAMMPS_NS {
 
@@ -28,7 +30,7 @@ class Timer : protected Pointers {
   enum tlevel {OFF=0,LOOP,NORMAL,FULL};
 
   Timer(class LAMMPS *);
-  ~Timer() {};
+  ~Timer();
   void init();
 
   // inline function to reduce overhead if we want no detailed timings
@@ -85,6 +87,26 @@ class Timer : protected Pointers {
 
   void modify_params(int, char **);
 
+  // detailed timers of individual fixes, computes, dumps, and sub-styles
+  // id is returned by detail_id(), it is -1 if detailed timing is off
+
+  bool has_detail() const { return (_detail != 0); }
+  int detail_id(const std::string &);
+
+  void detail_start(int id) {
+    if (id >= 0) _detail_start(id);
+  }
+  void detail_stop(int id, int ncall=1) {
+    if (id >= 0) _detail_stop(id,ncall);
+  }
+
+  std::string detail_summary(double);
+
+  // timeline of sections and detailed timers of each proc during a run
+
+  bool has_trace() const { return (_trace != 0); }
+  void write_trace();
+
  private:
   double cpu_array[NUM_TIMER];
   double wall_array[NUM_TIMER];
@@ -97,6 +119,44 @@ class Timer : protected Pointers {
   int _s_timeout; // copy of timeout for restoring after a forced timeout
   int _checkfreq; // frequency of timeout checking
   int _nextcheck; // loop number of next timeout check
+  int _detail;    // if nonzero, collect detailed timers
+  int _counters;  // if nonzero, also collect hardware counters
+
+  enum {CYCLES=0,INSTRUCTIONS,CACHE_MISSES,NUM_COUNTER};
+
+  struct Detail {
+    std::string name;
+    bigint calls;
+    double wall,wall_start;
+    double count[NUM_COUNTER],count_start[NUM_COUNTER];
+  };
+  std::vector<Detail> details;
+  int counter_fd[NUM_COUNTER];  // hardware counter files, -1 if closed
+
+  struct TraceEvent {
+    int which;          // section, or NUM_TIMER + id of detailed timer
+    double start,stop;
+  };
+  int _trace;                      // if nonzero, record trace events
+  std::string trace_file;          // Chrome trace JSON file
+  std::vector<TraceEvent> trace;   // ring buffer of most recent events
+  int trace_max;                   // max # of events in ring buffer
+  bigint ntrace;                   // # of events recorded in current run
+  double trace_start;              // wall time at start of run
+
+  void trace_event(int which, double start, double stop) {
+    TraceEvent &e = trace[ntrace % trace_max];
+    e.which = which;
+    e.start = start;
+    e.stop = stop;
+    ntrace++;
+  }
+
+  void _detail_start(int);
+  void _detail_stop(int, int);
+  void open_counters();
+  void close_counters();
+  void read_counters(double *);
 
   // update one specific timer array
   void _stamp(enum ttype);
@@ -115,6 +175,26 @@ W: Wall time limit reached
 
 UNDOCUMENTED
 
+W: Hardware counters are not available: %s
+
+The perf_event interface of the Linux kernel could not be used to
+read hardware counters, e.g. because of the setting in
+/proc/sys/kernel/perf_event_paranoid.  Only times are collected.
+
+W: Trace buffer overflow, only the last %d events of each MPI rank are written
+
+Increase the size of the buffer with the tracemax keyword of the
+timer command to record the full run.
+
+E: Cannot open trace file %s: %s
+
+The file for the timeline trace could not be opened for writing.
+
+W: Detailed timers differ between MPI ranks
+
+The ranks did not define the same detailed timers, so they cannot
+be summarized.
+
 E: Illegal ... command
 
 Self-explanatory.  Check the input script syntax and compare to the
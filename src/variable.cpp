@@ -50,6 +50,7 @@ using namespace MathConst;
 #define CHUNK 1024
 #define VALUELENGTH 64               // also in python.cpp
 #define MAXFUNCARG 6
+#define VARBLOCK 256                 // # of atoms per block in eval_block()
 
 #define MYROUND(a) (( a-floor(a) ) >= .5) ? ceil(a) : floor(a)
 
@@ -110,6 +111,9 @@ Variable::Variable(LAMMPS *lmp) : Pointers(lmp)
   randomequal = nullptr;
   randomatom = nullptr;
 
+  vstack = nullptr;
+  maxstack = 0;
+
   // override initializer since LAMMPS class needs to be instantiated
 
   constants["version"] = lmp->num_ver;
@@ -154,6 +158,7 @@ Variable::~Variable()
   delete randomequal;
   delete randomatom;
 
+  memory->destroy(vstack);
 }
 
 /* ----------------------------------------------------------------------
@@ -944,6 +949,22 @@ char *Variable::retrieve(const char *name)
   return str;
 }
 
+/* ----------------------------------------------------------------------
+   return text whose references may invoke computes when ivar is evaluated
+   used by Modify::depend_init()
+   return 1 if this cannot be known, e.g. for python-style variables
+------------------------------------------------------------------------- */
+
+int Variable::depend_text(int ivar, std::string &text)
+{
+  text.clear();
+  if (style[ivar] == EQUAL || style[ivar] == ATOM || style[ivar] == VECTOR)
+    text = data[ivar][0];
+  else if (style[ivar] == FORMAT) text = std::string("v_") + data[ivar][0];
+  else if (style[ivar] == PYTHON) return 1;
+  return 0;
+}
+
 /* ----------------------------------------------------------------------
    return result of equal-style variable evaluation
    can be EQUAL or INTERNAL style or PYTHON numeric style
@@ -1022,19 +1043,32 @@ void Variable::compute_atom(int ivar, int igroup,
   int *mask = atom->mask;
   int nlocal = atom->nlocal;
 
+  // evaluate tree over blocks of atoms if it can be flattened
+  // use eval_tree() per atom for trees with other functions, e.g. random(),
+  //   and for blocks with an invalid operand, e.g. sqrt() of negative value,
+  //   so that errors and short-circuit AND/OR match per-atom evaluation
+
   if (style[ivar] == ATOM) {
-    if (sumflag == 0) {
-      int m = 0;
-      for (int i = 0; i < nlocal; i++) {
-        if (mask[i] & groupbit) result[m] = eval_tree(tree,i);
-        else result[m] = 0.0;
-        m += stride;
-      }
+    program.clear();
+    int depth = compile_tree(tree);
+    if (depth > maxstack) {
+      maxstack = depth;
+      memory->destroy(vstack);
+      memory->create(vstack,maxstack*VARBLOCK,"variable:vstack");
+    }
 
-    } else {
-      int m = 0;
-      for (int i = 0; i < nlocal; i++) {
-        if (mask[i] & groupbit) result[m] += eval_tree(tree,i);
+    double *values = nullptr;
+    int m = 0;
+    for (int ifirst = 0; ifirst < nlocal; ifirst += VARBLOCK) {
+      int n = MIN(VARBLOCK,nlocal-ifirst);
+      int pertree = (depth < 0) ? 1 : eval_block(ifirst,n,values);
+      for (int k = 0; k < n; k++) {
+        int i = ifirst + k;
+        if (mask[i] & groupbit) {
+          double value = pertree ? eval_tree(tree,i) : values[k];
+          if (sumflag) result[m] += value;
+          else result[m] = value;
+        } else if (sumflag == 0) result[m] = 0.0;
         m += stride;
       }
     }
@@ -1103,8 +1137,22 @@ int Variable::compute_vector(int ivar, double **result)
   vecs[ivar].n = nlen;
   vecs[ivar].currentstep = update->ntimestep;
   double *vec = vecs[ivar].values;
-  for (int i = 0; i < nlen; i++)
-    vec[i] = eval_tree(tree,i);
+
+  program.clear();
+  int depth = compile_tree(tree);
+  if (depth > maxstack) {
+    maxstack = depth;
+    memory->destroy(vstack);
+    memory->create(vstack,maxstack*VARBLOCK,"variable:vstack");
+  }
+
+  double *values = nullptr;
+  for (int ifirst = 0; ifirst < nlen; ifirst += VARBLOCK) {
+    int n = MIN(VARBLOCK,nlen-ifirst);
+    if (depth < 0 || eval_block(ifirst,n,values))
+      for (int i = ifirst; i < ifirst+n; i++) vec[i] = eval_tree(tree,i);
+    else memcpy(&vec[ifirst],values,n*sizeof(double));
+  }
 
   free_tree(tree);
   eval_in_progress[ivar] = 0;
@@ -3211,6 +3259,243 @@ double Variable::eval_tree(Tree *tree, int i)
   return 0.0;
 }
 
+/* ----------------------------------------------------------------------
+   append nodes of a collapsed tree to program in postfix order
+   return # of stack levels eval_block() needs to run program
+   return -1 if tree has a node eval_block() does not support,
+     caller must then use eval_tree()
+------------------------------------------------------------------------- */
+
+int Variable::compile_tree(Tree *tree)
+{
+  int depth1,depth2;
+
+  switch (tree->type) {
+  case VALUE: case ATOMARRAY: case TYPEARRAY: case INTARRAY:
+  case BIGINTARRAY: case VECTORARRAY: case GMASK: case RMASK: case GRMASK:
+    program.push_back(tree);
+    return 1;
+
+  case UNARY: case NOT: case SQRT: case EXP: case LN: case LOG: case ABS:
+  case SIN: case COS: case TAN: case ASIN: case ACOS: case ATAN:
+  case CEIL: case FLOOR: case ROUND:
+    depth1 = compile_tree(tree->first);
+    if (depth1 < 0) return -1;
+    program.push_back(tree);
+    return depth1;
+
+  case ADD: case SUBTRACT: case MULTIPLY: case DIVIDE: case MODULO:
+  case CARAT: case EQ: case NE: case LT: case LE: case GT: case GE:
+  case AND: case OR: case XOR: case ATAN2:
+    depth1 = compile_tree(tree->first);
+    if (depth1 < 0) return -1;
+    depth2 = compile_tree(tree->second);
+    if (depth2 < 0) return -1;
+    program.push_back(tree);
+    return MAX(depth1,depth2+1);
+
+  default:
+    return -1;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   run program from compile_tree() for N atoms or vector indices from ifirst
+   each stack level holds one value per atom, so every operation is
+     a simple loop over the block that the compiler can vectorize
+   values = ptr to N results
+   return 1 if an operand was invalid for its operation,
+     caller must then use eval_tree() for this block, which flags the error
+     unless the operation is skipped by a short-circuit AND/OR
+------------------------------------------------------------------------- */
+
+int Variable::eval_block(int ifirst, int n, double *&values)
+{
+  int k,invalid = 0;
+  double *a,*b;
+  double *top = vstack - VARBLOCK;
+
+  for (auto &tree : program) {
+    switch (tree->type) {
+
+    // leaves push a new level
+
+    case VALUE:
+      top += VARBLOCK;
+      for (k = 0; k < n; k++) top[k] = tree->value;
+      break;
+    case ATOMARRAY: case VECTORARRAY: {
+      top += VARBLOCK;
+      const double *array = &tree->array[ifirst*tree->nstride];
+      const int nstride = tree->nstride;
+      for (k = 0; k < n; k++) top[k] = array[k*nstride];
+      break;
+    }
+    case TYPEARRAY: {
+      top += VARBLOCK;
+      const int *type = &atom->type[ifirst];
+      for (k = 0; k < n; k++) top[k] = tree->array[type[k]];
+      break;
+    }
+    case INTARRAY: {
+      top += VARBLOCK;
+      const int *iarray = &tree->iarray[ifirst*tree->nstride];
+      const int nstride = tree->nstride;
+      for (k = 0; k < n; k++) top[k] = (double) iarray[k*nstride];
+      break;
+    }
+    case BIGINTARRAY: {
+      top += VARBLOCK;
+      const bigint *barray = &tree->barray[ifirst*tree->nstride];
+      const int nstride = tree->nstride;
+      for (k = 0; k < n; k++) top[k] = (double) barray[k*nstride];
+      break;
+    }
+    case GMASK: {
+      top += VARBLOCK;
+      const int *mask = &atom->mask[ifirst];
+      for (k = 0; k < n; k++) top[k] = (mask[k] & tree->ivalue1) ? 1.0 : 0.0;
+      break;
+    }
+    case RMASK: case GRMASK: {
+      top += VARBLOCK;
+      Region *region = (tree->type == RMASK) ?
+        domain->regions[tree->ivalue1] : domain->regions[tree->ivalue2];
+      double **x = atom->x;
+      int *mask = atom->mask;
+      for (k = 0; k < n; k++) {
+        int i = ifirst + k;
+        if (tree->type == GRMASK && !(mask[i] & tree->ivalue1)) top[k] = 0.0;
+        else top[k] = region->match(x[i][0],x[i][1],x[i][2]) ? 1.0 : 0.0;
+      }
+      break;
+    }
+
+    // unary operations replace top level
+
+    case UNARY:
+      for (k = 0; k < n; k++) top[k] = -top[k];
+      break;
+    case NOT:
+      for (k = 0; k < n; k++) top[k] = (top[k] == 0.0) ? 1.0 : 0.0;
+      break;
+    case SQRT:
+      for (k = 0; k < n; k++) invalid |= (top[k] < 0.0);
+      for (k = 0; k < n; k++) top[k] = sqrt(top[k]);
+      break;
+    case EXP:
+      for (k = 0; k < n; k++) top[k] = exp(top[k]);
+      break;
+    case LN:
+      for (k = 0; k < n; k++) invalid |= (top[k] <= 0.0);
+      for (k = 0; k < n; k++) top[k] = log(top[k]);
+      break;
+    case LOG:
+      for (k = 0; k < n; k++) invalid |= (top[k] <= 0.0);
+      for (k = 0; k < n; k++) top[k] = log10(top[k]);
+      break;
+    case ABS:
+      for (k = 0; k < n; k++) top[k] = fabs(top[k]);
+      break;
+    case SIN:
+      for (k = 0; k < n; k++) top[k] = sin(top[k]);
+      break;
+    case COS:
+      for (k = 0; k < n; k++) top[k] = cos(top[k]);
+      break;
+    case TAN:
+      for (k = 0; k < n; k++) top[k] = tan(top[k]);
+      break;
+    case ASIN:
+      for (k = 0; k < n; k++) invalid |= (top[k] < -1.0 || top[k] > 1.0);
+      for (k = 0; k < n; k++) top[k] = asin(top[k]);
+      break;
+    case ACOS:
+      for (k = 0; k < n; k++) invalid |= (top[k] < -1.0 || top[k] > 1.0);
+      for (k = 0; k < n; k++) top[k] = acos(top[k]);
+      break;
+    case ATAN:
+      for (k = 0; k < n; k++) top[k] = atan(top[k]);
+      break;
+    case CEIL:
+      for (k = 0; k < n; k++) top[k] = ceil(top[k]);
+      break;
+    case FLOOR:
+      for (k = 0; k < n; k++) top[k] = floor(top[k]);
+      break;
+    case ROUND:
+      for (k = 0; k < n; k++) top[k] = MYROUND(top[k]);
+      break;
+
+    // binary operations pop top level and replace the one below it
+
+    default:
+      b = top;
+      top -= VARBLOCK;
+      a = top;
+      switch (tree->type) {
+      case ADD:
+        for (k = 0; k < n; k++) a[k] += b[k];
+        break;
+      case SUBTRACT:
+        for (k = 0; k < n; k++) a[k] -= b[k];
+        break;
+      case MULTIPLY:
+        for (k = 0; k < n; k++) a[k] *= b[k];
+        break;
+      case DIVIDE:
+        for (k = 0; k < n; k++) invalid |= (b[k] == 0.0);
+        for (k = 0; k < n; k++) a[k] /= b[k];
+        break;
+      case MODULO:
+        for (k = 0; k < n; k++) invalid |= (b[k] == 0.0);
+        for (k = 0; k < n; k++) a[k] = fmod(a[k],b[k]);
+        break;
+      case CARAT:
+        for (k = 0; k < n; k++) invalid |= (b[k] == 0.0);
+        for (k = 0; k < n; k++) a[k] = pow(a[k],b[k]);
+        break;
+      case EQ:
+        for (k = 0; k < n; k++) a[k] = (a[k] == b[k]) ? 1.0 : 0.0;
+        break;
+      case NE:
+        for (k = 0; k < n; k++) a[k] = (a[k] != b[k]) ? 1.0 : 0.0;
+        break;
+      case LT:
+        for (k = 0; k < n; k++) a[k] = (a[k] < b[k]) ? 1.0 : 0.0;
+        break;
+      case LE:
+        for (k = 0; k < n; k++) a[k] = (a[k] <= b[k]) ? 1.0 : 0.0;
+        break;
+      case GT:
+        for (k = 0; k < n; k++) a[k] = (a[k] > b[k]) ? 1.0 : 0.0;
+        break;
+      case GE:
+        for (k = 0; k < n; k++) a[k] = (a[k] >= b[k]) ? 1.0 : 0.0;
+        break;
+      case AND:
+        for (k = 0; k < n; k++)
+          a[k] = (a[k] != 0.0 && b[k] != 0.0) ? 1.0 : 0.0;
+        break;
+      case OR:
+        for (k = 0; k < n; k++)
+          a[k] = (a[k] != 0.0 || b[k] != 0.0) ? 1.0 : 0.0;
+        break;
+      case XOR:
+        for (k = 0; k < n; k++)
+          a[k] = ((a[k] == 0.0) != (b[k] == 0.0)) ? 1.0 : 0.0;
+        break;
+      case ATAN2:
+        for (k = 0; k < n; k++) a[k] = atan2(a[k],b[k]);
+        break;
+      }
+    }
+  }
+
+  values = top;
+  return invalid;
+}
+
 /* ----------------------------------------------------------------------
    scan entire tree, find size of vectors for vector-style variable
    return N for consistent vector size
@@ -16,6 +16,8 @@
 
 #include "pointers.h"
 
+#include <vector>
+
 namespace LAMMPS_NS {
 
 class Variable : protected Pointers {
@@ -46,6 +48,8 @@ class Variable : protected Pointers {
   int compute_vector(int, double **);
   void internal_set(int, double);
 
+  int depend_text(int, std::string &);
+
   tagint int_between_brackets(char *&, int);
   double evaluate_boolean(char *);
 
@@ -104,6 +108,10 @@ class Variable : protected Pointers {
       first(nullptr), second(nullptr), extra(nullptr) {}
   };
 
+  std::vector<Tree *> program;   // tree nodes in postfix order for eval_block()
+  double *vstack;                // value stack of eval_block(), VARBLOCK per level
+  int maxstack;                  // # of levels allocated in vstack
+
   int compute_python(int);
   void remove(int);
   void grow();
@@ -111,6 +119,8 @@ class Variable : protected Pointers {
   double evaluate(char *, Tree **, int);
   double collapse_tree(Tree *);
   double eval_tree(Tree *, int);
+  int compile_tree(Tree *);
+  int eval_block(int, int, double *&);
   int size_tree_vector(Tree *);
   int compare_tree_vector(int, int);
   void free_tree(Tree *);
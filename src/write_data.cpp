@@ -28,15 +28,26 @@
 #include "modify.h"
 #include "output.h"
 #include "pair.h"
+#include "read_data_binary.h"
 #include "thermo.h"
 #include "update.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <numeric>
+#include <vector>
 
 using namespace LAMMPS_NS;
 
 enum{II,IJ};
 enum{ELLIPSOID,LINE,TRIANGLE,BODY};   // also in AtomVecHybrid
+enum{BOND,ANGLE,DIHEDRAL,IMPROPER};
+
+// cells of the spatial index in binary data files
+
+static constexpr bigint CELLATOMS = 1000;      // target # of atoms per cell
+static constexpr bigint MAXCELL = 1 << 20;     // max # of cells
 
 /* ---------------------------------------------------------------------- */
 
@@ -70,6 +81,7 @@ void WriteData::command(int narg, char **arg)
   pairflag = II;
   coeffflag = 1;
   fixflag = 1;
+  binaryflag = 0;
   int noinit = 0;
 
   int iarg = 1;
@@ -89,6 +101,9 @@ void WriteData::command(int narg, char **arg)
     } else if (strcmp(arg[iarg],"nofix") == 0) {
       fixflag = 0;
       iarg++;
+    } else if (strcmp(arg[iarg],"binary") == 0) {
+      binaryflag = 1;
+      iarg++;
     } else error->all(FLERR,"Illegal write_data command");
   }
 
@@ -173,12 +188,20 @@ void WriteData::write(const std::string &file)
   // open data file
 
   if (me == 0) {
-    fp = fopen(file.c_str(),"w");
+    fp = fopen(file.c_str(),binaryflag ? "wb" : "w");
     if (fp == nullptr)
       error->one(FLERR,"Cannot open data file {}: {}",
                                    file, utils::getsyserror());
   }
 
+  // binary data file has its own layout, see read_data_binary.h
+
+  if (binaryflag) {
+    binary(natoms);
+    if (me == 0) fclose(fp);
+    return;
+  }
+
   // proc 0 writes header, ntype-length arrays, force fields
 
   if (me == 0) {
@@ -771,3 +794,298 @@ void WriteData::fix(int ifix, int mth)
 
   memory->destroy(buf);
 }
+
+/* ----------------------------------------------------------------------
+   write a binary data file for ReadDataBinary
+   atoms and topology are sorted into the cells of a coarse grid,
+     so that procs reading the file can find the atoms of their sub-domain
+------------------------------------------------------------------------- */
+
+void WriteData::binary(bigint natoms)
+{
+  if (atom->ellipsoid_flag || atom->line_flag || atom->tri_flag ||
+      atom->body_flag || atom->molecular == Atom::TEMPLATE)
+    error->all(FLERR,"Write_data binary is not supported by this atom style");
+
+  int molecular = (atom->molecular == Atom::MOLECULAR);
+
+  BinaryDataHeader hdr;
+  ReadDataBinary::init_header(hdr);
+  hdr.natoms = natoms;
+  hdr.nbonds = (molecular && atom->nbonds) ? nbonds : 0;
+  hdr.nangles = (molecular && atom->nangles) ? nangles : 0;
+  hdr.ndihedrals = (molecular && atom->ndihedrals) ? ndihedrals : 0;
+  hdr.nimpropers = (molecular && atom->nimpropers) ? nimpropers : 0;
+  hdr.ntypes = atom->ntypes;
+  hdr.nbondtypes = atom->nbondtypes;
+  hdr.nangletypes = atom->nangletypes;
+  hdr.ndihedraltypes = atom->ndihedraltypes;
+  hdr.nimpropertypes = atom->nimpropertypes;
+  hdr.triclinic = domain->triclinic;
+  hdr.velflag = 1;
+  hdr.molflag = atom->molecule_flag;
+  hdr.qflag = atom->q_flag;
+  for (int i = 0; i < 3; i++) {
+    hdr.boxlo[i] = domain->boxlo[i];
+    hdr.boxhi[i] = domain->boxhi[i];
+  }
+  hdr.xy = domain->xy;
+  hdr.xz = domain->xz;
+  hdr.yz = domain->yz;
+
+  // grid of about CELLATOMS atoms per cell with cells as cubic as possible
+
+  int dimension = domain->dimension;
+  bigint ntarget = MIN(MAX(natoms/CELLATOMS,1),MAXCELL);
+  double volume = domain->prd[0]*domain->prd[1];
+  if (dimension == 3) volume *= domain->prd[2];
+  double len = pow(volume/ntarget,1.0/dimension);
+  for (int i = 0; i < dimension; i++)
+    hdr.ncell[i] = static_cast<int>
+      (MIN(MAX(domain->prd[i]/len,1.0),(double) MAXCELL));
+  if (dimension == 2) hdr.ncell[2] = 1;
+
+  // flat boxes can exceed MAXCELL, coarsen the longest cells
+
+  while ((bigint) hdr.ncell[0]*hdr.ncell[1]*hdr.ncell[2] > MAXCELL) {
+    int imax = 0;
+    for (int i = 1; i < 3; i++)
+      if (hdr.ncell[i] > hdr.ncell[imax]) imax = i;
+    hdr.ncell[imax] /= 2;
+  }
+
+  // proc 0 writes header and masses
+
+  bigint filepos = sizeof(BinaryDataHeader);
+  if (me == 0) {
+    fwrite(&hdr,sizeof(BinaryDataHeader),1,fp);
+    std::vector<double> mass(atom->ntypes,0.0);
+    if (atom->mass)
+      for (int i = 1; i <= atom->ntypes; i++)
+        if (atom->mass_setflag[i]) mass[i-1] = atom->mass[i];
+    fwrite(mass.data(),sizeof(double),atom->ntypes,fp);
+  }
+  filepos += atom->ntypes*sizeof(double);
+
+  // cell of each owned atom, also needed for ghost atoms for topology
+
+  int nlocal = atom->nlocal;
+  double **x = atom->x;
+  double **cell;
+  memory->create(cell,MAX(1,atom->nmax),1,"write_data:cell");
+
+  double lamda[3];
+  for (int i = 0; i < nlocal; i++) {
+    domain->x2lamda(x[i],lamda);
+    cell[i][0] = ReadDataBinary::cell(hdr,lamda);
+  }
+
+  // atom records sorted by cell
+
+  std::vector<int> order(nlocal);
+  std::iota(order.begin(),order.end(),0);
+  std::stable_sort(order.begin(),order.end(),
+                   [&cell](int a, int b) { return cell[a][0] < cell[b][0]; });
+
+  std::vector<BinaryDataAtom> records(nlocal);
+  std::vector<bigint> cells(nlocal);
+  for (int n = 0; n < nlocal; n++) {
+    int i = order[n];
+    BinaryDataAtom &one = records[n];
+    memset(&one,0,sizeof(BinaryDataAtom));
+    one.id = atom->tag[i];
+    one.type = atom->type[i];
+    if (atom->molecule_flag) one.molecule = atom->molecule[i];
+    if (atom->q_flag) one.q = atom->q[i];
+    imageint image = atom->image[i];
+    one.image[0] = (image & IMGMASK) - IMGMAX;
+    one.image[1] = (image >> IMGBITS & IMGMASK) - IMGMAX;
+    one.image[2] = (image >> IMG2BITS) - IMGMAX;
+    for (int k = 0; k < 3; k++) {
+      one.x[k] = x[i][k];
+      one.v[k] = atom->v[i][k];
+    }
+    cells[n] = static_cast<bigint> (cell[i][0]);
+  }
+
+  binary_section(records.data(),sizeof(BinaryDataAtom),nlocal,cells.data(),
+                 hdr,filepos);
+
+  // topology, each proc packs the interactions it owns
+
+  if (hdr.nbonds || hdr.nangles || hdr.ndihedrals || hdr.nimpropers)
+    comm->forward_comm_array(1,cell);
+
+  if (hdr.nbonds) binary_topology(BOND,nbonds_local,cell,hdr,filepos);
+  if (hdr.nangles) binary_topology(ANGLE,nangles_local,cell,hdr,filepos);
+  if (hdr.ndihedrals)
+    binary_topology(DIHEDRAL,ndihedrals_local,cell,hdr,filepos);
+  if (hdr.nimpropers)
+    binary_topology(IMPROPER,nimpropers_local,cell,hdr,filepos);
+
+  memory->destroy(cell);
+}
+
+/* ----------------------------------------------------------------------
+   write one topology section of a binary data file
+   each interaction is written once to each cell with one of its atoms
+------------------------------------------------------------------------- */
+
+void WriteData::binary_topology(int which, bigint nlocal_topo, double **cell,
+                                const BinaryDataHeader &hdr, bigint &filepos)
+{
+  int nper = (which == BOND) ? 2 : ((which == ANGLE) ? 3 : 4);
+  int ncol = nper + 1;
+  int n = static_cast<int> (nlocal_topo);
+
+  tagint **buf;
+  memory->create(buf,MAX(1,n),ncol,"write_data:buf");
+  if (which == BOND) atom->avec->pack_bond(buf);
+  else if (which == ANGLE) atom->avec->pack_angle(buf);
+  else if (which == DIHEDRAL) atom->avec->pack_dihedral(buf);
+  else atom->avec->pack_improper(buf);
+
+  std::vector<BinaryDataTopo> unsorted;
+  std::vector<bigint> unsorted_cells;
+  bigint icell[4];
+
+  int flag = 0;
+  for (int i = 0; i < n; i++) {
+    for (int k = 0; k < nper; k++) {
+      int m = atom->map(buf[i][k+1]);
+      if (m < 0) {
+        flag = 1;
+        icell[k] = 0;
+      } else icell[k] = static_cast<bigint> (cell[m][0]);
+    }
+
+    for (int k = 0; k < nper; k++) {
+      int first = 1;
+      for (int l = 0; l < k; l++)
+        if (icell[l] == icell[k]) first = 0;
+      if (!first) continue;
+
+      BinaryDataTopo one;
+      memset(&one,0,sizeof(BinaryDataTopo));
+      one.type = buf[i][0];
+      for (int l = 0; l < nper; l++) {
+        one.atom[l] = buf[i][l+1];
+        if (icell[l] == icell[k]) one.mask |= 1 << l;
+      }
+      unsorted.push_back(one);
+      unsorted_cells.push_back(icell[k]);
+    }
+  }
+  memory->destroy(buf);
+
+  int flagall;
+  MPI_Allreduce(&flag,&flagall,1,MPI_INT,MPI_MAX,world);
+  if (flagall)
+    error->all(FLERR,"Write_data binary cannot find all atoms of a bond, "
+               "angle, dihedral, or improper");
+
+  int nrec = unsorted.size();
+  std::vector<int> order(nrec);
+  std::iota(order.begin(),order.end(),0);
+  std::stable_sort(order.begin(),order.end(),[&unsorted_cells](int a, int b)
+                   { return unsorted_cells[a] < unsorted_cells[b]; });
+
+  std::vector<BinaryDataTopo> records(nrec);
+  std::vector<bigint> cells(nrec);
+  for (int i = 0; i < nrec; i++) {
+    records[i] = unsorted[order[i]];
+    cells[i] = unsorted_cells[order[i]];
+  }
+
+  binary_section(records.data(),sizeof(BinaryDataTopo),nrec,cells.data(),
+                 hdr,filepos);
+}
+
+/* ----------------------------------------------------------------------
+   write one section of a binary data file: cell index, then records
+   records of each proc are sorted by cell
+   proc 0 receives them from one proc at a time and writes each run of
+     records in the same cell behind those of lower procs in that cell
+------------------------------------------------------------------------- */
+
+void WriteData::binary_section(const void *records, int size, int n,
+                               const bigint *cells,
+                               const BinaryDataHeader &hdr, bigint &filepos)
+{
+  bigint ncell = (bigint) hdr.ncell[0] * hdr.ncell[1] * hdr.ncell[2];
+
+  std::vector<bigint> count(ncell,0),countall;
+  for (int i = 0; i < n; i++) count[cells[i]]++;
+  if (me == 0) countall.resize(ncell);
+  MPI_Reduce(count.data(),countall.data(),ncell,MPI_LMP_BIGINT,MPI_SUM,0,world);
+  count.clear();
+
+  std::vector<int64_t> index;
+  if (me == 0) {
+    index.resize(ncell+1);
+    index[0] = 0;
+    for (bigint i = 0; i < ncell; i++) index[i+1] = index[i] + countall[i];
+    fseek(fp,filepos,SEEK_SET);
+    fwrite(index.data(),sizeof(int64_t),ncell+1,fp);
+  }
+  bigint start = filepos + (ncell+1)*sizeof(int64_t);
+
+  MPI_Datatype record;
+  MPI_Type_contiguous(size,MPI_BYTE,&record);
+  MPI_Type_commit(&record);
+
+  int maxrow;
+  MPI_Allreduce(&n,&maxrow,1,MPI_INT,MPI_MAX,world);
+
+  int tmp,recvrow;
+  bigint total = 0;
+
+  if (me == 0) {
+    std::vector<char> rbuf((bigint) MAX(1,maxrow)*size);
+    std::vector<bigint> cbuf(MAX(1,maxrow));
+    std::vector<bigint> written(ncell,0);
+    MPI_Status status;
+    MPI_Request request[2];
+
+    for (int iproc = 0; iproc < nprocs; iproc++) {
+      const char *rptr;
+      const bigint *cptr;
+      if (iproc) {
+        MPI_Irecv(rbuf.data(),maxrow,record,iproc,0,world,&request[0]);
+        MPI_Irecv(cbuf.data(),maxrow,MPI_LMP_BIGINT,iproc,0,world,&request[1]);
+        MPI_Send(&tmp,0,MPI_INT,iproc,0,world);
+        MPI_Wait(&request[0],&status);
+        MPI_Get_count(&status,record,&recvrow);
+        MPI_Wait(&request[1],MPI_STATUS_IGNORE);
+        rptr = rbuf.data();
+        cptr = cbuf.data();
+      } else {
+        recvrow = n;
+        rptr = (const char *) records;
+        cptr = cells;
+      }
+
+      int i = 0;
+      while (i < recvrow) {
+        int j = i;
+        while (j < recvrow && cptr[j] == cptr[i]) j++;
+        bigint c = cptr[i];
+        fseek(fp,start + (index[c]+written[c])*size,SEEK_SET);
+        fwrite(rptr + (bigint) i*size,size,j-i,fp);
+        written[c] += j-i;
+        i = j;
+      }
+      total += recvrow;
+    }
+
+  } else {
+    MPI_Recv(&tmp,0,MPI_INT,0,0,world,MPI_STATUS_IGNORE);
+    MPI_Send(records,n,record,0,0,world);
+    MPI_Send(cells,n,MPI_LMP_BIGINT,0,0,world);
+  }
+
+  MPI_Type_free(&record);
+
+  MPI_Bcast(&total,1,MPI_LMP_BIGINT,0,world);
+  filepos = start + total*size;
+}
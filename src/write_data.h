@@ -24,6 +24,8 @@ CommandStyle(write_data,WriteData)
 
 namespace LAMMPS_NS {
 
+struct BinaryDataHeader;
+
 class WriteData : public Command {
  public:
   WriteData(class LAMMPS *);
@@ -35,6 +37,7 @@ class WriteData : public Command {
   int pairflag;
   int coeffflag;
   int fixflag;
+  int binaryflag;
   FILE *fp;
   bigint nbonds_local,nbonds;
   bigint nangles_local,nangles;
@@ -52,6 +55,12 @@ class WriteData : public Command {
   void impropers();
   void bonus(int);
   void fix(int, int);
+
+  void binary(bigint);
+  void binary_topology(int, bigint, double **, const BinaryDataHeader &,
+                       bigint &);
+  void binary_section(const void *, int, int, const bigint *,
+                      const BinaryDataHeader &, bigint &);
 };
 
 }
@@ -76,6 +85,16 @@ E: Atom count is inconsistent, cannot write data file
 The sum of atoms across processors does not equal the global number
 of atoms.  Probably some atoms have been lost.
 
+E: Write_data binary is not supported by this atom style
+
+Atom styles with bonus data and atom style template cannot be written
+to binary data files.
+
+E: Write_data binary cannot find all atoms of a bond, angle, dihedral, or improper
+
+All atoms of bonded interactions must be owned or ghost atoms of the
+processor that owns the interaction.
+
 E: Cannot open data file %s
 
 The specified file cannot be opened.  Check that the path and name are
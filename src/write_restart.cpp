@@ -49,6 +49,24 @@ WriteRestart::WriteRestart(LAMMPS *lmp) : Command(lmp)
   multiproc = 0;
   noinit = 0;
   fp = nullptr;
+  mpiio = nullptr;
+
+  async_flag = 0;
+  maxasync = 0;
+  asyncbuf = nullptr;
+  asynccount = nullptr;
+  async_thread = nullptr;
+  async_error = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+WriteRestart::~WriteRestart()
+{
+  async_wait(0);
+  memory->destroy(asyncbuf);
+  memory->destroy(asynccount);
+  delete mpiio;
 }
 
 /* ----------------------------------------------------------------------
@@ -79,6 +97,8 @@ void WriteRestart::command(int narg, char **arg)
   // also called by Output class for periodic restart files
 
   multiproc_options(multiproc,mpiioflag,narg-1,&arg[1]);
+  if (async_flag)
+    error->all(FLERR,"Restart async only allowed with the restart command");
 
   // init entire system since comm->exchange is done
   // comm::init needs neighbor::init needs pair::init needs kspace::init, etc
@@ -195,6 +215,14 @@ void WriteRestart::multiproc_options(int multiproc_caller, int mpiioflag_caller,
     } else if (strcmp(arg[iarg],"noinit") == 0) {
       noinit = 1;
       iarg++;
+    } else if (strcmp(arg[iarg],"async") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal write_restart command");
+      if (strcmp(arg[iarg+1],"yes") == 0) async_flag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) async_flag = 0;
+      else error->all(FLERR,"Illegal write_restart command");
+      if (async_flag && mpiioflag)
+        error->all(FLERR,"Restart async not allowed with MPI-IO output");
+      iarg += 2;
     } else error->all(FLERR,"Illegal write_restart command");
   }
 }
@@ -206,6 +234,10 @@ void WriteRestart::multiproc_options(int multiproc_caller, int mpiioflag_caller,
 
 void WriteRestart::write(std::string file)
 {
+  // previous file must be complete, since fp is reused
+
+  async_wait();
+
   // special case where reneighboring is not done in integrator
   //   on timestep restart file is written (due to build_once being set)
   // if box is changing, must be reset, else restart file will have
@@ -374,9 +406,38 @@ void WriteRestart::write(std::string file)
     // ping each proc in my cluster, receive its data, write data to file
     // else wait for ping from fileproc, send my data to fileproc
 
+    // if async, filewriter collects all data of its cluster in asyncbuf
+    //   and a background thread writes it, so the run can continue
+
     int tmp,recv_size;
 
-    if (filewriter) {
+    if (filewriter && async_flag) {
+      memory->grow(asynccount,nclusterprocs,"write_restart:asynccount");
+      MPI_Status status;
+      MPI_Request request;
+      bigint offset = 0;
+      for (int iproc = 0; iproc < nclusterprocs; iproc++) {
+        if (offset + max_size > maxasync) {
+          maxasync = MAX(offset + max_size,maxasync + maxasync/2);
+          memory->grow(asyncbuf,maxasync,"write_restart:asyncbuf");
+        }
+        if (iproc) {
+          MPI_Irecv(&asyncbuf[offset],max_size,MPI_DOUBLE,me+iproc,0,world,&request);
+          MPI_Send(&tmp,0,MPI_INT,me+iproc,0,world);
+          MPI_Wait(&request,&status);
+          MPI_Get_count(&status,MPI_DOUBLE,&recv_size);
+        } else {
+          recv_size = send_size;
+          memcpy(&asyncbuf[offset],buf,send_size*sizeof(double));
+        }
+        asynccount[iproc] = recv_size;
+        offset += recv_size;
+      }
+      async_error = 0;
+      async_thread = new std::thread(&WriteRestart::write_perproc,this,
+                                     nclusterprocs);
+
+    } else if (filewriter) {
       MPI_Status status;
       MPI_Request request;
       for (int iproc = 0; iproc < nclusterprocs; iproc++) {
@@ -417,6 +478,45 @@ void WriteRestart::write(std::string file)
       modify->fix[ifix]->write_restart_file(file.c_str());
 }
 
+/* ----------------------------------------------------------------------
+   write per-proc data of all procs in cluster from asyncbuf and close file
+   runs in the background thread, so it must not use MPI or error
+------------------------------------------------------------------------- */
+
+void WriteRestart::write_perproc(int nchunk)
+{
+  bigint offset = 0;
+  for (int iproc = 0; iproc < nchunk; iproc++) {
+    write_double_vec(PERPROC,asynccount[iproc],&asyncbuf[offset]);
+    offset += asynccount[iproc];
+  }
+  magic_string();
+  if (ferror(fp)) async_error = 1;
+  fclose(fp);
+  fp = nullptr;
+}
+
+/* ----------------------------------------------------------------------
+   wait until the background thread has finished writing the file
+   errflag = 1: raise an error for an I/O error of the thread
+   errflag = 0: only warn, e.g. when called from a destructor
+------------------------------------------------------------------------- */
+
+void WriteRestart::async_wait(int errflag)
+{
+  if (async_thread == nullptr) return;
+
+  async_thread->join();
+  delete async_thread;
+  async_thread = nullptr;
+
+  if (async_error) {
+    async_error = 0;
+    if (errflag) error->one(FLERR,"I/O error while writing restart");
+    else error->warning(FLERR,"I/O error while writing restart");
+  }
+}
+
 /* ----------------------------------------------------------------------
    proc 0 writes out problem description
 ------------------------------------------------------------------------- */
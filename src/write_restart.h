@@ -22,14 +22,19 @@ CommandStyle(write_restart,WriteRestart)
 
 #include "command.h"
 
+#include <string>
+#include <thread>
+
 namespace LAMMPS_NS {
 
 class WriteRestart : public Command {
  public:
   WriteRestart(class LAMMPS *);
+  ~WriteRestart();
   void command(int, char **);
   void multiproc_options(int, int, int, char **);
   void write(std::string);
+  void async_wait(int errflag = 1);
 
  private:
   int me,nprocs;
@@ -50,6 +55,17 @@ class WriteRestart : public Command {
   class RestartMPIIO *mpiio;   // MPIIO for restart file output
   MPI_Offset headerOffset;
 
+  // asynchronous output of per-atom data by a background thread
+
+  int async_flag;              // 1 if per-atom data is written by thread
+  bigint maxasync;             // size of asyncbuf in doubles
+  double *asyncbuf;            // per-atom data of all procs in cluster
+  int *asynccount;             // # of doubles from each proc in cluster
+  std::thread *async_thread;   // thread writing the current file, if any
+  int async_error;             // 1 if thread had an I/O error
+
+  void write_perproc(int);
+
   void header();
   void type_arrays();
   void force_fields();
@@ -111,4 +127,18 @@ E: Cannot open restart file %s
 
 Self-explanatory.
 
+E: Restart async not allowed with MPI-IO output
+
+MPI-IO restart files are written collectively by all processors.
+
+E: Restart async only allowed with the restart command
+
+The write_restart command writes its file immediately, so the async
+option can only be used for periodic restart files.
+
+E: I/O error while writing restart
+
+The file system could not write the restart file, e.g. because the
+disk is full.
+
 */
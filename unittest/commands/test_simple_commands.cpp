@@ -241,6 +241,95 @@ TEST_F(SimpleCommandsTest, ResetTimestep)
     TEST_FAILURE(".*ERROR: Expected integer .*", command("reset_timestep xxx"););
 }
 
+TEST_F(SimpleCommandsTest, TimerDetail)
+{
+    BEGIN_HIDE_OUTPUT();
+    command("lattice sc 1.0");
+    command("region box block 0 4 0 4 0 4");
+    command("create_box 2 box");
+    command("create_atoms 1 box");
+    command("set type 1 type/fraction 2 0.5 4928459");
+    command("mass * 1.0");
+    command("velocity all create 1.0 87287");
+    command("pair_style hybrid lj/cut 1.5 lj/cut 1.5");
+    command("pair_coeff 1 * lj/cut 1 1.0 1.0");
+    command("pair_coeff 2 2 lj/cut 2 1.0 1.0");
+    command("fix 1 all nve");
+    command("fix 2 all ave/time 2 1 2 c_thermo_temp");
+    command("dump d all atom 5 test_timer_detail.dump");
+    END_HIDE_OUTPUT();
+
+    BEGIN_CAPTURE_OUTPUT();
+    command("timer detail");
+    command("run 10");
+    auto text = END_CAPTURE_OUTPUT();
+    ASSERT_THAT(text, MatchesRegex(".*detail=on.*Detailed timing breakdown:.*"));
+    ASSERT_THAT(text, MatchesRegex(".*\nfix 1 initial_integrate +\\|.*"));
+    ASSERT_THAT(text, MatchesRegex(".*\nfix 2 end_of_step +\\|[^\n]*\\| 5 +\n.*"));
+    ASSERT_THAT(text, MatchesRegex(".*\ndump d +\\|[^\n]*\\| 2 +\n.*"));
+    ASSERT_THAT(text, MatchesRegex(".*\npair lj/cut 2 +\\|[^\n]*\\| 10 +\n.*"));
+    ASSERT_THAT(text, MatchesRegex(".*\ncompute thermo_pe +\\|.*"));
+
+    BEGIN_CAPTURE_OUTPUT();
+    command("timer nodetail");
+    command("run 10");
+    text = END_CAPTURE_OUTPUT();
+    ASSERT_THAT(text, Not(MatchesRegex(".*Detailed timing breakdown.*")));
+
+    TEST_FAILURE(".*ERROR: Illegal timer command.*", command("timer xxx"););
+    remove("test_timer_detail.dump");
+}
+
+TEST_F(SimpleCommandsTest, TimerTrace)
+{
+    BEGIN_HIDE_OUTPUT();
+    command("lattice sc 1.0");
+    command("region box block 0 4 0 4 0 4");
+    command("create_box 1 box");
+    command("create_atoms 1 box");
+    command("mass * 1.0");
+    command("velocity all create 1.0 87287");
+    command("pair_style lj/cut 1.5");
+    command("pair_coeff * * 1.0 1.0");
+    command("fix 1 all nve");
+    command("timer trace test_timer_trace.json");
+    command("run 10");
+    END_HIDE_OUTPUT();
+
+    std::ifstream in("test_timer_trace.json");
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    ASSERT_THAT(text, MatchesRegex("\\{\"displayTimeUnit\":\"ms\",\"traceEvents\":\\[\n.*\n\\]\\}\n"));
+    ASSERT_THAT(text, MatchesRegex(".*\"name\":\"MPI rank 0\".*"));
+    ASSERT_THAT(text, MatchesRegex(".*\\{\"name\":\"Pair\",\"cat\":\"section\",\"ph\":\"X\",\"pid\":0,"
+                                   "\"tid\":0,\"ts\":[0-9.]+,\"dur\":[0-9.]+\\}.*"));
+    ASSERT_THAT(text, MatchesRegex(".*\"name\":\"fix 1 final_integrate\",\"cat\":\"detail\".*"));
+
+    // one event per line, 10 steps have at least 10 pair and 20 fix events
+
+    int nevent = 0;
+    for (auto c : text)
+        if (c == '\n') ++nevent;
+    EXPECT_GT(nevent, 40);
+
+    BEGIN_CAPTURE_OUTPUT();
+    command("timer tracemax 5");
+    command("run 10");
+    text = END_CAPTURE_OUTPUT();
+    ASSERT_THAT(text, MatchesRegex(".*WARNING: Trace buffer overflow, only the last 5 events.*"));
+
+    in.open("test_timer_trace.json");
+    text.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    nevent = 0;
+    for (auto c : text)
+        if (c == '\n') ++nevent;
+    EXPECT_EQ(nevent, 8);
+
+    TEST_FAILURE(".*ERROR: Illegal timer command.*", command("timer trace"););
+    TEST_FAILURE(".*ERROR: Illegal timer command.*", command("timer tracemax 0"););
+    remove("test_timer_trace.json");
+}
+
 TEST_F(SimpleCommandsTest, Suffix)
 {
     ASSERT_EQ(lmp->suffix_enable, 0);
@@ -14,12 +14,15 @@
 #include "lammps.h"
 
 #include "atom.h"
+#include "compute.h"
 #include "domain.h"
 #include "group.h"
 #include "info.h"
 #include "input.h"
 #include "math_const.h"
+#include "modify.h"
 #include "region.h"
+#include "update.h"
 #include "variable.h"
 
 #include "gmock/gmock.h"
@@ -278,6 +281,143 @@ TEST_F(VariableTest, AtomicSystem)
                  variable->compute_equal("max(v_sum2)"););
 }
 
+TEST_F(VariableTest, AtomBlocks)
+{
+    BEGIN_HIDE_OUTPUT();
+    command("lattice sc 1.0");
+    command("region box block 0 8 0 8 0 9");
+    command("create_box 2 box");
+    command("create_atoms 1 box");
+    command("mass * 1.0");
+    command("region half block 0 4 INF INF INF INF");
+    command("set region half type 2");
+    command("variable one    atom      (x>2)*sqrt(x)+type^2-exp(-y)*cos(z)+rmask(half)");
+    command("variable two    atom      (x>0.5)&&(ln(x)>0)");
+    command("variable three  atom      (atan2(y,1+x)|^(z<3))-floor(x/3)%2");
+    command("variable four   atom      random(0,1,643532)");
+    command("variable five   atom      ln(x-1)");
+    END_HIDE_OUTPUT();
+
+    // more atoms than one block and blocks with invalid operands
+
+    auto atom = lmp->atom;
+    const int nlocal = atom->nlocal;
+    ASSERT_GT(nlocal, 256);
+    std::vector<double> result(2*nlocal);
+
+    variable->compute_atom(variable->find("one"), 0, result.data(), 1, 0);
+    for (int i = 0; i < nlocal; i++) {
+        double *x = atom->x[i];
+        double ref = ((x[0] > 2.0) ? sqrt(x[0]) : 0.0) + atom->type[i]*atom->type[i] -
+            exp(-x[1])*cos(x[2]) + ((x[0] <= 4.0) ? 1.0 : 0.0);
+        ASSERT_DOUBLE_EQ(result[i], ref);
+    }
+
+    variable->compute_atom(variable->find("two"), 0, result.data(), 2, 0);
+    for (int i = 0; i < nlocal; i++)
+        ASSERT_DOUBLE_EQ(result[2*i], (atom->x[i][0] > 1.0) ? 1.0 : 0.0);
+
+    std::vector<double> sum(nlocal, 1.0);
+    variable->compute_atom(variable->find("three"), 0, sum.data(), 1, 1);
+    for (int i = 0; i < nlocal; i++) {
+        double *x = atom->x[i];
+        double ref = ((atan2(x[1], 1.0+x[0]) != 0.0) != (x[2] < 3.0)) ? 1.0 : 0.0;
+        ref -= fmod(floor(x[0]/3.0), 2.0);
+        ASSERT_DOUBLE_EQ(sum[i], 1.0 + ref);
+    }
+
+    variable->compute_atom(variable->find("four"), 0, result.data(), 1, 0);
+    for (int i = 0; i < nlocal; i++) {
+        ASSERT_GE(result[i], 0.0);
+        ASSERT_LT(result[i], 1.0);
+    }
+
+    TEST_FAILURE(".*ERROR on proc 0: Log of zero/negative value in variable formula.*",
+                 variable->compute_atom(variable->find("five"), 0, result.data(), 1, 0););
+}
+
+TEST_F(VariableTest, ComputeDependencies)
+{
+    atomic_system();
+    BEGIN_HIDE_OUTPUT();
+    command("pair_style lj/cut 2.0");
+    command("pair_coeff * * 0.01 1.0");
+    command("compute t all temp");
+    command("fix ave1 all ave/time 5 1 5 c_t");
+    command("thermo_style custom step temp pe");
+    command("thermo 10");
+    command("run 10 post no");
+    END_HIDE_OUTPUT();
+
+    // fix ave/time on a temperature needs no virial on its first step
+
+    ASSERT_EQ(lmp->update->eflag_global, 10);
+    ASSERT_EQ(lmp->update->vflag_global, 0);
+
+    BEGIN_HIDE_OUTPUT();
+    command("variable p equal c_thermo_press");
+    command("variable s equal v_p");
+    command("fix ave2 all ave/time 5 1 5 v_s");
+    command("fix out all print 5 \"$(pe)\" screen no");
+    command("run 10 post no");
+    END_HIDE_OUTPUT();
+
+    ASSERT_EQ(lmp->update->vflag_global, 20);
+
+    BEGIN_CAPTURE_OUTPUT();
+    command("info computes");
+    auto text = END_CAPTURE_OUTPUT();
+    ASSERT_THAT(text, MatchesRegex(".*fix ave1 : t\n.*"));
+    ASSERT_THAT(text, MatchesRegex(".*fix ave2 : thermo_temp thermo_press\n.*"));
+    ASSERT_THAT(text, MatchesRegex(".*fix out : thermo_pe\n.*"));
+    ASSERT_THAT(text, MatchesRegex(".*thermo_press.virial.*"));
+}
+
+TEST_F(VariableTest, PartialReduction)
+{
+    atomic_system();
+    BEGIN_HIDE_OUTPUT();
+    command("pair_style lj/cut 2.0");
+    command("pair_coeff * * 0.01 1.0");
+    command("velocity all create 100.0 4928459");
+    command("compute k all ke");
+    command("thermo_style custom step temp press pe c_k pxy");
+    command("run 0 post no");
+    command("velocity all scale 200.0");
+    END_HIDE_OUTPUT();
+
+    // thermo_temp is stale, pressure is listed first and must not use it
+
+    auto modify = lmp->modify;
+    Compute *temp  = modify->compute[modify->find_compute("thermo_temp")];
+    Compute *press = modify->compute[modify->find_compute("thermo_press")];
+    Compute *pe    = modify->compute[modify->find_compute("thermo_pe")];
+    Compute *ke    = modify->compute[modify->find_compute("k")];
+    Compute *list[] = {press, temp, pe, ke, press, temp};
+    int which[] = {Compute::INVOKED_SCALAR, Compute::INVOKED_SCALAR,
+                   Compute::INVOKED_SCALAR, Compute::INVOKED_SCALAR,
+                   Compute::INVOKED_VECTOR, Compute::INVOKED_VECTOR};
+
+    modify->clearstep_compute();
+    modify->invoke_partial(6, list, which);
+    ASSERT_EQ(press->invoked_flag, Compute::INVOKED_SCALAR | Compute::INVOKED_VECTOR);
+    ASSERT_EQ(ke->invoked_flag, Compute::INVOKED_SCALAR);
+
+    double scalars[] = {press->scalar, temp->scalar, pe->scalar, ke->scalar};
+    std::vector<double> pvec(press->vector, press->vector + 6);
+
+    modify->clearstep_compute();
+    EXPECT_DOUBLE_EQ(temp->compute_scalar(), scalars[1]);
+    EXPECT_DOUBLE_EQ(press->compute_scalar(), scalars[0]);
+    EXPECT_DOUBLE_EQ(pe->compute_scalar(), scalars[2]);
+    EXPECT_DOUBLE_EQ(ke->compute_scalar(), scalars[3]);
+    temp->compute_vector();
+    press->compute_vector();
+    for (int i = 0; i < 6; i++)
+        EXPECT_DOUBLE_EQ(press->vector[i], pvec[i]);
+    EXPECT_NEAR(temp->scalar, 200.0, 1.0e-10);
+}
+
 TEST_F(VariableTest, Expressions)
 {
     atomic_system();
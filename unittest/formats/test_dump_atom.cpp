@@ -542,6 +542,51 @@ TEST_F(DumpAtomTest, per_processor_multi_file_run1)
     delete_file("dump_run1_p0_1.melt");
 }
 
+TEST_F(DumpAtomTest, async_run2)
+{
+    auto reference = "dump_sync_run2.melt";
+    auto dump_file = "dump_async_run2.melt";
+
+    BEGIN_HIDE_OUTPUT();
+    command(fmt::format("dump id0 all atom 1 {}", reference));
+    command(fmt::format("dump id1 all atom 1 {}", dump_file));
+    command("dump_modify id1 async yes");
+    command("run 2 post no");
+    END_HIDE_OUTPUT();
+
+    ASSERT_FILE_EXISTS(dump_file);
+    ASSERT_EQ(count_lines(dump_file), 123);
+    ASSERT_FILE_EQUAL(reference, dump_file);
+    delete_file(reference);
+    delete_file(dump_file);
+}
+
+TEST_F(DumpAtomTest, async_no_buffer_run1plus1)
+{
+    auto dump_file = "dump_async_no_buffer_run1plus1.melt";
+    generate_dump(dump_file, "async yes buffer no", 1);
+
+    ASSERT_FILE_EXISTS(dump_file);
+    ASSERT_EQ(count_lines(dump_file), 82);
+    continue_dump(1);
+    ASSERT_FILE_EXISTS(dump_file);
+    ASSERT_EQ(count_lines(dump_file), 123);
+    delete_file(dump_file);
+}
+
+TEST_F(DumpAtomTest, async_multi_file_run1)
+{
+    auto dump_file = "dump_async_run1_*.melt";
+    generate_dump(dump_file, "async yes", 1);
+
+    ASSERT_FILE_EXISTS("dump_async_run1_0.melt");
+    ASSERT_FILE_EXISTS("dump_async_run1_1.melt");
+    ASSERT_EQ(count_lines("dump_async_run1_0.melt"), 41);
+    ASSERT_EQ(count_lines("dump_async_run1_1.melt"), 41);
+    delete_file("dump_async_run1_0.melt");
+    delete_file("dump_async_run1_1.melt");
+}
+
 TEST_F(DumpAtomTest, dump_modify_scale_invalid)
 {
     BEGIN_HIDE_OUTPUT();
@@ -89,6 +89,131 @@ TEST_F(DumpAtomCompressTest, compressed_no_buffer_run0)
     delete_file(converted_file);
 }
 
+TEST_F(DumpAtomCompressTest, compressed_async_run2)
+{
+    if (!COMPRESS_BINARY) GTEST_SKIP();
+
+    auto text_file       = text_dump_filename("async_run2.melt");
+    auto compressed_file = compressed_dump_filename("async_run2.melt");
+
+    if(compression_style == "atom/zstd") {
+        generate_text_and_compressed_dump(text_file, compressed_file, "", "", "", "async yes checksum yes", 2);
+    } else {
+        generate_text_and_compressed_dump(text_file, compressed_file, "", "", "", "async yes", 2);
+    }
+
+    TearDown();
+
+    ASSERT_FILE_EXISTS(text_file);
+    ASSERT_FILE_EXISTS(compressed_file);
+
+    auto converted_file = convert_compressed_to_text(compressed_file);
+
+    ASSERT_THAT(converted_file, Eq(converted_dump_filename("async_run2.melt")));
+    ASSERT_FILE_EXISTS(converted_file);
+    ASSERT_FILE_EQUAL(text_file, converted_file);
+    delete_file(text_file);
+    delete_file(compressed_file);
+    delete_file(converted_file);
+}
+
+TEST_F(DumpAtomCompressTest, compressed_async_no_buffer_multi_file_run1)
+{
+    if (!COMPRESS_BINARY) GTEST_SKIP();
+
+    auto base_name         = "async_multi_file_run1_*.melt";
+    auto base_name_0       = "async_multi_file_run1_0.melt";
+    auto base_name_1       = "async_multi_file_run1_1.melt";
+    auto text_file         = text_dump_filename(base_name);
+    auto text_file_0       = text_dump_filename(base_name_0);
+    auto text_file_1       = text_dump_filename(base_name_1);
+    auto compressed_file   = compressed_dump_filename(base_name);
+    auto compressed_file_0 = compressed_dump_filename(base_name_0);
+    auto compressed_file_1 = compressed_dump_filename(base_name_1);
+
+    if(compression_style == "atom/zstd") {
+        generate_text_and_compressed_dump(text_file, compressed_file, "", "", "buffer no", "buffer no async yes checksum no", 1);
+    } else {
+        generate_text_and_compressed_dump(text_file, compressed_file, "", "", "buffer no", "buffer no async yes", 1);
+    }
+
+    TearDown();
+
+    auto converted_file_0 = convert_compressed_to_text(compressed_file_0);
+    auto converted_file_1 = convert_compressed_to_text(compressed_file_1);
+
+    ASSERT_THAT(converted_file_0, Eq(converted_dump_filename(base_name_0)));
+    ASSERT_THAT(converted_file_1, Eq(converted_dump_filename(base_name_1)));
+    ASSERT_FILE_EXISTS(converted_file_0);
+    ASSERT_FILE_EXISTS(converted_file_1);
+    ASSERT_FILE_EQUAL(text_file_0, converted_file_0);
+    ASSERT_FILE_EQUAL(text_file_1, converted_file_1);
+
+    delete_file(text_file_0);
+    delete_file(text_file_1);
+    delete_file(compressed_file_0);
+    delete_file(compressed_file_1);
+    delete_file(converted_file_0);
+    delete_file(converted_file_1);
+}
+
+TEST_F(DumpAtomCompressTest, compressed_threads_run1)
+{
+    if (!COMPRESS_BINARY) GTEST_SKIP();
+
+    auto text_file       = text_dump_filename("threads_run1.melt");
+    auto compressed_file = compressed_dump_filename("threads_run1.melt");
+
+    if(compression_style == "atom/zstd") {
+        generate_text_and_compressed_dump(text_file, compressed_file, "", "", "", "compression_threads 2 checksum yes", 1);
+    } else {
+        generate_text_and_compressed_dump(text_file, compressed_file, "", "", "", "compression_threads 2", 1);
+    }
+
+    TearDown();
+
+    ASSERT_FILE_EXISTS(text_file);
+    ASSERT_FILE_EXISTS(compressed_file);
+
+    auto converted_file = convert_compressed_to_text(compressed_file);
+
+    ASSERT_THAT(converted_file, Eq(converted_dump_filename("threads_run1.melt")));
+    ASSERT_FILE_EXISTS(converted_file);
+    ASSERT_FILE_EQUAL(text_file, converted_file);
+    delete_file(text_file);
+    delete_file(compressed_file);
+    delete_file(converted_file);
+}
+
+TEST_F(DumpAtomCompressTest, compressed_read_dump_run1)
+{
+    if (!COMPRESS_BINARY) GTEST_SKIP();
+
+    auto text_file       = text_dump_filename("read_dump_run1.melt");
+    auto compressed_file = compressed_dump_filename("read_dump_run1.melt");
+    auto text_reread     = text_dump_filename("read_dump_text.melt");
+    auto compressed_reread = text_dump_filename("read_dump_compressed.melt");
+
+    generate_text_and_compressed_dump(text_file, compressed_file, "", "", "", "compression_threads 2", 1);
+
+    BEGIN_HIDE_OUTPUT();
+    command("undump id0");
+    command("undump id1");
+    command(fmt::format("read_dump {} 1 x y z box yes", text_file));
+    command(fmt::format("write_dump all custom {} id x y z modify sort id", text_reread));
+    command(fmt::format("read_dump {} 1 x y z box yes", compressed_file));
+    command(fmt::format("write_dump all custom {} id x y z modify sort id", compressed_reread));
+    END_HIDE_OUTPUT();
+
+    ASSERT_FILE_EXISTS(text_reread);
+    ASSERT_FILE_EXISTS(compressed_reread);
+    ASSERT_FILE_EQUAL(text_reread, compressed_reread);
+    delete_file(text_file);
+    delete_file(compressed_file);
+    delete_file(text_reread);
+    delete_file(compressed_reread);
+}
+
 TEST_F(DumpAtomCompressTest, compressed_multi_file_run1)
 {
     if (!COMPRESS_BINARY) GTEST_SKIP();
@@ -120,6 +120,23 @@ TEST_F(DumpCustomTest, thresh_run0)
     delete_file(dump_file);
 }
 
+TEST_F(DumpCustomTest, sort_column_run0)
+{
+    auto dump_file = "dump_custom_sort_column_run0.melt";
+    auto fields    = "id type x y z";
+
+    generate_dump(dump_file, fields, "units yes sort -3", 0);
+
+    ASSERT_FILE_EXISTS(dump_file);
+    auto lines = read_lines(dump_file);
+    ASSERT_EQ(lines.size(), 43);
+    ASSERT_THAT(lines[10], Eq(fmt::format("ITEM: ATOMS {}", fields)));
+    for (int i = 12; i < 43; ++i)
+        ASSERT_GE(std::stod(utils::split_words(lines[i-1])[2]),
+                  std::stod(utils::split_words(lines[i])[2]));
+    delete_file(dump_file);
+}
+
 TEST_F(DumpCustomTest, compute_run0)
 {
     BEGIN_HIDE_OUTPUT();
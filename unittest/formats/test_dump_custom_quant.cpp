@@ -0,0 +1,164 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://lammps.sandia.gov/, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "../testing/core.h"
+#include "../testing/systems/melt.h"
+#include "../testing/utils.h"
+#include "fmt/format.h"
+#include "utils.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <string>
+
+using ::testing::Eq;
+
+bool verbose = false;
+
+class DumpCustomQuantTest : public MeltTest {
+public:
+    // write text and custom/quant dumps of the same run, then read the
+    // last snapshot of each back with read_dump and write it as text
+
+    void generate_and_reread(std::string quant_file, std::string dump_modify_options,
+                             std::string fields, std::string text_reread,
+                             std::string quant_reread)
+    {
+        auto text_file = "dump_quant_reference.melt";
+
+        BEGIN_HIDE_OUTPUT();
+        command(fmt::format("dump id0 all custom 1 {} id type {}", text_file, fields));
+        command("dump_modify id0 format float %20.15g");
+        command(fmt::format("dump id1 all custom/quant 1 {} id type {}", quant_file, fields));
+        if (!dump_modify_options.empty())
+            command(fmt::format("dump_modify id1 {}", dump_modify_options));
+        command("run 2 post no");
+        command("undump id0");
+        command("undump id1");
+
+        command(fmt::format("read_dump {} 2 {} box yes", text_file, fields));
+        command(fmt::format("write_dump all custom {} id type {} modify sort id "
+                            "format float %20.15g", text_reread, fields));
+        command(fmt::format("read_dump {} 2 {} box yes format quant", quant_file, fields));
+        command(fmt::format("write_dump all custom {} id type {} modify sort id "
+                            "format float %20.15g", quant_reread, fields));
+        END_HIDE_OUTPUT();
+        delete_file(text_file);
+    }
+};
+
+TEST_F(DumpCustomQuantTest, exact_run2)
+{
+    auto quant_file   = "dump_exact_run2.melt.gz";
+    auto text_reread  = "dump_quant_text_reread.melt";
+    auto quant_reread = "dump_quant_quant_reread.melt";
+
+    generate_and_reread(quant_file, "", "x y z vx vy vz", text_reread, quant_reread);
+
+    ASSERT_FILE_EXISTS(quant_file);
+    ASSERT_FILE_EQUAL(text_reread, quant_reread);
+    auto lines = read_lines(quant_reread);
+    ASSERT_EQ(lines.size(), 41);
+    ASSERT_THAT(lines[1], Eq("2"));
+    delete_file(quant_file);
+    delete_file(text_reread);
+    delete_file(quant_reread);
+}
+
+TEST_F(DumpCustomQuantTest, quantized_run2)
+{
+    auto quant_file   = "dump_quantized_run2.melt.gz";
+    auto text_reread  = "dump_quantized_text_reread.melt";
+    auto quant_reread = "dump_quantized_quant_reread.melt";
+    const double step = 0.001;
+
+    generate_and_reread(quant_file, fmt::format("quantize * {} keyframe 2", step),
+                        "x y z vx vy vz", text_reread, quant_reread);
+
+    // IDs and types are exact, floating point values within half a step
+
+    auto ref   = read_lines(text_reread);
+    auto quant = read_lines(quant_reread);
+    ASSERT_EQ(ref.size(), quant.size());
+    for (std::size_t i = 9; i < ref.size(); ++i) {
+        auto rwords = utils::split_words(ref[i]);
+        auto qwords = utils::split_words(quant[i]);
+        ASSERT_EQ(rwords.size(), 8);
+        ASSERT_EQ(qwords.size(), 8);
+        ASSERT_THAT(qwords[0], Eq(rwords[0]));
+        ASSERT_THAT(qwords[1], Eq(rwords[1]));
+        for (int j = 2; j < 8; ++j) {
+            double r = std::stod(rwords[j]);
+            double q = std::stod(qwords[j]);
+            ASSERT_LE(fabs(r - q), 0.5 * step * (1.0 + 1.0e-12));
+        }
+    }
+    delete_file(quant_file);
+    delete_file(text_reread);
+    delete_file(quant_reread);
+}
+
+TEST_F(DumpCustomQuantTest, no_id)
+{
+    TEST_FAILURE(".*Dump custom/quant requires an id field.*",
+                 command("dump id all custom/quant 1 dump_no_id.melt.gz type x y z"););
+}
+
+TEST_F(DumpCustomQuantTest, not_gz)
+{
+    TEST_FAILURE(".*Dump custom/quant only writes compressed files.*",
+                 command("dump id all custom/quant 1 dump_not_gz.melt id x y z"););
+}
+
+TEST_F(DumpCustomQuantTest, no_sort)
+{
+    TEST_FAILURE(".*Dump custom/quant requires sorting by atom ID.*",
+                 command("dump id all custom/quant 1 dump_no_sort.melt.gz id x y z");
+                 command("dump_modify id sort off");
+                 command("run 0 post no"););
+    delete_file("dump_no_sort.melt.gz");
+}
+
+TEST_F(DumpCustomQuantTest, quantize_int_field)
+{
+    BEGIN_HIDE_OUTPUT();
+    command("dump id all custom/quant 1 dump_quantize_int.melt.gz id type x y z");
+    END_HIDE_OUTPUT();
+    TEST_FAILURE(".*Dump_modify quantize field type is not a floating point field.*",
+                 command("dump_modify id quantize type 0.1"););
+    TEST_FAILURE(".*Dump_modify quantize field vx does not exist.*",
+                 command("dump_modify id quantize vx 0.1"););
+}
+
+int main(int argc, char **argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleMock(&argc, argv);
+
+    // handle arguments passed via environment variable
+    if (const char *var = getenv("TEST_ARGS")) {
+        std::vector<std::string> env = utils::split_words(var);
+        for (auto arg : env) {
+            if (arg == "-v") {
+                verbose = true;
+            }
+        }
+    }
+
+    if ((argc > 1) && (strcmp(argv[1], "-v") == 0)) verbose = true;
+
+    int rv = RUN_ALL_TESTS();
+    MPI_Finalize();
+    return rv;
+}
@@ -0,0 +1,123 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://lammps.sandia.gov/, Sandia National Laboratories
+   Steve Plimpton, sjplimp@sandia.gov
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "../testing/core.h"
+#include "../testing/systems/melt.h"
+#include "../testing/utils.h"
+#include "fmt/format.h"
+#include "utils.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <string>
+
+using ::testing::Eq;
+
+bool verbose = false;
+
+class DumpH5MDTest : public MeltTest {
+public:
+    // write text and h5md/mpiio dumps of the same run, then read the
+    // last snapshot of each back with read_dump and write it as text
+
+    void generate_and_reread(std::string h5md_file, std::string dump_modify_options,
+                             std::string fields, std::string text_reread,
+                             std::string h5md_reread)
+    {
+        auto text_file = "dump_h5md_reference.melt";
+
+        BEGIN_HIDE_OUTPUT();
+        command(fmt::format("dump id0 all custom 1 {} id type {}", text_file, fields));
+        command("dump_modify id0 format float %20.15g");
+        command(fmt::format("dump id1 all h5md/mpiio 1 {} position velocity species",
+                            h5md_file));
+        if (!dump_modify_options.empty())
+            command(fmt::format("dump_modify id1 {}", dump_modify_options));
+        command("run 2 post no");
+        command("undump id0");
+        command("undump id1");
+
+        command(fmt::format("read_dump {} 2 {} box yes", text_file, fields));
+        command(fmt::format("write_dump all custom {} id type {} modify sort id",
+                            text_reread, fields));
+        command(fmt::format("read_dump {} 2 {} box yes format h5md", h5md_file, fields));
+        command(fmt::format("write_dump all custom {} id type {} modify sort id",
+                            h5md_reread, fields));
+        END_HIDE_OUTPUT();
+        delete_file(text_file);
+    }
+};
+
+TEST_F(DumpH5MDTest, read_dump_run2)
+{
+    auto h5md_file   = "dump_read_dump_run2.h5";
+    auto text_reread = "dump_h5md_text_reread.melt";
+    auto h5md_reread = "dump_h5md_h5md_reread.melt";
+
+    generate_and_reread(h5md_file, "", "x y z vx vy vz", text_reread, h5md_reread);
+
+    ASSERT_FILE_EXISTS(h5md_file);
+    ASSERT_FILE_EQUAL(text_reread, h5md_reread);
+    auto lines = read_lines(h5md_reread);
+    ASSERT_EQ(lines.size(), 41);
+    ASSERT_THAT(lines[1], Eq("2"));
+    delete_file(h5md_file);
+    delete_file(text_reread);
+    delete_file(h5md_reread);
+}
+
+TEST_F(DumpH5MDTest, deflate_chunk_run2)
+{
+    auto h5md_file   = "dump_deflate_chunk_run2.h5";
+    auto text_reread = "dump_h5md_deflate_text_reread.melt";
+    auto h5md_reread = "dump_h5md_deflate_h5md_reread.melt";
+
+    generate_and_reread(h5md_file, "deflate 6 chunk 7", "x y z", text_reread, h5md_reread);
+
+    ASSERT_FILE_EXISTS(h5md_file);
+    ASSERT_FILE_EQUAL(text_reread, h5md_reread);
+    delete_file(h5md_file);
+    delete_file(text_reread);
+    delete_file(h5md_reread);
+}
+
+TEST_F(DumpH5MDTest, no_sort)
+{
+    TEST_FAILURE(".*Dump h5md/mpiio cannot sort output.*",
+                 command("dump id all h5md/mpiio 1 dump_no_sort.h5 position");
+                 command("dump_modify id sort id");
+                 command("run 0 post no"););
+    delete_file("dump_no_sort.h5");
+}
+
+int main(int argc, char **argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleMock(&argc, argv);
+
+    // handle arguments passed via environment variable
+    if (const char *var = getenv("TEST_ARGS")) {
+        std::vector<std::string> env = utils::split_words(var);
+        for (auto arg : env) {
+            if (arg == "-v") {
+                verbose = true;
+            }
+        }
+    }
+
+    if ((argc > 1) && (strcmp(argv[1], "-v") == 0)) verbose = true;
+
+    int rv = RUN_ALL_TESTS();
+    MPI_Finalize();
+    return rv;
+}
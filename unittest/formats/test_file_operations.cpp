@@ -382,6 +382,16 @@ TEST_F(FileOperationsTest, write_restart)
     ASSERT_EQ(lmp->update->ntimestep, 333);
     ASSERT_EQ(lmp->domain->triclinic, 1);
 
+    if (info->has_package("MPIIO")) {
+        BEGIN_HIDE_OUTPUT();
+        command("clear");
+        command("read_restart test.restart.mpiio");
+        END_HIDE_OUTPUT();
+        ASSERT_EQ(lmp->atom->natoms, 1);
+        ASSERT_EQ(lmp->atom->nlocal, 1);
+        ASSERT_EQ(lmp->domain->triclinic, 0);
+    }
+
     // clean up
     delete_file("noinit.restart");
     delete_file("test.restart");
@@ -485,6 +495,42 @@ TEST_F(FileOperationsTest, write_data)
     delete_file("triclinic.data");
 }
 
+TEST_F(FileOperationsTest, write_data_binary)
+{
+    BEGIN_HIDE_OUTPUT();
+    command("region box prism -2 2 -2 2 -2 2 0.5 0.0 0.0");
+    command("create_box 2 box");
+    command("create_atoms 1 single 0.5 0.0 0.0");
+    command("create_atoms 2 single -1.5 1.0 1.5");
+    command("pair_style zero 1.0");
+    command("pair_coeff * *");
+    command("mass 1 1.0");
+    command("mass 2 2.0");
+    command("velocity all set 0.1 0.2 0.3");
+    command("write_data test.bdata binary");
+    command("clear");
+    command("pair_style zero 1.0");
+    command("read_data test.bdata");
+    END_HIDE_OUTPUT();
+    ASSERT_EQ(lmp->atom->natoms, 2);
+    ASSERT_EQ(lmp->atom->ntypes, 2);
+    ASSERT_EQ(lmp->domain->triclinic, 1);
+    ASSERT_DOUBLE_EQ(lmp->domain->xy, 0.5);
+    ASSERT_DOUBLE_EQ(lmp->atom->mass[2], 2.0);
+
+    int i = (lmp->atom->tag[0] == 2) ? 0 : 1;
+    ASSERT_EQ(lmp->atom->type[i], 2);
+    ASSERT_DOUBLE_EQ(lmp->atom->x[i][0], -1.5);
+    ASSERT_DOUBLE_EQ(lmp->atom->x[i][1], 1.0);
+    ASSERT_DOUBLE_EQ(lmp->atom->x[i][2], 1.5);
+    ASSERT_DOUBLE_EQ(lmp->atom->v[i][2], 0.3);
+
+    TEST_FAILURE(".*ERROR: Read_data add, offset, shift, or fix keyword cannot "
+                 "be used with a binary data file.*",
+                 command("read_data test.bdata add append"););
+    delete_file("test.bdata");
+}
+
 int main(int argc, char **argv)
 {
     MPI_Init(&argc, &argv);